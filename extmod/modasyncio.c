@@ -28,6 +28,7 @@
 #include "py/smallint.h"
 #include "py/pairheap.h"
 #include "py/mphal.h"
+#include "py/gc.h"
 
 #if MICROPY_PY_ASYNCIO
 
@@ -113,6 +114,8 @@ static mp_obj_t task_queue_push(size_t n_args, const mp_obj_t *args) {
         task->ph_key = args[2];
     }
     self->heap = (mp_obj_task_t *)mp_pairheap_push(task_lt, TASK_PAIRHEAP(self->heap), TASK_PAIRHEAP(task));
+    GC_WRITE_BARRIER(self);
+    GC_WRITE_BARRIER(task);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(task_queue_push_obj, 2, 3, task_queue_push);
@@ -124,6 +127,7 @@ static mp_obj_t task_queue_pop(mp_obj_t self_in) {
         mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("empty heap"));
     }
     self->heap = (mp_obj_task_t *)mp_pairheap_pop(task_lt, &self->heap->pairheap);
+    GC_WRITE_BARRIER(self);
     return MP_OBJ_FROM_PTR(head);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(task_queue_pop_obj, task_queue_pop);
@@ -132,6 +136,7 @@ static mp_obj_t task_queue_remove(mp_obj_t self_in, mp_obj_t task_in) {
     mp_obj_task_queue_t *self = MP_OBJ_TO_PTR(self_in);
     mp_obj_task_t *task = MP_OBJ_TO_PTR(task_in);
     self->heap = (mp_obj_task_t *)mp_pairheap_delete(task_lt, &self->heap->pairheap, &task->pairheap);
+    GC_WRITE_BARRIER(self);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(task_queue_remove_obj, task_queue_remove);
@@ -252,6 +257,7 @@ static void task_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
             self->state = dest[1];
             dest[0] = MP_OBJ_NULL;
         }
+        GC_WRITE_BARRIER(self);
     }
 }
 
@@ -264,6 +270,7 @@ static mp_obj_t task_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
     } else if (self->state == TASK_STATE_RUNNING_NOT_WAITED_ON) {
         // Allocate the waiting queue.
         self->state = task_queue_make_new(&task_queue_type, 0, 0, NULL);
+        GC_WRITE_BARRIER(self);
     } else if (mp_obj_get_type(self->state) != &task_queue_type) {
         // Task has state used for another purpose, so can't also wait on it.
         mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("can't wait"));
@@ -283,6 +290,7 @@ static mp_obj_t task_iternext(mp_obj_t self_in) {
         task_queue_push(2, args);
         // Set calling task's data to this task that it waits on, to double-link it.
         ((mp_obj_task_t *)MP_OBJ_TO_PTR(cur_task))->data = self_in;
+        GC_WRITE_BARRIER(MP_OBJ_TO_PTR(cur_task));
     }
     return mp_const_none;
 }
@@ -31,12 +31,16 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "py/objtype.h"
 #include "py/runtime.h"
 #include "py/stream.h"
 #include "py/mperrno.h"
 
 #if MICROPY_PY_DEFLATE
 
+#define UZLIB_CONF_LZ77_LEVELS (MICROPY_PY_DEFLATE_COMPRESS_LEVEL)
+#define UZLIB_CONF_FAST_CHECKSUM (MICROPY_PY_DEFLATE_FAST_CHECKSUM)
+#define UZLIB_CONF_FAST_INFLATE (MICROPY_PY_DEFLATE_FAST_INFLATE)
 #include "lib/uzlib/uzlib.h"
 
 #if 0 // print debugging info
@@ -58,10 +62,17 @@ typedef enum {
 // to the smallest window size (faster compression, less RAM usage, etc).
 const int DEFLATEIO_DEFAULT_WBITS = 8;
 
+// Size of the blocks read from a seekable source stream when decompressing.
+#define DEFLATEIO_SOURCE_BUF_SIZE (256)
+
 typedef struct {
     void *window;
     uzlib_uncomp_t decomp;
     bool eof;
+    #if MICROPY_PY_DEFLATE_FAST_INFLATE
+    // Read-ahead buffer for decomp.source, or NULL to read a byte at a time.
+    uint8_t *source_buf;
+    #endif
 } mp_obj_deflateio_read_t;
 
 #if MICROPY_PY_DEFLATE_COMPRESS
@@ -79,6 +90,9 @@ typedef struct {
     uint8_t format : 2;
     uint8_t window_bits : 4;
     bool close : 1;
+    #if MICROPY_PY_DEFLATE_COMPRESS_LEVEL
+    uint8_t level : 4;
+    #endif
     mp_obj_deflateio_read_t *read;
     #if MICROPY_PY_DEFLATE_COMPRESS
     mp_obj_deflateio_write_t *write;
@@ -90,22 +104,49 @@ static int deflateio_read_stream(void *data) {
     const mp_stream_p_t *stream = mp_get_stream(self->stream);
     int err;
     byte c;
-    mp_uint_t out_sz = stream->read(self->stream, &c, 1, &err);
+    byte *buf = &c;
+    mp_uint_t len = 1;
+    #if MICROPY_PY_DEFLATE_FAST_INFLATE
+    if (self->read->source_buf != NULL) {
+        buf = self->read->source_buf;
+        len = DEFLATEIO_SOURCE_BUF_SIZE;
+    }
+    #endif
+    mp_uint_t out_sz = stream->read(self->stream, buf, len, &err);
     if (out_sz == MP_STREAM_ERROR) {
         mp_raise_OSError(err);
     }
     if (out_sz == 0) {
         mp_raise_type(&mp_type_EOFError);
     }
-    return c;
+    #if MICROPY_PY_DEFLATE_FAST_INFLATE
+    if (buf != &c) {
+        // uzlib takes the rest of the block directly from the buffer.
+        self->read->decomp.source = buf + 1;
+        self->read->decomp.source_limit = buf + out_sz;
+    }
+    #endif
+    return buf[0];
 }
 
+#if MICROPY_PY_DEFLATE_FAST_INFLATE
+// Seek the source stream back over bytes that were read ahead but not used,
+// so it is left where it would be if it was read a byte at a time.
+static bool deflateio_unread_stream(mp_obj_deflateio_t *self, int *errcode) {
+    uzlib_uncomp_t *decomp = &self->read->decomp;
+    uzlib_uncompress_unget(decomp);
+    mp_off_t unused = decomp->source_limit - decomp->source;
+    decomp->source = decomp->source_limit;
+    return unused == 0 || mp_stream_seek(self->stream, -unused, MP_SEEK_CUR, errcode) != (mp_off_t)-1;
+}
+#endif
+
 static bool deflateio_init_read(mp_obj_deflateio_t *self) {
     if (self->read) {
         return true;
     }
 
-    mp_get_stream_raise(self->stream, MP_STREAM_OP_READ);
+    const mp_stream_p_t *stream = mp_get_stream_raise(self->stream, MP_STREAM_OP_READ);
 
     self->read = m_new_obj(mp_obj_deflateio_read_t);
     memset(&self->read->decomp, 0, sizeof(self->read->decomp));
@@ -113,6 +154,19 @@ static bool deflateio_init_read(mp_obj_deflateio_t *self) {
     self->read->decomp.source_read_cb = deflateio_read_stream;
     self->read->eof = false;
 
+    #if MICROPY_PY_DEFLATE_FAST_INFLATE
+    // Read ahead in blocks only from native streams that can seek back over
+    // the unused bytes, see deflateio_unread_stream().
+    self->read->source_buf = NULL;
+    int err;
+    if (mp_obj_is_native_type(mp_obj_get_type(self->stream)) && stream->ioctl != NULL
+        && mp_stream_seek(self->stream, 0, MP_SEEK_CUR, &err) != (mp_off_t)-1) {
+        self->read->source_buf = m_new(uint8_t, DEFLATEIO_SOURCE_BUF_SIZE);
+    }
+    #else
+    (void)stream;
+    #endif
+
     // Don't modify self->window_bits as it may also be used for write.
     int wbits = self->window_bits;
 
@@ -180,6 +234,12 @@ static bool deflateio_init_write(mp_obj_deflateio_t *self) {
     self->write->window = m_new(uint8_t, window_len);
 
     uzlib_lz77_init(&self->write->lz77, self->write->window, window_len);
+    #if MICROPY_PY_DEFLATE_COMPRESS_LEVEL
+    if (self->level != 0) {
+        void *level_mem = m_new(uint8_t, uzlib_lz77_level_mem_size(window_len));
+        uzlib_lz77_init_level(&self->write->lz77, self->level, level_mem);
+    }
+    #endif
     self->write->lz77.dest_write_data = self;
     self->write->lz77.dest_write_cb = deflateio_out_byte;
 
@@ -215,8 +275,8 @@ static bool deflateio_init_write(mp_obj_deflateio_t *self) {
 #endif
 
 static mp_obj_t deflateio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args_in) {
-    // args: stream, format=NONE, wbits=0, close=False
-    mp_arg_check_num(n_args, n_kw, 1, 4, false);
+    // args: stream, format=NONE, wbits=0, close=False, level=0
+    mp_arg_check_num(n_args, n_kw, 1, 5, false);
 
     mp_int_t format = n_args > 1 ? mp_obj_get_int(args_in[1]) : DEFLATEIO_FORMAT_AUTO;
     mp_int_t wbits = n_args > 2 ? mp_obj_get_int(args_in[2]) : 0;
@@ -227,6 +287,14 @@ static mp_obj_t deflateio_make_new(const mp_obj_type_t *type, size_t n_args, siz
     if (wbits != 0 && (wbits < 5 || wbits > 15)) {
         mp_raise_ValueError(MP_ERROR_TEXT("wbits"));
     }
+    mp_int_t level = n_args > 4 ? mp_obj_get_int(args_in[4]) : 0;
+    #if MICROPY_PY_DEFLATE_COMPRESS_LEVEL
+    if (level < 0 || level > UZLIB_LZ77_LEVEL_MAX) {
+    #else
+    if (level != 0) {
+    #endif
+        mp_raise_ValueError(MP_ERROR_TEXT("level"));
+    }
 
     mp_obj_deflateio_t *self = mp_obj_malloc(mp_obj_deflateio_t, type);
     self->stream = args_in[0];
@@ -237,6 +305,9 @@ static mp_obj_t deflateio_make_new(const mp_obj_type_t *type, size_t n_args, siz
     self->write = NULL;
     #endif
     self->close = n_args > 3 ? mp_obj_is_true(args_in[3]) : false;
+    #if MICROPY_PY_DEFLATE_COMPRESS_LEVEL
+    self->level = level;
+    #endif
 
     return MP_OBJ_FROM_PTR(self);
 }
@@ -256,6 +327,11 @@ static mp_uint_t deflateio_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *e
     self->read->decomp.dest = buf;
     self->read->decomp.dest_limit = (uint8_t *)buf + size;
     int st = uzlib_uncompress_chksum(&self->read->decomp);
+    #if MICROPY_PY_DEFLATE_FAST_INFLATE
+    if (self->read->source_buf != NULL && !deflateio_unread_stream(self, errcode)) {
+        return MP_STREAM_ERROR;
+    }
+    #endif
     if (st == UZLIB_DONE) {
         self->read->eof = true;
     }
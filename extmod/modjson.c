@@ -27,7 +27,6 @@
 #include <stdio.h>
 
 #include "py/objlist.h"
-#include "py/objstringio.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
 #include "py/stream.h"
@@ -127,27 +126,49 @@ typedef struct _json_stream_t {
     mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
     int errcode;
     byte cur;
+    // Input not yet consumed, either the rest of the buffer passed to loads or
+    // the rest of the last chunk read from the stream.
+    const byte *buf_cur;
+    const byte *buf_end;
+    byte *buf; // chunk buffer for streams, NULL when parsing a buffer
 } json_stream_t;
 
 #define S_EOF (0) // null is not allowed in json stream so is ok as EOF marker
 #define S_END(s) ((s).cur == S_EOF)
 #define S_CUR(s) ((s).cur)
-#define S_NEXT(s) (json_stream_next(&(s)))
+#define S_NEXT(s) ((s).buf_cur < (s).buf_end ? ((s).cur = *(s).buf_cur++) : json_stream_next(&(s)))
 
 static byte json_stream_next(json_stream_t *s) {
-    mp_uint_t ret = s->read(s->stream_obj, &s->cur, 1, &s->errcode);
-    if (s->errcode != 0) {
-        mp_raise_OSError(s->errcode);
-    }
-    if (ret == 0) {
-        s->cur = S_EOF;
+    s->cur = S_EOF;
+    if (s->buf != NULL) {
+        mp_uint_t ret = s->read(s->stream_obj, s->buf, MICROPY_PY_JSON_LOAD_CHUNK_SIZE, &s->errcode);
+        if (s->errcode != 0) {
+            mp_raise_OSError(s->errcode);
+        }
+        if (ret != 0) {
+            s->cur = s->buf[0];
+            s->buf_cur = s->buf + 1;
+            s->buf_end = s->buf + ret;
+        }
     }
     return s->cur;
 }
 
-static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
-    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
-    json_stream_t s = {stream_obj, stream_p->read, 0, 0};
+// Adds the current character of a string to vstr, along with any following
+// characters in the buffer up to the next quote, escape or EOF marker.
+static void json_stream_add_str_run(json_stream_t *s, vstr_t *vstr) {
+    const byte *start = s->buf_cur;
+    const byte *p = start;
+    while (p < s->buf_end && *p != '"' && *p != '\\' && *p != S_EOF) {
+        ++p;
+    }
+    vstr_add_byte(vstr, s->cur);
+    vstr_add_strn(vstr, (const char *)start, p - start);
+    s->buf_cur = p;
+    S_NEXT(*s);
+}
+
+static mp_obj_t json_load(json_stream_t s) {
     vstr_t vstr;
     vstr_init(&vstr, 8);
     mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
@@ -233,6 +254,9 @@ static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
                                 goto str_cont;
                             }
                         }
+                    } else {
+                        json_stream_add_str_run(&s, &vstr);
+                        continue;
                     }
                     vstr_add_byte(&vstr, c);
                 str_cont:
@@ -355,14 +379,23 @@ success:
 fail:
     mp_raise_ValueError(MP_ERROR_TEXT("syntax error in JSON"));
 }
+
+static mp_obj_t mod_json_load(mp_obj_t stream_obj) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
+    byte *buf = m_new(byte, MICROPY_PY_JSON_LOAD_CHUNK_SIZE);
+    json_stream_t s = {stream_obj, stream_p->read, 0, 0, NULL, NULL, buf};
+    mp_obj_t obj = json_load(s);
+    m_del(byte, buf, MICROPY_PY_JSON_LOAD_CHUNK_SIZE);
+    return obj;
+}
 static MP_DEFINE_CONST_FUN_OBJ_1(mod_json_load_obj, mod_json_load);
 
 static mp_obj_t mod_json_loads(mp_obj_t obj) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(obj, &bufinfo, MP_BUFFER_READ);
-    vstr_t vstr = {bufinfo.len, bufinfo.len, (char *)bufinfo.buf, true};
-    mp_obj_stringio_t sio = {{&mp_type_stringio}, &vstr, 0, MP_OBJ_NULL};
-    return mod_json_load(MP_OBJ_FROM_PTR(&sio));
+    // parse straight from the buffer, without going through a stream
+    json_stream_t s = {MP_OBJ_NULL, NULL, 0, 0, bufinfo.buf, (const byte *)bufinfo.buf + bufinfo.len, NULL};
+    return json_load(s);
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(mod_json_loads_obj, mod_json_loads);
 
@@ -47,6 +47,10 @@
 
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if MICROPY_PY_RE_PIKEVM
+    bool pikevm;
+    int16_t first_char; // -1 if the pattern doesn't start with a literal
+    #endif
     ByteProg re;
 } mp_obj_re_t;
 
@@ -194,6 +198,41 @@ static void re_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t
     mp_printf(print, "<re %p>", self);
 }
 
+// Run the compiled pattern on subj, selecting the engine for the pattern.
+static int re_exec_subject(mp_obj_re_t *self, const Subject *subj, const char **caps, int caps_num, bool is_anchored) {
+    #if MICROPY_PY_RE_PIKEVM
+    Subject s = *subj;
+    if (!is_anchored && self->first_char >= 0) {
+        // A match can only start at an occurrence of the first character
+        s.begin = memchr(s.begin, self->first_char, s.end - s.begin);
+        if (s.begin == NULL) {
+            return 0;
+        }
+        if (!self->pikevm) {
+            for (;;) {
+                if (re1_5_recursiveloopprog(&self->re, &s, caps, caps_num, true)) {
+                    return 1;
+                }
+                s.begin = memchr(s.begin + 1, self->first_char, s.end - s.begin - 1);
+                if (s.begin == NULL) {
+                    return 0;
+                }
+            }
+        }
+    }
+    if (self->pikevm) {
+        size_t mem_size = re1_5_pikevm_memsize(&self->re, caps_num);
+        char *mem = m_new(char, mem_size);
+        int res = re1_5_pikevm(&self->re, &s, caps, caps_num, is_anchored, mem);
+        m_del(char, mem, mem_size);
+        return res;
+    }
+    return re1_5_recursiveloopprog(&self->re, &s, caps, caps_num, is_anchored);
+    #else
+    return re1_5_recursiveloopprog(&self->re, (Subject *)subj, caps, caps_num, is_anchored);
+    #endif
+}
+
 static mp_obj_t re_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     (void)n_args;
     mp_obj_re_t *self;
@@ -210,7 +249,7 @@ static mp_obj_t re_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, caps, char *, caps_num);
     // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
     memset((char *)match->caps, 0, caps_num * sizeof(char *));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
+    int res = re_exec_subject(self, &subj, match->caps, caps_num, is_anchored);
     if (res == 0) {
         m_del_var(mp_obj_match_t, caps, char *, caps_num, match);
         return mp_const_none;
@@ -251,7 +290,7 @@ static mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     while (true) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char **)caps, 0, caps_num * sizeof(char *));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = re_exec_subject(self, &subj, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
@@ -311,7 +350,7 @@ static mp_obj_t re_sub_helper(size_t n_args, const mp_obj_t *args) {
     for (;;) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char *)match->caps, 0, caps_num * sizeof(char *));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, false);
+        int res = re_exec_subject(self, &subj, match->caps, caps_num, false);
 
         // If we didn't have a match, or had an empty match, it's time to stop
         if (!res || match->caps[0] == match->caps[1]) {
@@ -440,6 +479,17 @@ static mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args) {
     error:
         mp_raise_ValueError(MP_ERROR_TEXT("error in regex"));
     }
+    #if MICROPY_PY_RE_PIKEVM
+    o->pikevm = re1_5_is_ambiguous(&o->re);
+    o->first_char = -1;
+    const char *pc = o->re.insts + NON_ANCHORED_PREFIX;
+    while (*pc == Save) {
+        pc += 2;
+    }
+    if (*pc == Char) {
+        o->first_char = (unsigned char)pc[1];
+    }
+    #endif
     #if MICROPY_PY_RE_DEBUG
     if (flags & FLAG_DEBUG) {
         re1_5_dumpcode(&o->re);
@@ -481,6 +531,9 @@ MP_REGISTER_EXTENSIBLE_MODULE(MP_QSTR_re, mp_module_re);
 #include "lib/re1.5/compilecode.c"
 #include "lib/re1.5/recursiveloop.c"
 #include "lib/re1.5/charclass.c"
+#if MICROPY_PY_RE_PIKEVM
+#include "lib/re1.5/pike.c"
+#endif
 
 #if MICROPY_PY_RE_DEBUG
 // Make sure the output print statements go to the same output as other Python output.
@@ -229,6 +229,64 @@ int re1_5_compilecode(ByteProg *prog, const char *re)
     return 0;
 }
 
+static int _inst_size(const char *pc)
+{
+    switch (*pc) {
+    case Class:
+    case ClassNot:
+        return 2 + *(unsigned char*)(pc + 1) * 2;
+    case Any:
+    case Bol:
+    case Eol:
+    case Match:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+// Check the loop body in code [pc, end) for an alternative (or optional
+// part), or for having no consumer so that it only matches empty.
+static bool _loop_is_ambiguous(const char *pc, const char *end)
+{
+    bool consumes = false;
+    for (; pc < end; pc += _inst_size(pc)) {
+        if (*pc == Split || *pc == RSplit) {
+            return true;
+        }
+        consumes |= inst_is_consumer(*pc);
+    }
+    return !consumes;
+}
+
+// Returns non-zero if the program has a loop which can match the same text
+// in more than one way, like "(a*)*" or "(a|ab)+", or which can match empty,
+// like "()*".  Backtracking over such loops can take exponential time (or
+// recurse without bound), so these are better run with re1_5_pikevm().
+int re1_5_is_ambiguous(ByteProg *prog)
+{
+    const char *code = prog->insts;
+    const char *pc = code + NON_ANCHORED_PREFIX;
+    const char *end = code + prog->bytelen;
+    for (; pc < end; pc += _inst_size(pc)) {
+        if (*pc == Jmp || *pc == Split || *pc == RSplit) {
+            const char *target = pc + 2 + (signed char)pc[1];
+            if (target > pc) {
+                continue;
+            }
+            if (*pc == Jmp) {
+                // "x*" is: split L2; L1: x; jmp L1 - 2; L2:
+                target += 2;
+            }
+            // "x+" is: L1: x; rsplit L1
+            if (_loop_is_ambiguous(target, pc)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
 #if 0
 int main(int argc, char *argv[])
 {
@@ -0,0 +1,182 @@
+// Copyright 2007-2009 Russ Cox.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Pike VM: runs all threads of the program in lock step over the subject,
+// so time is linear in the subject length and memory depends only on the
+// program.  Threads are kept in priority order, which gives the same
+// leftmost, greedy/non-greedy results as the backtracking engines.
+//
+// Each thread is a pc followed by nsubp capture pointers.  Adding a thread
+// follows Jmp, Split, RSplit, Save, Bol and Eol with an explicit stack, and
+// each instruction is visited at most once per subject position, so a list
+// and the stack each hold at most prog->len entries.
+
+typedef struct {
+	const char *pc;
+	int slot;	// >= 0 to restore cap[slot] = old, instead of running pc
+	const char *old;
+} Frame;
+
+typedef struct {
+	int n;
+	const char **t;
+} ThreadList;
+
+typedef struct {
+	Subject *input;
+	char *insts;
+	unsigned int *mark;
+	unsigned int gen;
+	int nsubp;
+	const char **cap;
+	Frame *stack;
+} Pike;
+
+static void
+addthread(Pike *p, ThreadList *l, const char *pc0, const char *sp, const char **cap0)
+{
+	int nstack = 0, off;
+	const char *pc;
+
+	memcpy(p->cap, cap0, p->nsubp * sizeof(*p->cap));
+	p->stack[nstack].pc = pc0;
+	p->stack[nstack++].slot = -1;
+	while(nstack > 0) {
+		Frame *f = &p->stack[--nstack];
+		if(f->slot >= 0) {
+			p->cap[f->slot] = f->old;
+			continue;
+		}
+		pc = f->pc;
+		for(;;) {
+			if(p->mark[pc - p->insts] == p->gen)
+				break;
+			p->mark[pc - p->insts] = p->gen;
+			switch(*pc) {
+			case Jmp:
+				pc += 2 + (signed char)pc[1];
+				continue;
+			case Split:
+				p->stack[nstack].pc = pc + 2 + (signed char)pc[1];
+				p->stack[nstack++].slot = -1;
+				pc += 2;
+				continue;
+			case RSplit:
+				p->stack[nstack].pc = pc + 2;
+				p->stack[nstack++].slot = -1;
+				pc += 2 + (signed char)pc[1];
+				continue;
+			case Save:
+				off = (unsigned char)pc[1];
+				if(off < p->nsubp) {
+					p->stack[nstack].slot = off;
+					p->stack[nstack++].old = p->cap[off];
+					p->cap[off] = sp;
+				}
+				pc += 2;
+				continue;
+			case Bol:
+				if(sp != p->input->begin_line)
+					break;
+				pc++;
+				continue;
+			case Eol:
+				if(sp != p->input->end)
+					break;
+				pc++;
+				continue;
+			default: {
+				// Consumer or Match: the thread waits here for the next step
+				const char **t = l->t + l->n++ * (p->nsubp + 1);
+				t[0] = pc;
+				memcpy(t + 1, p->cap, p->nsubp * sizeof(*p->cap));
+				break;
+			}
+			}
+			break;
+		}
+	}
+}
+
+int
+re1_5_pikevm_memsize(ByteProg *prog, int nsubp)
+{
+	// Two thread lists, the addthread stack, the current captures and marks
+	return (2 * prog->len * (nsubp + 1) + nsubp) * sizeof(const char *)
+		+ (prog->len + 1) * sizeof(Frame)
+		+ prog->bytelen * sizeof(unsigned int);
+}
+
+int
+re1_5_pikevm(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored, void *mem)
+{
+	Pike p;
+	ThreadList lists[2], *clist = &lists[0], *nlist = &lists[1], *tmp;
+	const char *sp, *pc, **t;
+	int i, stride = nsubp + 1, matched = 0;
+
+	p.input = input;
+	p.insts = prog->insts;
+	p.nsubp = nsubp;
+	lists[0].t = mem;
+	lists[1].t = lists[0].t + prog->len * stride;
+	p.cap = lists[1].t + prog->len * stride;
+	p.stack = (Frame*)(p.cap + nsubp);
+	p.mark = (unsigned int*)(p.stack + prog->len + 1);
+	memset(p.mark, 0, prog->bytelen * sizeof(unsigned int));
+	p.gen = 1;
+
+	clist->n = 0;
+	nlist->n = 0;
+	addthread(&p, clist, HANDLE_ANCHORED(prog->insts, is_anchored), input->begin, subp);
+
+	for(sp = input->begin; clist->n > 0; sp++) {
+		p.gen++;
+		for(i = 0; i < clist->n; i++) {
+			t = clist->t + i * stride;
+			pc = t[0];
+			if(inst_is_consumer(*pc) && sp >= input->end)
+				continue;
+			switch(*pc) {
+			case Char:
+				if(*sp != pc[1])
+					continue;
+				pc += 2;
+				break;
+			case Any:
+				pc++;
+				break;
+			case Class:
+			case ClassNot:
+				if(!_re1_5_classmatch(pc + 1, sp))
+					continue;
+				pc += *(unsigned char*)(pc + 1) * 2 + 2;
+				break;
+			case NamedClass:
+				if(!_re1_5_namedclassmatch(pc + 1, sp))
+					continue;
+				pc += 2;
+				break;
+			case Match:
+				// Lower priority threads can't give a preferred match
+				memcpy(subp, t + 1, nsubp * sizeof(*subp));
+				matched = 1;
+				goto cut;
+			default:
+				re1_5_fatal("pikevm");
+			}
+			addthread(&p, nlist, pc, sp + 1, t + 1);
+		}
+	cut:
+		tmp = clist;
+		clist = nlist;
+		nlist = tmp;
+		nlist->n = 0;
+		if(sp >= input->end)
+			break;
+	}
+	return matched;
+}
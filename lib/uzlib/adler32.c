@@ -41,6 +41,47 @@
 #define A32_BASE 65521
 #define A32_NMAX 5552
 
+#if UZLIB_CONF_FAST_CHECKSUM && defined(__SSSE3__)
+#include <tmmintrin.h>
+
+/* Add n blocks of 32 bytes to the sums, 16 bytes at a time with SSSE3.
+   Over a block s2 grows by 32 * s1 plus the bytes weighted by their
+   distance from the end of the block, which is a multiply-add. */
+static void uzlib_adler32_ssse3(const unsigned char *buf, unsigned int n, unsigned int *s1, unsigned int *s2)
+{
+   const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+   const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i ones = _mm_set1_epi16(1);
+   __m128i v_ps = _mm_cvtsi32_si128(*s1 * n);
+   __m128i v_s2 = _mm_cvtsi32_si128(*s2);
+   __m128i v_s1 = zero;
+
+   do
+   {
+      const __m128i bytes1 = _mm_loadu_si128((const __m128i *)buf);
+      const __m128i bytes2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+      /* v_ps accumulates the value of s1 at the start of each block. */
+      v_ps = _mm_add_epi32(v_ps, v_s1);
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+      buf += 32;
+   } while (--n);
+
+   v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+   /* Sum the 4 lanes of each. */
+   v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+   v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+   v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+   v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+   *s1 += _mm_cvtsi128_si32(v_s1);
+   *s2 = _mm_cvtsi128_si32(v_s2);
+}
+#endif
+
 uint32_t uzlib_adler32(const void *data, unsigned int length, uint32_t prev_sum /* 1 */)
 {
    const unsigned char *buf = (const unsigned char *)data;
@@ -51,9 +92,19 @@ uint32_t uzlib_adler32(const void *data, unsigned int length, uint32_t prev_sum
    while (length > 0)
    {
       int k = length < A32_NMAX ? length : A32_NMAX;
+      int rem = k;
       int i;
 
-      for (i = k / 16; i; --i, buf += 16)
+#if UZLIB_CONF_FAST_CHECKSUM && defined(__SSSE3__)
+      if (rem >= 32)
+      {
+         uzlib_adler32_ssse3(buf, rem / 32, &s1, &s2);
+         buf += rem & ~31;
+         rem %= 32;
+      }
+#endif
+
+      for (i = rem / 16; i; --i, buf += 16)
       {
          s1 += buf[0];  s2 += s1; s1 += buf[1];  s2 += s1;
          s1 += buf[2];  s2 += s1; s1 += buf[3];  s2 += s1;
@@ -66,7 +117,7 @@ uint32_t uzlib_adler32(const void *data, unsigned int length, uint32_t prev_sum
          s1 += buf[14]; s2 += s1; s1 += buf[15]; s2 += s1;
       }
 
-      for (i = k % 16; i; --i) { s1 += *buf++; s2 += s1; }
+      for (i = rem % 16; i; --i) { s1 += *buf++; s2 += s1; }
 
       s1 %= A32_BASE;
       s2 %= A32_BASE;
@@ -38,6 +38,183 @@
 
 #include "uzlib.h"
 
+#if UZLIB_CONF_FAST_CHECKSUM
+
+#if defined(__ARM_FEATURE_CRC32)
+/* ARMv8 CRC32 instructions use the same polynomial as zlib. */
+#include <arm_acle.h>
+#define UZLIB_CRC32_ARM (1)
+#elif defined(__PCLMUL__) && defined(__SSE4_1__)
+/* x86 carry-less multiply, folding 64 bytes at a time. */
+#include <wmmintrin.h>
+#include <smmintrin.h>
+#define UZLIB_CRC32_PCLMUL (1)
+#endif
+
+#ifndef UZLIB_CRC32_ARM
+#define UZLIB_CRC32_ARM (0)
+#endif
+#ifndef UZLIB_CRC32_PCLMUL
+#define UZLIB_CRC32_PCLMUL (0)
+#endif
+
+#if UZLIB_CRC32_ARM
+#include <string.h>
+#else
+#include "crc32_tab8.h"
+#endif
+
+#if UZLIB_CRC32_PCLMUL
+/*
+ * CRC32 using PCLMULQDQ, following Intel's "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ Instruction".  length must be at least 64 and
+ * a multiple of 16.
+ */
+static uint32_t uzlib_crc32_pclmul(const unsigned char *buf, unsigned int length, uint32_t crc)
+{
+   /* Bit-reflected fold constants, and the polynomial and its Barrett constant. */
+   static const uint64_t k1k2[2] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+   static const uint64_t k3k4[2] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+   static const uint64_t k5k0[2] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+   static const uint64_t poly[2] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+   __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+   x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+   x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+   x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+   x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+   x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+   x0 = _mm_load_si128((const __m128i *)k1k2);
+   buf += 64;
+   length -= 64;
+
+   /* Fold 4 x 128 bits in parallel. */
+   while (length >= 64)
+   {
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+      x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+      x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+      x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+      x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(buf + 0x00)));
+      x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+      x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+      x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+      buf += 64;
+      length -= 64;
+   }
+
+   /* Fold into 128 bits. */
+   x0 = _mm_load_si128((const __m128i *)k3k4);
+   x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+   x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+   x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+   x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+   x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+   x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+   /* Fold any remaining 16 byte blocks. */
+   while (length >= 16)
+   {
+      x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+      x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+      x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)buf)), x5);
+      buf += 16;
+      length -= 16;
+   }
+
+   /* Fold 128 bits to 64 bits. */
+   x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+   x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+   x1 = _mm_srli_si128(x1, 8);
+   x1 = _mm_xor_si128(x1, x2);
+   x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+   x2 = _mm_srli_si128(x1, 4);
+   x1 = _mm_and_si128(x1, x3);
+   x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+   x1 = _mm_xor_si128(x1, x2);
+
+   /* Barrett reduce to 32 bits. */
+   x0 = _mm_load_si128((const __m128i *)poly);
+   x2 = _mm_and_si128(x1, x3);
+   x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+   x2 = _mm_and_si128(x2, x3);
+   x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+   x1 = _mm_xor_si128(x1, x2);
+
+   return _mm_extract_epi32(x1, 1);
+}
+#endif
+
+/* crc is previous value for incremental computation, 0xffffffff initially */
+uint32_t uzlib_crc32(const void *data, unsigned int length, uint32_t crc)
+{
+   const unsigned char *buf = (const unsigned char *)data;
+
+#if UZLIB_CRC32_ARM
+   for (; length && ((uintptr_t)buf & 7); --length)
+   {
+      crc = __crc32b(crc, *buf++);
+   }
+#if defined(__aarch64__)
+   for (; length >= 8; length -= 8, buf += 8)
+   {
+      uint64_t v;
+      memcpy(&v, buf, sizeof(v));
+      crc = __crc32d(crc, v);
+   }
+#else
+   for (; length >= 4; length -= 4, buf += 4)
+   {
+      uint32_t v;
+      memcpy(&v, buf, sizeof(v));
+      crc = __crc32w(crc, v);
+   }
+#endif
+   for (; length; --length)
+   {
+      crc = __crc32b(crc, *buf++);
+   }
+   return crc;
+#else
+
+#if UZLIB_CRC32_PCLMUL
+   if (length >= 64)
+   {
+      unsigned int n = length & ~15u;
+      crc = uzlib_crc32_pclmul(buf, n, crc);
+      buf += n;
+      length -= n;
+   }
+#endif
+
+   /* Slice-by-8: process 8 bytes with 8 independent table lookups. */
+   for (; length >= 8; length -= 8, buf += 8)
+   {
+      uint32_t lo = crc ^ (buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24);
+      crc = tinf_crc32tab8[7][lo & 0xff] ^ tinf_crc32tab8[6][(lo >> 8) & 0xff]
+            ^ tinf_crc32tab8[5][(lo >> 16) & 0xff] ^ tinf_crc32tab8[4][lo >> 24]
+            ^ tinf_crc32tab8[3][buf[4]] ^ tinf_crc32tab8[2][buf[5]]
+            ^ tinf_crc32tab8[1][buf[6]] ^ tinf_crc32tab8[0][buf[7]];
+   }
+   for (; length; --length)
+   {
+      crc = tinf_crc32tab8[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+   }
+
+   // return value suitable for passing in next time, for final value invert it
+   return crc;
+#endif
+}
+
+#else
+
 static const unsigned int tinf_crc32tab[16] = {
    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190,
    0x6b6b51f4, 0x4db26158, 0x5005713c, 0xedb88320, 0xf00f9344,
@@ -61,3 +238,5 @@ uint32_t uzlib_crc32(const void *data, unsigned int length, uint32_t crc)
    // return value suitable for passing in next time, for final value invert it
    return crc/* ^ 0xffffffff*/;
 }
+
+#endif /* UZLIB_CONF_FAST_CHECKSUM */
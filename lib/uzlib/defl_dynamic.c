@@ -0,0 +1,396 @@
+/*
+ * Dynamic Huffman block encoder for the LZ77 compressor.
+ *
+ * The LZ77 stage buffers a block of literal and match symbols, counting how
+ * often each code is used.  When the buffer is full (or the stream ends) the
+ * block is written out either with the fixed Huffman codes or with Huffman
+ * codes built for that block, whichever gives the smaller output.  A block of
+ * only literals may also be stored uncompressed if that is smaller.
+ *
+ * Code lengths are computed with the in-place algorithm of Moffat and
+ * Katajainen, then limited to the maximum length allowed by DEFLATE.
+ *
+ * MIT license.
+ */
+
+#define HUFF_NUM_LIT (286)
+#define HUFF_NUM_DIST (30)
+#define HUFF_NUM_CL (19)
+#define HUFF_MAX_BITS (15)
+#define HUFF_MAX_CL_BITS (7)
+
+typedef struct _uzlib_lz77_huff_t {
+    uint32_t sort[HUFF_NUM_LIT];
+    uint16_t weight[HUFF_NUM_LIT];
+    uint16_t lit_freq[HUFF_NUM_LIT];
+    uint16_t lit_code[HUFF_NUM_LIT];
+    uint16_t dist_freq[HUFF_NUM_DIST];
+    uint16_t dist_code[HUFF_NUM_DIST];
+    uint16_t cl_freq[HUFF_NUM_CL];
+    uint16_t cl_code[HUFF_NUM_CL];
+    uint8_t lit_len[HUFF_NUM_LIT];
+    uint8_t dist_len[HUFF_NUM_DIST];
+    uint8_t cl_len[HUFF_NUM_CL];
+    // Run-length encoded code lengths, and their extra bits.
+    uint8_t cl_sym[HUFF_NUM_LIT + HUFF_NUM_DIST];
+    uint8_t cl_extra[HUFF_NUM_LIT + HUFF_NUM_DIST];
+} uzlib_lz77_huff_t;
+
+static const uint8_t huff_cl_order[HUFF_NUM_CL] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+};
+
+// Length symbol (minus 257) and number of extra bits for a match length of 3-258.
+static int huff_len_sym(int len, int *nextra) {
+    int l = len - 3;
+    if (l < 8) {
+        *nextra = 0;
+        return l;
+    } else if (l == 255) {
+        *nextra = 0;
+        return 28;
+    }
+    int x = int_log2(l);
+    *nextra = x - 2;
+    return 4 * (x - 1) + ((l >> (x - 2)) & 3);
+}
+
+// Distance symbol and number of extra bits for a match distance of 1-32768.
+static int huff_dist_sym(int dist, int *nextra) {
+    int d = dist - 1;
+    if (d < 4) {
+        *nextra = 0;
+        return d;
+    }
+    int x = int_log2(d);
+    *nextra = x - 1;
+    return 2 * x + ((d >> (x - 1)) & 1);
+}
+
+static void huff_sort(uint32_t *a, size_t n) {
+    // Shell sort, the arrays here are small.
+    for (size_t gap = n / 2; gap > 0; gap /= 2) {
+        for (size_t i = gap; i < n; ++i) {
+            uint32_t v = a[i];
+            size_t j = i;
+            for (; j >= gap && a[j - gap] > v; j -= gap) {
+                a[j] = a[j - gap];
+            }
+            a[j] = v;
+        }
+    }
+}
+
+// Replace the n weights in a, sorted in increasing order, with their optimal
+// code lengths (Moffat and Katajainen, "In-place calculation of
+// minimum-redundancy codes").
+static void huff_minimum_redundancy(uint16_t *a, int n) {
+    if (n == 1) {
+        a[0] = 1;
+        return;
+    }
+    a[0] += a[1];
+    int root = 0;
+    int leaf = 2;
+    for (int next = 1; next < n - 1; ++next) {
+        if (leaf >= n || a[root] < a[leaf]) {
+            a[next] = a[root];
+            a[root++] = next;
+        } else {
+            a[next] = a[leaf++];
+        }
+        if (leaf >= n || (root < next && a[root] < a[leaf])) {
+            a[next] += a[root];
+            a[root++] = next;
+        } else {
+            a[next] += a[leaf++];
+        }
+    }
+    a[n - 2] = 0;
+    for (int next = n - 3; next >= 0; --next) {
+        a[next] = a[a[next]] + 1;
+    }
+    int avail = 1;
+    int used = 0;
+    int depth = 0;
+    root = n - 2;
+    int next = n - 1;
+    while (avail > 0) {
+        while (root >= 0 && a[root] == depth) {
+            ++used;
+            --root;
+        }
+        while (avail > used) {
+            a[next--] = depth;
+            --avail;
+        }
+        avail = 2 * used;
+        ++depth;
+        used = 0;
+    }
+}
+
+// Compute the code lengths for n symbols with the given frequencies, limited
+// to max_bits.  At least two symbols are always given a code, as required by
+// some decoders for the distance tree.
+static void huff_build_lengths(uzlib_lz77_huff_t *h, const uint16_t *freq, uint8_t *lens, int n, int max_bits) {
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        lens[i] = 0;
+        if (freq[i] != 0) {
+            h->sort[m++] = (uint32_t)freq[i] << 16 | i;
+        }
+    }
+    for (int i = 0; m < 2; ++i) {
+        if (freq[i] == 0) {
+            h->sort[m++] = 1 << 16 | i;
+        }
+    }
+    huff_sort(h->sort, m);
+    for (int i = 0; i < m; ++i) {
+        h->weight[i] = h->sort[i] >> 16;
+    }
+    huff_minimum_redundancy(h->weight, m);
+
+    // Count the codes of each length, and fold any that are too long back into
+    // the allowed range while keeping the code complete.
+    uint16_t count[32] = { 0 };
+    for (int i = 0; i < m; ++i) {
+        count[h->weight[i] > max_bits ? max_bits : h->weight[i]] += 1;
+    }
+    uint32_t total = 0;
+    for (int i = max_bits; i > 0; --i) {
+        total += (uint32_t)count[i] << (max_bits - i);
+    }
+    while (total != 1u << max_bits) {
+        count[max_bits] -= 1;
+        for (int i = max_bits - 1; i > 0; --i) {
+            if (count[i] != 0) {
+                count[i] -= 1;
+                count[i + 1] += 2;
+                break;
+            }
+        }
+        total -= 1;
+    }
+
+    // The least frequent symbols get the longest codes.
+    int j = 0;
+    for (int i = max_bits; i > 0; --i) {
+        for (int k = count[i]; k > 0; --k) {
+            lens[h->sort[j++] & 0xffff] = i;
+        }
+    }
+}
+
+// Assign canonical codes for the given lengths, bit-reversed for output.
+static void huff_build_codes(const uint8_t *lens, uint16_t *codes, int n) {
+    uint16_t count[HUFF_MAX_BITS + 1] = { 0 };
+    uint16_t next[HUFF_MAX_BITS + 1];
+    for (int i = 0; i < n; ++i) {
+        count[lens[i]] += 1;
+    }
+    count[0] = 0;
+    int code = 0;
+    for (int bits = 1; bits <= HUFF_MAX_BITS; ++bits) {
+        code = (code + count[bits - 1]) << 1;
+        next[bits] = code;
+    }
+    for (int i = 0; i < n; ++i) {
+        int len = lens[i];
+        if (len != 0) {
+            int c = next[len]++;
+            int r = 0;
+            for (int b = 0; b < len; ++b) {
+                r = r << 1 | (c & 1);
+                c >>= 1;
+            }
+            codes[i] = r;
+        }
+    }
+}
+
+// Run-length encode the literal/length and distance code lengths into
+// code length symbols, counting their frequencies.  Returns the number of
+// symbols.
+static int huff_encode_lengths(uzlib_lz77_huff_t *h, int hlit, int hdist) {
+    memset(h->cl_freq, 0, sizeof(h->cl_freq));
+    int n = hlit + hdist;
+    int nsym = 0;
+    for (int i = 0; i < n;) {
+        int len = i < hlit ? h->lit_len[i] : h->dist_len[i - hlit];
+        int run = 1;
+        while (i + run < n && (i + run < hlit ? h->lit_len[i + run] : h->dist_len[i + run - hlit]) == len) {
+            ++run;
+        }
+        i += run;
+        if (len == 0) {
+            while (run >= 11) {
+                int r = run > 138 ? 138 : run;
+                h->cl_sym[nsym] = 18;
+                h->cl_extra[nsym++] = r - 11;
+                run -= r;
+            }
+            if (run >= 3) {
+                h->cl_sym[nsym] = 17;
+                h->cl_extra[nsym++] = run - 3;
+                run = 0;
+            }
+        } else {
+            h->cl_sym[nsym++] = len;
+            --run;
+            while (run >= 3) {
+                int r = run > 6 ? 6 : run;
+                h->cl_sym[nsym] = 16;
+                h->cl_extra[nsym++] = r - 3;
+                run -= r;
+            }
+        }
+        while (run-- > 0) {
+            h->cl_sym[nsym++] = len;
+        }
+    }
+    for (int i = 0; i < nsym; ++i) {
+        h->cl_freq[h->cl_sym[i]] += 1;
+    }
+    return nsym;
+}
+
+static void huff_write_block(uzlib_lz77_state_t *state, bool final) {
+    uzlib_lz77_huff_t *h = state->huff;
+
+    // End-of-block code.
+    h->lit_freq[256] = 1;
+
+    huff_build_lengths(h, h->lit_freq, h->lit_len, HUFF_NUM_LIT, HUFF_MAX_BITS);
+    huff_build_lengths(h, h->dist_freq, h->dist_len, HUFF_NUM_DIST, HUFF_MAX_BITS);
+
+    int hlit = HUFF_NUM_LIT;
+    while (hlit > 257 && h->lit_len[hlit - 1] == 0) {
+        --hlit;
+    }
+    int hdist = HUFF_NUM_DIST;
+    while (hdist > 1 && h->dist_len[hdist - 1] == 0) {
+        --hdist;
+    }
+    int nsym = huff_encode_lengths(h, hlit, hdist);
+    huff_build_lengths(h, h->cl_freq, h->cl_len, HUFF_NUM_CL, HUFF_MAX_CL_BITS);
+    int hclen = HUFF_NUM_CL;
+    while (hclen > 4 && h->cl_len[huff_cl_order[hclen - 1]] == 0) {
+        --hclen;
+    }
+
+    // Compare the size of the block with dynamic and with fixed codes.  Extra
+    // bits are the same for both so are not counted.
+    uint32_t dyn_bits = 5 + 5 + 4 + 3 * hclen;
+    uint32_t fixed_bits = 0;
+    uint32_t num_dist = 0;
+    for (int i = 0; i < HUFF_NUM_CL; ++i) {
+        dyn_bits += h->cl_freq[i] * h->cl_len[i];
+    }
+    for (int i = 0; i < nsym; ++i) {
+        static const uint8_t cl_extra_bits[3] = { 2, 3, 7 };
+        if (h->cl_sym[i] >= 16) {
+            dyn_bits += cl_extra_bits[h->cl_sym[i] - 16];
+        }
+    }
+    for (int i = 0; i < HUFF_NUM_LIT; ++i) {
+        dyn_bits += h->lit_freq[i] * h->lit_len[i];
+        fixed_bits += h->lit_freq[i] * (i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8);
+    }
+    for (int i = 0; i < HUFF_NUM_DIST; ++i) {
+        dyn_bits += h->dist_freq[i] * h->dist_len[i];
+        fixed_bits += h->dist_freq[i] * 5;
+        num_dist += h->dist_freq[i];
+    }
+
+    // A stored block is byte aligned after its 3 header bits.
+    uint32_t stored_bits = ((8 - (state->noutbits + 3)) & 7) + 32 + 8 * state->sym_len;
+    if (num_dist == 0 && stored_bits < fixed_bits && stored_bits < dyn_bits) {
+        // Stored block, the literals are the original data.
+        outbits(state, final, 3);
+        outbits(state, 0, (8 - state->noutbits) & 7);
+        outbits(state, state->sym_len, 16);
+        outbits(state, state->sym_len ^ 0xffff, 16);
+        for (size_t i = 0; i < state->sym_len; ++i) {
+            outbits(state, state->sym_lit[i], 8);
+        }
+    } else if (fixed_bits <= dyn_bits) {
+        // Fixed Huffman block.
+        outbits(state, final | 2, 3);
+        for (size_t i = 0; i < state->sym_len; ++i) {
+            if (state->sym_dist[i] == 0) {
+                uzlib_literal(state, state->sym_lit[i]);
+            } else {
+                uzlib_match(state, state->sym_dist[i], state->sym_lit[i] + 3);
+            }
+        }
+        outbits(state, 0, 7);
+    } else {
+        // Dynamic Huffman block, starting with the code lengths.
+        huff_build_codes(h->lit_len, h->lit_code, HUFF_NUM_LIT);
+        huff_build_codes(h->dist_len, h->dist_code, HUFF_NUM_DIST);
+        huff_build_codes(h->cl_len, h->cl_code, HUFF_NUM_CL);
+        outbits(state, final | 4, 3);
+        outbits(state, hlit - 257, 5);
+        outbits(state, hdist - 1, 5);
+        outbits(state, hclen - 4, 4);
+        for (int i = 0; i < hclen; ++i) {
+            outbits(state, h->cl_len[huff_cl_order[i]], 3);
+        }
+        for (int i = 0; i < nsym; ++i) {
+            int s = h->cl_sym[i];
+            outbits(state, h->cl_code[s], h->cl_len[s]);
+            if (s >= 16) {
+                outbits(state, h->cl_extra[i], s == 16 ? 2 : s == 17 ? 3 : 7);
+            }
+        }
+
+        // The symbols of the block.
+        for (size_t i = 0; i < state->sym_len; ++i) {
+            int dist = state->sym_dist[i];
+            if (dist == 0) {
+                int c = state->sym_lit[i];
+                outbits(state, h->lit_code[c], h->lit_len[c]);
+            } else {
+                int len = state->sym_lit[i] + 3;
+                int nextra;
+                int s = 257 + huff_len_sym(len, &nextra);
+                outbits(state, h->lit_code[s], h->lit_len[s]);
+                if (nextra) {
+                    outbits(state, (len - 3) & ((1 << nextra) - 1), nextra);
+                }
+                s = huff_dist_sym(dist, &nextra);
+                outbits(state, h->dist_code[s], h->dist_len[s]);
+                if (nextra) {
+                    outbits(state, (dist - 1) & ((1 << nextra) - 1), nextra);
+                }
+            }
+        }
+        outbits(state, h->lit_code[256], h->lit_len[256]);
+    }
+
+    memset(h->lit_freq, 0, sizeof(h->lit_freq));
+    memset(h->dist_freq, 0, sizeof(h->dist_freq));
+    state->sym_len = 0;
+}
+
+static void huff_add_literal(uzlib_lz77_state_t *state, uint8_t c) {
+    state->huff->lit_freq[c] += 1;
+    state->sym_lit[state->sym_len] = c;
+    state->sym_dist[state->sym_len] = 0;
+    if (++state->sym_len == state->sym_max) {
+        huff_write_block(state, false);
+    }
+}
+
+static void huff_add_match(uzlib_lz77_state_t *state, int dist, int len) {
+    int nextra;
+    state->huff->lit_freq[257 + huff_len_sym(len, &nextra)] += 1;
+    state->huff->dist_freq[huff_dist_sym(dist, &nextra)] += 1;
+    state->sym_lit[state->sym_len] = len - 3;
+    state->sym_dist[state->sym_len] = dist;
+    if (++state->sym_len == state->sym_max) {
+        huff_write_block(state, false);
+    }
+}
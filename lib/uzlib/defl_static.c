@@ -166,8 +166,18 @@ static void uzlib_match(uzlib_lz77_state_t *state, int distance, int len)
     }
 }
 
+#if UZLIB_CONF_LZ77_LEVELS
+static void huff_write_block(uzlib_lz77_state_t *state, bool final);
+#endif
+
 void uzlib_start_block(uzlib_lz77_state_t *state)
 {
+#if UZLIB_CONF_LZ77_LEVELS
+    if (state->huff != NULL) {
+        // Block headers are written once each block is complete.
+        return;
+    }
+#endif
     // Final block (0b1)
     // Static huffman block (0b01)
     outbits(state, 3, 3);
@@ -175,6 +185,14 @@ void uzlib_start_block(uzlib_lz77_state_t *state)
 
 void uzlib_finish_block(uzlib_lz77_state_t *state)
 {
+#if UZLIB_CONF_LZ77_LEVELS
+    if (state->huff != NULL) {
+        // Write the buffered symbols as the final block, then flush all bits.
+        huff_write_block(state, true);
+        outbits(state, 0, 7);
+        return;
+    }
+#endif
     // Close block (0b0000000)
     // Make sure all bits are flushed (0b0000000)
     outbits(state, 0, 14);
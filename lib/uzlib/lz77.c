@@ -6,12 +6,20 @@
  * (but still O(N)) but gives good compression and minimal memory usage.  For a
  * small history window (eg 256 bytes) it's not too slow and compresses well.
  *
+ * Optionally (with UZLIB_CONF_LZ77_LEVELS) compression levels 1-9 are available,
+ * which find matches by following hash chains of previous positions that start
+ * with the same 3 bytes, and write dynamic Huffman blocks.  These need extra
+ * memory proportional to the history size but are much faster for large windows.
+ *
  * MIT license; Copyright (c) 2021 Damien P. George
  */
 
 #include "uzlib.h"
 
 #include "defl_static.c"
+#if UZLIB_CONF_LZ77_LEVELS
+#include "defl_dynamic.c"
+#endif
 
 #define MATCH_LEN_MIN (3)
 #define MATCH_LEN_MAX (258)
@@ -28,6 +36,197 @@ void uzlib_lz77_init(uzlib_lz77_state_t *state, uint8_t *hist, size_t hist_max)
     state->hist_len = 0;
 }
 
+#if UZLIB_CONF_LZ77_LEVELS
+
+// Search parameters for each compression level.
+static const struct {
+    uint16_t max_chain;
+    uint8_t nice_len;
+    bool lazy;
+} uzlib_lz77_levels[UZLIB_LZ77_LEVEL_MAX] = {
+    { 4, 8, false },
+    { 8, 16, false },
+    { 32, 32, false },
+    { 16, 16, true },
+    { 32, 32, true },
+    { 128, 128, true },
+    { 256, 128, true },
+    { 1024, 255, true },
+    { 4096, 255, true },
+};
+
+static unsigned int uzlib_lz77_hash_bits(size_t hist_max) {
+    unsigned int bits = int_log2(hist_max);
+    return bits < 8 ? 8 : bits > 12 ? 12 : bits;
+}
+
+static size_t uzlib_lz77_sym_max(size_t hist_max) {
+    return hist_max < 1024 ? 1024 : hist_max > 4096 ? 4096 : hist_max;
+}
+
+size_t uzlib_lz77_level_mem_size(size_t hist_max) {
+    return sizeof(uzlib_lz77_huff_t)
+           + ((1 << uzlib_lz77_hash_bits(hist_max)) + hist_max) * sizeof(uint16_t)
+           + uzlib_lz77_sym_max(hist_max) * (sizeof(uint16_t) + sizeof(uint8_t));
+}
+
+// mem must be uzlib_lz77_level_mem_size(hist_max) bytes, aligned for a pointer.
+void uzlib_lz77_init_level(uzlib_lz77_state_t *state, int level, void *mem) {
+    assert(level >= 1 && level <= UZLIB_LZ77_LEVEL_MAX);
+    state->hash_bits = uzlib_lz77_hash_bits(state->hist_max);
+    state->sym_max = uzlib_lz77_sym_max(state->hist_max);
+    state->huff = mem;
+    state->hash_head = (uint16_t *)(state->huff + 1);
+    state->hash_prev = state->hash_head + (1 << state->hash_bits);
+    state->sym_dist = state->hash_prev + state->hist_max;
+    state->sym_lit = (uint8_t *)(state->sym_dist + state->sym_max);
+    memset(mem, 0, uzlib_lz77_level_mem_size(state->hist_max));
+    state->sym_len = 0;
+    state->pos = 0;
+    state->hash_pos = 0;
+    state->max_chain = uzlib_lz77_levels[level - 1].max_chain;
+    state->nice_len = uzlib_lz77_levels[level - 1].nice_len;
+    state->lazy = uzlib_lz77_levels[level - 1].lazy;
+}
+
+// Get the byte at stream position p, which is either in the history (before
+// base, the stream position of src) or in src.
+static inline uint8_t uzlib_lz77_get_byte(uzlib_lz77_state_t *state, const uint8_t *src, uint32_t base, uint32_t p) {
+    uint32_t back = base - p;
+    if (back - 1 < state->hist_len) {
+        return state->hist_buf[(state->hist_start + state->hist_len - back) & (state->hist_max - 1)];
+    }
+    return src[p - base];
+}
+
+static inline unsigned int uzlib_lz77_hash(uzlib_lz77_state_t *state, uint8_t b0, uint8_t b1, uint8_t b2) {
+    uint32_t v = (uint32_t)b0 << 16 | b1 << 8 | b2;
+    return (v * 2654435761u) >> (32 - state->hash_bits);
+}
+
+// Insert all positions before upto into the hash chains, as long as the 3
+// bytes starting at the position are available (end is the stream position
+// just past src).
+static void uzlib_lz77_hash_insert(uzlib_lz77_state_t *state, const uint8_t *src, uint32_t base, uint32_t end, uint32_t upto) {
+    uint32_t p = state->hash_pos;
+    while (p != upto && end - p > 2) {
+        unsigned int h;
+        if (p - base < end - base) {
+            // Fast path when all bytes are in src.
+            const uint8_t *s = src + (p - base);
+            h = uzlib_lz77_hash(state, s[0], s[1], s[2]);
+        } else {
+            h = uzlib_lz77_hash(state,
+                uzlib_lz77_get_byte(state, src, base, p),
+                uzlib_lz77_get_byte(state, src, base, p + 1),
+                uzlib_lz77_get_byte(state, src, base, p + 2));
+        }
+        state->hash_prev[p & (state->hist_max - 1)] = state->hash_head[h];
+        state->hash_head[h] = p;
+        ++p;
+    }
+    state->hash_pos = p;
+}
+
+// Find the longest match for the data at src[i], by following the hash chain
+// of previous positions.  Closer matches are preferred when equally long.
+static size_t uzlib_lz77_chain_match(uzlib_lz77_state_t *state, const uint8_t *src, uint32_t base, size_t i, size_t len, size_t *match_dist) {
+    size_t max_len = len - i < MATCH_LEN_MAX ? len - i : MATCH_LEN_MAX;
+    if (max_len < MATCH_LEN_MIN) {
+        return 0;
+    }
+    uint32_t cur = base + i;
+    const uint8_t *s = src + i;
+    size_t max_dist = state->hist_len + i < state->hist_max ? state->hist_len + i : state->hist_max;
+    size_t best_len = MATCH_LEN_MIN - 1;
+    size_t prev_dist = 0;
+    size_t dist = (uint16_t)(cur - state->hash_head[uzlib_lz77_hash(state, s[0], s[1], s[2])]);
+    for (size_t chain = state->max_chain; chain > 0 && dist > prev_dist && dist <= max_dist; --chain) {
+        uint32_t c = cur - dist;
+        size_t match_len = 0;
+        if (dist <= i) {
+            // Candidate is in src.
+            const uint8_t *m = s - dist;
+            if (m[best_len] == s[best_len]) {
+                while (match_len < max_len && m[match_len] == s[match_len]) {
+                    ++match_len;
+                }
+            }
+        } else if (uzlib_lz77_get_byte(state, src, base, c + best_len) == s[best_len]) {
+            while (match_len < max_len && uzlib_lz77_get_byte(state, src, base, c + match_len) == s[match_len]) {
+                ++match_len;
+            }
+        }
+        if (match_len > best_len) {
+            best_len = match_len;
+            *match_dist = dist;
+            if (match_len >= state->nice_len || match_len == max_len) {
+                break;
+            }
+        }
+        prev_dist = dist;
+        dist = (uint16_t)(cur - state->hash_prev[c & (state->hist_max - 1)]);
+    }
+    return best_len >= MATCH_LEN_MIN ? best_len : 0;
+}
+
+static void uzlib_lz77_compress_level(uzlib_lz77_state_t *state, const uint8_t *src, size_t len) {
+    uint32_t base = state->pos;
+    uint32_t end = base + len;
+    size_t prev_len = 0;
+    size_t prev_dist = 0;
+    for (size_t i = 0; i < len;) {
+        uzlib_lz77_hash_insert(state, src, base, end, base + i);
+        size_t match_dist = 0;
+        size_t match_len = uzlib_lz77_chain_match(state, src, base, i, len, &match_dist);
+        if (prev_len != 0) {
+            // A match was found at the previous position: take it unless this
+            // position has a longer one.
+            if (match_len > prev_len) {
+                huff_add_literal(state, src[i - 1]);
+                prev_len = match_len;
+                prev_dist = match_dist;
+                i += 1;
+            } else {
+                huff_add_match(state, prev_dist, prev_len);
+                i += prev_len - 1;
+                prev_len = 0;
+            }
+        } else if (match_len == 0) {
+            huff_add_literal(state, src[i]);
+            i += 1;
+        } else if (state->lazy && match_len < state->nice_len) {
+            prev_len = match_len;
+            prev_dist = match_dist;
+            i += 1;
+        } else {
+            huff_add_match(state, match_dist, match_len);
+            i += match_len;
+        }
+    }
+    // A deferred match always ends before the end of src.
+    assert(prev_len == 0);
+    uzlib_lz77_hash_insert(state, src, base, end, end);
+    state->pos = end;
+
+    // Push the most recent bytes into the history buffer.
+    size_t mask = state->hist_max - 1;
+    if (len >= state->hist_max) {
+        src += len - state->hist_max;
+        len = state->hist_max;
+    }
+    while (len--) {
+        state->hist_buf[(state->hist_start + state->hist_len) & mask] = *src++;
+        if (state->hist_len == state->hist_max) {
+            state->hist_start = (state->hist_start + 1) & mask;
+        } else {
+            ++state->hist_len;
+        }
+    }
+}
+
+#endif
+
 // Search back in the history for the maximum match of the given src data,
 // with support for searching beyond the end of the history and into the src buffer
 // (effectively the history and src buffer are concatenated).
@@ -62,6 +261,12 @@ static size_t uzlib_lz77_search_max_match(uzlib_lz77_state_t *state, const uint8
 
 // Compress the given chunk of data.
 void uzlib_lz77_compress(uzlib_lz77_state_t *state, const uint8_t *src, unsigned len) {
+    #if UZLIB_CONF_LZ77_LEVELS
+    if (state->huff != NULL) {
+        uzlib_lz77_compress_level(state, src, len);
+        return;
+    }
+    #endif
     const uint8_t *top = src + len;
     while (src < top) {
         // Look for a match in the history window.
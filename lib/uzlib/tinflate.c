@@ -105,13 +105,92 @@ const unsigned char clcidx[] = {
  * -- utility functions -- *
  * ----------------------- */
 
+#if UZLIB_CONF_FAST_INFLATE
+/*
+ * Build the lookup table for a tree, from its code length counts and
+ * symbols.  The primary table is indexed by the next TINF_FAST_BITS bits of
+ * input.  Its entries are either:
+ *  - 0, for a code that can't be decoded with the table;
+ *  - symbol << 4 | code length, for a code of up to TINF_FAST_BITS bits;
+ *  - 0x8000 | offset << 4 | bits, pointing to a subtable indexed by the
+ *    following bits, which holds entries for the longer codes.
+ * Subtables that don't fit are left out, and decoding of those codes falls
+ * back to tinf_decode_symbol's canonical decoder.
+ */
+static void tinf_build_fast(TINF_TREE *t)
+{
+   unsigned short count[16];
+   unsigned int len, i, n, j;
+   unsigned int code = 0, sym_idx = 0;
+   unsigned int next = 1 << TINF_FAST_BITS;
+   unsigned int low = (unsigned int)-1, sub_base = 0, sub_bits = 0;
+
+   for (i = 0; i < 16; ++i) count[i] = t->table[i];
+   for (i = 0; i < (1 << TINF_FAST_BITS); ++i) t->fast[i] = 0;
+
+   for (len = 1; len < 16; ++len, code <<= 1)
+   {
+      for (n = t->table[len]; n; --n, ++code, ++sym_idx)
+      {
+         unsigned int entry = t->trans[sym_idx] << 4 | len;
+         unsigned int rev = 0;
+
+         /* codes are stored most significant bit first */
+         for (i = 0; i < len; ++i) rev |= ((code >> i) & 1) << (len - 1 - i);
+
+         if (len <= TINF_FAST_BITS)
+         {
+            for (j = rev; j < (1 << TINF_FAST_BITS); j += 1 << len) t->fast[j] = entry;
+         }
+         else
+         {
+            unsigned int prefix = rev & ((1 << TINF_FAST_BITS) - 1);
+            if (prefix != low)
+            {
+               /* size the subtable to hold the remaining codes with this
+                  prefix, as zlib's inflate_table() does */
+               int left;
+               low = prefix;
+               sub_bits = len - TINF_FAST_BITS;
+               left = 1 << sub_bits;
+               while (sub_bits + TINF_FAST_BITS < 15)
+               {
+                  left -= count[sub_bits + TINF_FAST_BITS];
+                  if (left <= 0) break;
+                  ++sub_bits;
+                  left <<= 1;
+               }
+               if (next + (1 << sub_bits) > TINF_FAST_SIZE)
+               {
+                  sub_bits = 0;
+               }
+               else
+               {
+                  sub_base = next;
+                  next += 1 << sub_bits;
+                  for (j = sub_base; j < next; ++j) t->fast[j] = 0;
+                  t->fast[prefix] = 0x8000 | sub_base << 4 | sub_bits;
+               }
+            }
+            if (sub_bits)
+            {
+               for (j = rev >> TINF_FAST_BITS; j < (1u << sub_bits); j += 1 << (len - TINF_FAST_BITS))
+                  t->fast[sub_base + j] = entry;
+            }
+         }
+         count[len]--;
+      }
+   }
+}
+#endif
+
 /* build the fixed huffman trees */
 static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
 {
    int i;
 
    /* build fixed length tree */
-   for (i = 0; i < 7; ++i) lt->table[i] = 0;
+   for (i = 0; i < 16; ++i) lt->table[i] = 0;
 
    lt->table[7] = 24;
    lt->table[8] = 152;
@@ -123,11 +202,16 @@ static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
    for (i = 0; i < 112; ++i) lt->trans[24 + 144 + 8 + i] = 144 + i;
 
    /* build fixed distance tree */
-   for (i = 0; i < 5; ++i) dt->table[i] = 0;
+   for (i = 0; i < 16; ++i) dt->table[i] = 0;
 
    dt->table[5] = 32;
 
    for (i = 0; i < 32; ++i) dt->trans[i] = i;
+
+   #if UZLIB_CONF_FAST_INFLATE
+   tinf_build_fast(lt);
+   tinf_build_fast(dt);
+   #endif
 }
 
 /* given an array of code lengths, build a tree */
@@ -167,6 +251,10 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
    {
       if (lengths[i]) t->trans[offs[lengths[i]]++] = i;
    }
+
+   #if UZLIB_CONF_FAST_INFLATE
+   tinf_build_fast(t);
+   #endif
 }
 
 /* ---------------------- *
@@ -219,6 +307,28 @@ uint32_t tinf_get_be_uint32(uzlib_uncomp_t *d)
     return val;
 }
 
+#if UZLIB_CONF_FAST_INFLATE
+/* fill the bit buffer with whole bytes available in the source buffer,
+   without calling source_read_cb */
+static void tinf_refill(uzlib_uncomp_t *d)
+{
+   while (d->bitcount <= sizeof(d->tag) * 8 - 8 && d->source < d->source_limit)
+   {
+      d->tag |= (uintptr_t)*d->source++ << d->bitcount;
+      d->bitcount += 8;
+   }
+}
+
+void uzlib_uncompress_unget(uzlib_uncomp_t *d)
+{
+   /* Whole bytes in the bit buffer were only read ahead by tinf_refill(),
+      so they are the last bytes taken from the source buffer. */
+   d->source -= d->bitcount >> 3;
+   d->bitcount &= 7;
+   d->tag &= (1 << d->bitcount) - 1;
+}
+#endif
+
 /* get one bit from source stream */
 static int tinf_getbit(uzlib_uncomp_t *d)
 {
@@ -244,6 +354,17 @@ static unsigned int tinf_read_bits(uzlib_uncomp_t *d, int num, int base)
 {
    unsigned int val = 0;
 
+   #if UZLIB_CONF_FAST_INFLATE
+   tinf_refill(d);
+   if (d->bitcount >= (unsigned int)num)
+   {
+      val = d->tag & ((1 << num) - 1);
+      d->tag >>= num;
+      d->bitcount -= num;
+      return val + base;
+   }
+   #endif
+
    /* read num bits */
    if (num)
    {
@@ -262,6 +383,24 @@ static int tinf_decode_symbol(uzlib_uncomp_t *d, TINF_TREE *t)
 {
    int sum = 0, cur = 0, len = 0;
 
+   #if UZLIB_CONF_FAST_INFLATE
+   unsigned int e;
+   tinf_refill(d);
+   e = t->fast[d->tag & ((1 << TINF_FAST_BITS) - 1)];
+   if (e & 0x8000)
+   {
+      e = t->fast[((e >> 4) & 0x7ff) + ((d->tag >> TINF_FAST_BITS) & ((1 << (e & 15)) - 1))];
+   }
+   /* only use the entry if all bits of its code are in the bit buffer,
+      otherwise decode a bit at a time, which may call source_read_cb */
+   if (e != 0 && (e & 15) <= d->bitcount)
+   {
+      d->tag >>= e & 15;
+      d->bitcount -= e & 15;
+      return e >> 4;
+   }
+   #endif
+
    /* get more bits while code value is above sum */
    do {
 
@@ -475,6 +614,13 @@ static int tinf_inflate_uncompressed_block(uzlib_uncomp_t *d)
     if (d->curlen == 0) {
         unsigned int length, invlength;
 
+        #if UZLIB_CONF_FAST_INFLATE
+        /* the length follows the bits of the current byte, so give back
+           any bytes read ahead of it */
+        uzlib_uncompress_unget(d);
+        d->tag = 0;
+        #endif
+
         /* get length */
         length = uzlib_get_byte(d);
         length += 256 * uzlib_get_byte(d);
@@ -509,6 +655,7 @@ static int tinf_inflate_uncompressed_block(uzlib_uncomp_t *d)
 void uzlib_uncompress_init(uzlib_uncomp_t *d, void *dict, unsigned int dictLen)
 {
    d->eof = 0;
+   d->tag = 0;
    d->bitcount = 0;
    d->bfinal = 0;
    d->btype = -1;
@@ -572,6 +719,12 @@ next_blk:
         }
 
         if (res != UZLIB_OK) {
+            #if UZLIB_CONF_FAST_INFLATE
+            /* let the caller read what follows the compressed data */
+            if (res == UZLIB_DONE) {
+                uzlib_uncompress_unget(d);
+            }
+            #endif
             return res;
         }
 
@@ -69,9 +69,19 @@ extern "C" {
 
 /* data structures */
 
+#if UZLIB_CONF_FAST_INFLATE
+/* Number of bits decoded by the primary lookup table, and the size of the
+   primary table plus the subtables for longer codes. */
+#define TINF_FAST_BITS 9
+#define TINF_FAST_SIZE 852
+#endif
+
 typedef struct {
    unsigned short table[16];  /* table of code length counts */
    unsigned short trans[288]; /* code -> symbol translation table */
+#if UZLIB_CONF_FAST_INFLATE
+   unsigned short fast[TINF_FAST_SIZE]; /* lookup table, see tinf_build_fast() */
+#endif
 } TINF_TREE;
 
 typedef struct _uzlib_uncomp_t {
@@ -87,7 +97,12 @@ typedef struct _uzlib_uncomp_t {
     void *source_read_data;
     int (*source_read_cb)(void *);
 
+#if UZLIB_CONF_FAST_INFLATE
+    /* Bit buffer, which may hold whole bytes read ahead from source */
+    uintptr_t tag;
+#else
     unsigned int tag;
+#endif
     unsigned int bitcount;
 
     /* Destination (output) buffer start */
@@ -127,6 +142,11 @@ unsigned char uzlib_get_byte(uzlib_uncomp_t *d);
 void uzlib_uncompress_init(uzlib_uncomp_t *d, void *dict, unsigned int dictLen);
 int  uzlib_uncompress(uzlib_uncomp_t *d);
 int  uzlib_uncompress_chksum(uzlib_uncomp_t *d);
+#if UZLIB_CONF_FAST_INFLATE
+/* Give back whole bytes read ahead into the bit buffer, by moving source
+   back, so that source_limit - source bytes of the buffer are unused. */
+void uzlib_uncompress_unget(uzlib_uncomp_t *d);
+#endif
 
 #define UZLIB_HEADER_ZLIB             0
 #define UZLIB_HEADER_GZIP             1
@@ -143,11 +163,38 @@ typedef struct {
     size_t hist_max;
     size_t hist_start;
     size_t hist_len;
+#if UZLIB_CONF_LZ77_LEVELS
+    /* The following are only used for levels 1-9, when huff is non-NULL.
+       huff is the start of the memory passed to uzlib_lz77_init_level. */
+    struct _uzlib_lz77_huff_t *huff;
+    uint16_t *hash_head;
+    uint16_t *hash_prev;
+    uint16_t *sym_dist; /* match distance, or 0 for a literal */
+    uint8_t *sym_lit; /* literal byte, or match length - 3 */
+    size_t sym_len;
+    size_t sym_max;
+    uint32_t pos; /* stream position of the next input byte */
+    uint32_t hash_pos; /* stream position of the next byte to hash */
+    uint8_t hash_bits;
+    bool lazy;
+    /* These may be changed after uzlib_lz77_init_level to tune the search. */
+    uint16_t max_chain;
+    uint16_t nice_len;
+#endif
 } uzlib_lz77_state_t;
 
 void uzlib_lz77_init(uzlib_lz77_state_t *state, uint8_t *hist, size_t hist_max);
 void uzlib_lz77_compress(uzlib_lz77_state_t *state, const uint8_t *src, unsigned len);
 
+#if UZLIB_CONF_LZ77_LEVELS
+#define UZLIB_LZ77_LEVEL_MAX 9
+/* Memory needed by uzlib_lz77_init_level for the given history size */
+size_t uzlib_lz77_level_mem_size(size_t hist_max);
+/* Select a compression level 1-9, called after uzlib_lz77_init.  Level 0 is
+   the default brute force search with static Huffman output. */
+void uzlib_lz77_init_level(uzlib_lz77_state_t *state, int level, void *mem);
+#endif
+
 void uzlib_start_block(uzlib_lz77_state_t *state);
 void uzlib_finish_block(uzlib_lz77_state_t *state);
 
@@ -19,4 +19,24 @@
 #define UZLIB_CONF_PARANOID_CHECKS 0
 #endif
 
+#ifndef UZLIB_CONF_LZ77_LEVELS
+/* Support compression levels 1-9 in the LZ77 compressor, which use hash
+   chains to find matches and dynamic Huffman blocks for the output. */
+#define UZLIB_CONF_LZ77_LEVELS 0
+#endif
+
+#ifndef UZLIB_CONF_FAST_INFLATE
+/* Decode Huffman codes with lookup tables (about 3.4KB more per
+   decompressor) and a register-wide bit buffer, refilled directly from the
+   source buffer, instead of a bit at a time. */
+#define UZLIB_CONF_FAST_INFLATE 0
+#endif
+
+#ifndef UZLIB_CONF_FAST_CHECKSUM
+/* Compute CRC32 with slice-by-8 tables (8KB of ROM) and use CRC32,
+   PCLMUL or SSSE3 instructions for CRC32 and Adler32 when the compiler
+   targets them. */
+#define UZLIB_CONF_FAST_CHECKSUM 0
+#endif
+
 #endif /* UZLIB_CONF_H_INCLUDED */
@@ -43,6 +43,7 @@ NATIVE_ARCHS = {
     "NATIVE_ARCH_ARMV7EMDP": "armv7emdp",
     "NATIVE_ARCH_XTENSA": "xtensa",
     "NATIVE_ARCH_XTENSAWIN": "xtensawin",
+    "NATIVE_ARCH_ARM64": "arm64",
 }
 
 globals().update(NATIVE_ARCHS)
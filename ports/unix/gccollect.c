@@ -45,4 +45,86 @@ void gc_collect(void) {
     gc_collect_end();
 }
 
+#if MICROPY_GC_PARALLEL_MARK
+
+#include <pthread.h>
+#include <signal.h>
+
+// Pool of helper threads for the parallel mark phase.  They are created on
+// first use and then sleep on a condition variable between collections.
+static pthread_mutex_t gc_mark_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gc_mark_pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t gc_mark_pool_done = PTHREAD_COND_INITIALIZER;
+static size_t gc_mark_pool_n_threads;
+static size_t gc_mark_pool_n_requested;
+static size_t gc_mark_pool_n_running;
+static unsigned int gc_mark_pool_generation;
+
+static void *gc_mark_pool_entry(void *arg) {
+    size_t worker = (size_t)(uintptr_t)arg;
+    unsigned int generation = 0;
+    pthread_mutex_lock(&gc_mark_pool_mutex);
+    for (;;) {
+        while (generation == gc_mark_pool_generation) {
+            pthread_cond_wait(&gc_mark_pool_start, &gc_mark_pool_mutex);
+        }
+        generation = gc_mark_pool_generation;
+        if (worker >= gc_mark_pool_n_requested) {
+            continue;
+        }
+        pthread_mutex_unlock(&gc_mark_pool_mutex);
+        gc_mark_worker(worker);
+        pthread_mutex_lock(&gc_mark_pool_mutex);
+        if (--gc_mark_pool_n_running == 0) {
+            pthread_cond_signal(&gc_mark_pool_done);
+        }
+    }
+    return NULL;
+}
+
+void gc_mark_run_workers(size_t n_workers) {
+    pthread_mutex_lock(&gc_mark_pool_mutex);
+
+    // Start any extra threads needed (worker 0 is the calling thread).  They
+    // block all signals so they never run Python-level signal handlers.
+    if (gc_mark_pool_n_threads + 1 < n_workers) {
+        sigset_t set, old_set;
+        sigfillset(&set);
+        pthread_sigmask(SIG_SETMASK, &set, &old_set);
+        while (gc_mark_pool_n_threads + 1 < n_workers) {
+            pthread_t id;
+            if (pthread_create(&id, NULL, gc_mark_pool_entry, (void *)(uintptr_t)(gc_mark_pool_n_threads + 1)) != 0) {
+                break;
+            }
+            pthread_detach(id);
+            gc_mark_pool_n_threads += 1;
+        }
+        pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+    }
+
+    // If not all threads could be created then the remaining workers are run
+    // on this thread once the others have finished; their deques will have
+    // been drained by stealing so they return straight away.
+    size_t n_threads = MIN(gc_mark_pool_n_threads + 1, n_workers);
+    gc_mark_pool_n_requested = n_threads;
+    gc_mark_pool_n_running = n_threads - 1;
+    gc_mark_pool_generation += 1;
+    pthread_cond_broadcast(&gc_mark_pool_start);
+    pthread_mutex_unlock(&gc_mark_pool_mutex);
+
+    gc_mark_worker(0);
+
+    pthread_mutex_lock(&gc_mark_pool_mutex);
+    while (gc_mark_pool_n_running != 0) {
+        pthread_cond_wait(&gc_mark_pool_done, &gc_mark_pool_mutex);
+    }
+    pthread_mutex_unlock(&gc_mark_pool_mutex);
+
+    for (size_t i = n_threads; i < n_workers; i++) {
+        gc_mark_worker(i);
+    }
+}
+
+#endif // MICROPY_GC_PARALLEL_MARK
+
 #endif // MICROPY_ENABLE_GC
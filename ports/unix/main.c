@@ -62,6 +62,9 @@ static uint emit_opt = MP_EMIT_OPT_NONE;
 // Heap size of GC heap (if enabled)
 // Make it larger on a 64 bit machine, because pointers are larger.
 long heap_size = 1024 * 1024 * (sizeof(mp_uint_t) / 4);
+#if MICROPY_GC_PARALLEL_MARK
+static long gc_threads = 0; // 0 means one per online CPU
+#endif
 #endif
 
 // Number of heaps to assign by default if MICROPY_GC_SPLIT_HEAP=1
@@ -343,6 +346,10 @@ static void print_help(char **argv) {
         , heap_size);
     impl_opts_cnt++;
     #endif
+    #if MICROPY_GC_PARALLEL_MARK
+    printf("  gcthreads=<n> -- set the number of threads used to mark the heap\n");
+    impl_opts_cnt++;
+    #endif
     #if defined(__APPLE__)
     printf("  realtime -- set thread priority to realtime\n");
     impl_opts_cnt++;
@@ -418,6 +425,14 @@ static void pre_process_options(int argc, char **argv) {
                         goto invalid_arg;
                     }
                 #endif
+                #if MICROPY_GC_PARALLEL_MARK
+                } else if (strncmp(argv[a + 1], "gcthreads=", sizeof("gcthreads=") - 1) == 0) {
+                    char *end;
+                    gc_threads = strtol(argv[a + 1] + sizeof("gcthreads=") - 1, &end, 0);
+                    if (*end != 0 || gc_threads < 1 || gc_threads > MICROPY_GC_PARALLEL_MARK_MAX_WORKERS) {
+                        goto invalid_arg;
+                    }
+                #endif
                 #if defined(__APPLE__)
                 } else if (strcmp(argv[a + 1], "realtime") == 0) {
                     #if MICROPY_PY_THREAD
@@ -519,6 +534,12 @@ MP_NOINLINE int main_(int argc, char **argv) {
         }
     }
     #endif
+    #if MICROPY_GC_PARALLEL_MARK
+    if (gc_threads == 0) {
+        gc_threads = MIN(MAX(sysconf(_SC_NPROCESSORS_ONLN), 1), MICROPY_GC_PARALLEL_MARK_MAX_WORKERS);
+    }
+    MP_STATE_MEM(gc_mark_n_workers) = gc_threads;
+    #endif
     #endif
 
     #if MICROPY_ENABLE_PYSTACK
@@ -14,6 +14,9 @@ MICROPY_PY_BTREE = 1
 # _thread module using pthreads
 MICROPY_PY_THREAD = 1
 
+# Share the GC mark phase between worker pthreads (requires MICROPY_PY_THREAD)
+MICROPY_GC_PARALLEL_MARK = 0
+
 # Subset of CPython termios module
 MICROPY_PY_TERMIOS = 1
 
@@ -14,3 +14,6 @@ USER_C_MODULES = $(TOP)/examples/usercmodule
 
 SRC_C += coverage.c
 SRC_CXX += coveragecpp.cpp
+
+# Test the parallel GC mark phase.
+MICROPY_GC_PARALLEL_MARK = 1
@@ -69,6 +69,45 @@
 #define MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF (1)
 #define MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE (256)
 
+// Scan the GC allocation table a word at a time.
+#define MICROPY_OPT_GC_WORD_SCAN       (1)
+
+// Find free runs of blocks for larger allocations in a fragmented heap quickly.
+#define MICROPY_GC_FREE_INDEX          (1)
+
+// Index dynamically interned qstrs so lookup cost doesn't grow with uptime.
+#define MICROPY_QSTR_HASH_INDEX        (1)
+
+// Support sampling heap allocations via micropython.heap_profile().
+#define MICROPY_PY_MICROPYTHON_HEAP_PROFILE (1)
+
+// Cache where LOAD_GLOBAL, LOAD_ATTR and LOAD_METHOD found their names.
+#define MICROPY_OPT_INLINE_CACHE       (1)
+
+// Specialise BINARY_OP opcodes for small int, float and str operands.
+#define MICROPY_OPT_QUICKEN_BINARY_OP  (1)
+
+// Fuse common opcode sequences into superinstructions.
+#define MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS (1)
+
+// Read files and sockets a page at a time in json.load().
+#define MICROPY_PY_JSON_LOAD_CHUNK_SIZE (4096)
+
+// Use table-driven Huffman decoding for deflate.
+#ifndef MICROPY_PY_DEFLATE_FAST_INFLATE
+#define MICROPY_PY_DEFLATE_FAST_INFLATE (1)
+#endif
+
+// Use table-driven and SIMD CRC32/Adler32 for deflate and binascii.crc32.
+#ifndef MICROPY_PY_DEFLATE_FAST_CHECKSUM
+#define MICROPY_PY_DEFLATE_FAST_CHECKSUM (1)
+#endif
+
+// Use subquadratic multiplication, division and string conversion for big ints.
+#ifndef MICROPY_OPT_MPZ_SUBQUADRATIC
+#define MICROPY_OPT_MPZ_SUBQUADRATIC (1)
+#endif
+
 // Allow loading of .mpy files.
 #define MICROPY_PERSISTENT_CODE_LOAD   (1)
 
@@ -0,0 +1,326 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013, 2014 Damien P. George
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "py/runtime.h"
+
+// wrapper around everything in this file
+#if MICROPY_EMIT_ARM64
+
+#include "py/asmarm64.h"
+
+#define WORD_SIZE (8)
+#define SIGNED_FIT19(x) (-0x40000 <= (x) && (x) < 0x40000)
+#define SIGNED_FIT21(x) (-0x100000 <= (x) && (x) < 0x100000)
+#define SIGNED_FIT26(x) (-0x2000000 <= (x) && (x) < 0x2000000)
+
+// All instructions are 32 bits, stored little endian
+void asm_arm64_op32(asm_arm64_t *as, uint32_t op) {
+    uint8_t *c = mp_asm_base_get_cur_to_write_bytes(&as->base, 4);
+    if (c != NULL) {
+        c[0] = op;
+        c[1] = op >> 8;
+        c[2] = op >> 16;
+        c[3] = op >> 24;
+    }
+}
+
+static void asm_arm64_op_movz(asm_arm64_t *as, uint rd, uint hw, uint imm16) {
+    // movz rd, #imm16, lsl #(hw*16)
+    asm_arm64_op32(as, 0xd2800000 | hw << 21 | imm16 << 5 | rd);
+}
+
+static void asm_arm64_op_movn(asm_arm64_t *as, uint rd, uint hw, uint imm16) {
+    // movn rd, #imm16, lsl #(hw*16)
+    asm_arm64_op32(as, 0x92800000 | hw << 21 | imm16 << 5 | rd);
+}
+
+static void asm_arm64_op_movk(asm_arm64_t *as, uint rd, uint hw, uint imm16) {
+    // movk rd, #imm16, lsl #(hw*16)
+    asm_arm64_op32(as, 0xf2800000 | hw << 21 | imm16 << 5 | rd);
+}
+
+static void asm_arm64_op_add_sub_imm(asm_arm64_t *as, bool sub, uint rd, uint rn, uint imm) {
+    // add/sub rd, rn, #imm, using a second instruction for bits 12-23
+    // (rd and rn may be SP)
+    assert(imm < 0x1000000);
+    uint32_t op = sub ? 0xd1000000 : 0x91000000;
+    if (imm >= 0x1000) {
+        asm_arm64_op32(as, op | 1 << 22 | (imm >> 12) << 10 | rn << 5 | rd);
+        imm &= 0xfff;
+        if (imm == 0) {
+            return;
+        }
+        rn = rd;
+    }
+    asm_arm64_op32(as, op | imm << 10 | rn << 5 | rd);
+}
+
+static void asm_arm64_op_reg_reg_reg(asm_arm64_t *as, uint32_t op, uint rd, uint rn, uint rm) {
+    asm_arm64_op32(as, op | rm << 16 | rn << 5 | rd);
+}
+
+// locals:
+//  - stored on the stack in ascending order
+//  - numbered 0 through num_locals-1
+//  - SP points to first local
+//
+//  | SP
+//  v
+//  l0  l1  l2  ...  l(n-1)  x21 x22  x19 x20  x29 x30
+//  ^                ^                         ^
+//  | low address    | high address in RAM     | x29 (frame record)
+
+void asm_arm64_entry(asm_arm64_t *as, int num_locals) {
+    assert(num_locals >= 0);
+
+    // keep SP 16-byte aligned, as required by the AAPCS64
+    as->stack_adjust = (num_locals * WORD_SIZE + 15) & ~15;
+
+    // save frame record and the callee-save registers used by the emitter
+    asm_arm64_op32(as, 0xa9bf7bfd); // stp x29, x30, [sp, #-16]!
+    asm_arm64_op32(as, 0x910003fd); // mov x29, sp
+    asm_arm64_op32(as, 0xa9bf53f3); // stp x19, x20, [sp, #-16]!
+    asm_arm64_op32(as, 0xa9bf5bf5); // stp x21, x22, [sp, #-16]!
+
+    if (as->stack_adjust > 0) {
+        asm_arm64_op_add_sub_imm(as, true, ASM_ARM64_REG_SP, ASM_ARM64_REG_SP, as->stack_adjust);
+    }
+}
+
+void asm_arm64_exit(asm_arm64_t *as) {
+    if (as->stack_adjust > 0) {
+        asm_arm64_op_add_sub_imm(as, false, ASM_ARM64_REG_SP, ASM_ARM64_REG_SP, as->stack_adjust);
+    }
+
+    asm_arm64_op32(as, 0xa8c15bf5); // ldp x21, x22, [sp], #16
+    asm_arm64_op32(as, 0xa8c153f3); // ldp x19, x20, [sp], #16
+    asm_arm64_op32(as, 0xa8c17bfd); // ldp x29, x30, [sp], #16
+    asm_arm64_op32(as, 0xd65f03c0); // ret
+}
+
+void asm_arm64_mov_reg_reg(asm_arm64_t *as, uint reg_dest, uint reg_src) {
+    // mov rd, rm (orr rd, xzr, rm)
+    asm_arm64_op_reg_reg_reg(as, 0xaa000000, reg_dest, ASM_ARM64_REG_XZR, reg_src);
+}
+
+void asm_arm64_mov_reg_i64_optimised(asm_arm64_t *as, uint reg_dest, uint64_t imm) {
+    // Build the value from 16-bit chunks, starting from all zeros (movz) or all
+    // ones (movn) depending on which needs fewer movk instructions to patch up.
+    uint n_zero = 0;
+    uint n_ones = 0;
+    for (uint hw = 0; hw < 4; ++hw) {
+        uint chunk = (imm >> (16 * hw)) & 0xffff;
+        n_zero += chunk == 0;
+        n_ones += chunk == 0xffff;
+    }
+    uint fill = n_ones > n_zero ? 0xffff : 0;
+    bool first = true;
+    for (uint hw = 0; hw < 4; ++hw) {
+        uint chunk = (imm >> (16 * hw)) & 0xffff;
+        if (chunk == fill) {
+            continue;
+        }
+        if (!first) {
+            asm_arm64_op_movk(as, reg_dest, hw, chunk);
+        } else if (fill) {
+            asm_arm64_op_movn(as, reg_dest, hw, ~chunk & 0xffff);
+        } else {
+            asm_arm64_op_movz(as, reg_dest, hw, chunk);
+        }
+        first = false;
+    }
+    if (first) {
+        // value is 0 or -1
+        if (fill) {
+            asm_arm64_op_movn(as, reg_dest, 0, 0);
+        } else {
+            asm_arm64_op_movz(as, reg_dest, 0, 0);
+        }
+    }
+}
+
+void asm_arm64_mov_local_reg(asm_arm64_t *as, int local_num, uint reg_src) {
+    asm_arm64_str_reg_reg_offset(as, 3, reg_src, ASM_ARM64_REG_SP, local_num * WORD_SIZE);
+}
+
+void asm_arm64_mov_reg_local(asm_arm64_t *as, uint reg_dest, int local_num) {
+    asm_arm64_ldr_reg_reg_offset(as, 3, reg_dest, ASM_ARM64_REG_SP, local_num * WORD_SIZE);
+}
+
+void asm_arm64_mov_reg_local_addr(asm_arm64_t *as, uint reg_dest, int local_num) {
+    // add rd, sp, #local_num*8
+    asm_arm64_op_add_sub_imm(as, false, reg_dest, ASM_ARM64_REG_SP, local_num * WORD_SIZE);
+}
+
+static mp_int_t get_label_rel(asm_arm64_t *as, uint label) {
+    assert(label < as->base.max_num_labels);
+    return as->base.label_offsets[label] - as->base.code_offset;
+}
+
+void asm_arm64_mov_reg_pcrel(asm_arm64_t *as, uint reg_dest, uint label) {
+    // adr rd, label
+    mp_int_t rel = get_label_rel(as, label);
+    if (as->base.pass == MP_ASM_PASS_EMIT && !SIGNED_FIT21(rel)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("asm overflow"));
+    }
+    asm_arm64_op32(as, 0x10000000 | (rel & 3) << 29 | ((rel >> 2) & 0x7ffff) << 5 | reg_dest);
+}
+
+void asm_arm64_cset_reg(asm_arm64_t *as, uint reg_dest, uint cond) {
+    // cset rd, cond (csinc rd, xzr, xzr, !cond)
+    asm_arm64_op32(as, 0x9a9f07e0 | (cond ^ 1) << 12 | reg_dest);
+}
+
+void asm_arm64_cmp_reg_reg(asm_arm64_t *as, uint reg_src1, uint reg_src2) {
+    // cmp rn, rm (subs xzr, rn, rm)
+    asm_arm64_op_reg_reg_reg(as, 0xeb000000, ASM_ARM64_REG_XZR, reg_src1, reg_src2);
+}
+
+void asm_arm64_tst_reg_u8(asm_arm64_t *as, uint reg_src) {
+    // tst wn, #0xff
+    // A C function returning bool only defines the low 8 bits of the result
+    asm_arm64_op32(as, 0x72001c1f | reg_src << 5);
+}
+
+void asm_arm64_mvn_reg_reg(asm_arm64_t *as, uint rd, uint rm) {
+    // mvn rd, rm (orn rd, xzr, rm)
+    asm_arm64_op_reg_reg_reg(as, 0xaa200000, rd, ASM_ARM64_REG_XZR, rm);
+}
+
+void asm_arm64_neg_reg_reg(asm_arm64_t *as, uint rd, uint rm) {
+    // neg rd, rm (sub rd, xzr, rm)
+    asm_arm64_op_reg_reg_reg(as, 0xcb000000, rd, ASM_ARM64_REG_XZR, rm);
+}
+
+void asm_arm64_add_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    asm_arm64_op_reg_reg_reg(as, 0x8b000000, rd, rn, rm);
+}
+
+void asm_arm64_sub_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    asm_arm64_op_reg_reg_reg(as, 0xcb000000, rd, rn, rm);
+}
+
+void asm_arm64_mul_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    // mul rd, rn, rm (madd rd, rn, rm, xzr)
+    asm_arm64_op_reg_reg_reg(as, 0x9b007c00, rd, rn, rm);
+}
+
+void asm_arm64_and_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    asm_arm64_op_reg_reg_reg(as, 0x8a000000, rd, rn, rm);
+}
+
+void asm_arm64_eor_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    asm_arm64_op_reg_reg_reg(as, 0xca000000, rd, rn, rm);
+}
+
+void asm_arm64_orr_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    asm_arm64_op_reg_reg_reg(as, 0xaa000000, rd, rn, rm);
+}
+
+void asm_arm64_lsl_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    // lslv rd, rn, rm
+    asm_arm64_op_reg_reg_reg(as, 0x9ac02000, rd, rn, rm);
+}
+
+void asm_arm64_lsr_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    // lsrv rd, rn, rm
+    asm_arm64_op_reg_reg_reg(as, 0x9ac02400, rd, rn, rm);
+}
+
+void asm_arm64_asr_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm) {
+    // asrv rd, rn, rm
+    asm_arm64_op_reg_reg_reg(as, 0x9ac02800, rd, rn, rm);
+}
+
+static void asm_arm64_ldst_reg_reg_offset(asm_arm64_t *as, uint32_t op, uint size_log2, uint rt, uint rn, uint byte_offset) {
+    if ((byte_offset & ((1 << size_log2) - 1)) == 0 && (byte_offset >> size_log2) < 0x1000) {
+        // ldr/str rt, [rn, #byte_offset] with scaled unsigned 12-bit offset
+        asm_arm64_op32(as, op | 0x01000000 | size_log2 << 30 | (byte_offset >> size_log2) << 10 | rn << 5 | rt);
+    } else {
+        // ldr/str rt, [rn, x16] with the offset in the scratch register
+        asm_arm64_mov_reg_i64_optimised(as, ASM_ARM64_REG_SCRATCH, byte_offset);
+        asm_arm64_op32(as, op | 0x00206800 | size_log2 << 30 | ASM_ARM64_REG_SCRATCH << 16 | rn << 5 | rt);
+    }
+}
+
+void asm_arm64_ldr_reg_reg_offset(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint byte_offset) {
+    asm_arm64_ldst_reg_reg_offset(as, 0x38400000, size_log2, rt, rn, byte_offset);
+}
+
+void asm_arm64_str_reg_reg_offset(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint byte_offset) {
+    asm_arm64_ldst_reg_reg_offset(as, 0x38000000, size_log2, rt, rn, byte_offset);
+}
+
+void asm_arm64_ldr_reg_reg_reg(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint rm) {
+    // ldr rt, [rn, rm, lsl #size_log2]
+    asm_arm64_op32(as, 0x38606800 | size_log2 << 30 | (size_log2 != 0) << 12 | rm << 16 | rn << 5 | rt);
+}
+
+void asm_arm64_str_reg_reg_reg(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint rm) {
+    // str rt, [rn, rm, lsl #size_log2]
+    asm_arm64_op32(as, 0x38206800 | size_log2 << 30 | (size_log2 != 0) << 12 | rm << 16 | rn << 5 | rt);
+}
+
+void asm_arm64_b_label(asm_arm64_t *as, uint label) {
+    mp_int_t rel = get_label_rel(as, label) >> 2;
+    if (as->base.pass == MP_ASM_PASS_EMIT && !SIGNED_FIT26(rel)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("asm overflow"));
+    }
+    asm_arm64_op32(as, 0x14000000 | (rel & 0x3ffffff));
+}
+
+void asm_arm64_bcc_label(asm_arm64_t *as, uint cond, uint label) {
+    mp_int_t rel = get_label_rel(as, label) >> 2;
+    if (as->base.pass == MP_ASM_PASS_EMIT && !SIGNED_FIT19(rel)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("asm overflow"));
+    }
+    asm_arm64_op32(as, 0x54000000 | (rel & 0x7ffff) << 5 | cond);
+}
+
+void asm_arm64_cbz_reg_label(asm_arm64_t *as, bool nonzero, uint reg, uint label) {
+    // cbz/cbnz rt, label
+    mp_int_t rel = get_label_rel(as, label) >> 2;
+    if (as->base.pass == MP_ASM_PASS_EMIT && !SIGNED_FIT19(rel)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("asm overflow"));
+    }
+    asm_arm64_op32(as, 0xb4000000 | nonzero << 24 | (rel & 0x7ffff) << 5 | reg);
+}
+
+void asm_arm64_br_reg(asm_arm64_t *as, uint reg) {
+    // br rn
+    asm_arm64_op32(as, 0xd61f0000 | reg << 5);
+}
+
+void asm_arm64_call_ind(asm_arm64_t *as, uint fun_id) {
+    // ldr x16, [x22, #fun_id*8]; blr x16
+    asm_arm64_ldr_reg_reg_offset(as, 3, ASM_ARM64_REG_SCRATCH, ASM_ARM64_REG_FUN_TABLE, fun_id * WORD_SIZE);
+    asm_arm64_op32(as, 0xd63f0000 | ASM_ARM64_REG_SCRATCH << 5);
+}
+
+#endif // MICROPY_EMIT_ARM64
@@ -0,0 +1,219 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013, 2014 Damien P. George
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_PY_ASMARM64_H
+#define MICROPY_INCLUDED_PY_ASMARM64_H
+
+#include "py/misc.h"
+#include "py/asmbase.h"
+
+#define ASM_ARM64_REG_X0  (0)
+#define ASM_ARM64_REG_X1  (1)
+#define ASM_ARM64_REG_X2  (2)
+#define ASM_ARM64_REG_X3  (3)
+#define ASM_ARM64_REG_X4  (4)
+#define ASM_ARM64_REG_X5  (5)
+#define ASM_ARM64_REG_X6  (6)
+#define ASM_ARM64_REG_X7  (7)
+#define ASM_ARM64_REG_X16 (16)
+#define ASM_ARM64_REG_X17 (17)
+#define ASM_ARM64_REG_X19 (19)
+#define ASM_ARM64_REG_X20 (20)
+#define ASM_ARM64_REG_X21 (21)
+#define ASM_ARM64_REG_X22 (22)
+#define ASM_ARM64_REG_FP  (29)
+#define ASM_ARM64_REG_LR  (30)
+#define ASM_ARM64_REG_SP  (31) // as a base register or in add/sub immediate
+#define ASM_ARM64_REG_XZR (31) // everywhere else
+
+#define ASM_ARM64_CC_EQ (0x0)
+#define ASM_ARM64_CC_NE (0x1)
+#define ASM_ARM64_CC_CS (0x2)
+#define ASM_ARM64_CC_CC (0x3)
+#define ASM_ARM64_CC_MI (0x4)
+#define ASM_ARM64_CC_PL (0x5)
+#define ASM_ARM64_CC_VS (0x6)
+#define ASM_ARM64_CC_VC (0x7)
+#define ASM_ARM64_CC_HI (0x8)
+#define ASM_ARM64_CC_LS (0x9)
+#define ASM_ARM64_CC_GE (0xa)
+#define ASM_ARM64_CC_LT (0xb)
+#define ASM_ARM64_CC_GT (0xc)
+#define ASM_ARM64_CC_LE (0xd)
+#define ASM_ARM64_CC_AL (0xe)
+
+// Intra-procedure-call scratch register, used to hold addresses and large
+// offsets; it is never used to hold a value across generic API calls
+#define ASM_ARM64_REG_SCRATCH ASM_ARM64_REG_X16
+
+typedef struct _asm_arm64_t {
+    mp_asm_base_t base;
+    uint stack_adjust;
+} asm_arm64_t;
+
+static inline void asm_arm64_end_pass(asm_arm64_t *as) {
+    (void)as;
+}
+
+void asm_arm64_entry(asm_arm64_t *as, int num_locals);
+void asm_arm64_exit(asm_arm64_t *as);
+
+void asm_arm64_op32(asm_arm64_t *as, uint32_t op);
+
+// mov
+void asm_arm64_mov_reg_reg(asm_arm64_t *as, uint reg_dest, uint reg_src);
+void asm_arm64_mov_reg_i64_optimised(asm_arm64_t *as, uint reg_dest, uint64_t imm);
+void asm_arm64_mov_local_reg(asm_arm64_t *as, int local_num, uint reg_src);
+void asm_arm64_mov_reg_local(asm_arm64_t *as, uint reg_dest, int local_num);
+void asm_arm64_mov_reg_local_addr(asm_arm64_t *as, uint reg_dest, int local_num);
+void asm_arm64_mov_reg_pcrel(asm_arm64_t *as, uint reg_dest, uint label);
+void asm_arm64_cset_reg(asm_arm64_t *as, uint reg_dest, uint cond);
+
+// compare
+void asm_arm64_cmp_reg_reg(asm_arm64_t *as, uint reg_src1, uint reg_src2);
+void asm_arm64_tst_reg_u8(asm_arm64_t *as, uint reg_src);
+
+// arithmetic, all three-operand in 64-bit registers
+void asm_arm64_mvn_reg_reg(asm_arm64_t *as, uint rd, uint rm);
+void asm_arm64_neg_reg_reg(asm_arm64_t *as, uint rd, uint rm);
+void asm_arm64_add_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_sub_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_mul_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_and_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_eor_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_orr_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_lsl_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_lsr_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+void asm_arm64_asr_reg_reg_reg(asm_arm64_t *as, uint rd, uint rn, uint rm);
+
+// memory; size_log2 selects 8, 16, 32 or 64-bit access (narrow loads zero-extend)
+void asm_arm64_ldr_reg_reg_offset(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint byte_offset);
+void asm_arm64_str_reg_reg_offset(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint byte_offset);
+// load/store to array, index register scaled by access size
+void asm_arm64_ldr_reg_reg_reg(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint rm);
+void asm_arm64_str_reg_reg_reg(asm_arm64_t *as, uint size_log2, uint rt, uint rn, uint rm);
+
+// control flow
+void asm_arm64_b_label(asm_arm64_t *as, uint label);
+void asm_arm64_bcc_label(asm_arm64_t *as, uint cond, uint label);
+void asm_arm64_cbz_reg_label(asm_arm64_t *as, bool nonzero, uint reg, uint label);
+void asm_arm64_br_reg(asm_arm64_t *as, uint reg);
+void asm_arm64_call_ind(asm_arm64_t *as, uint fun_id);
+
+// Holds a pointer to mp_fun_table
+#define ASM_ARM64_REG_FUN_TABLE ASM_ARM64_REG_X22
+
+#if GENERIC_ASM_API
+
+// The following macros provide a (mostly) arch-independent API to
+// generate native code, and are used by the native emitter.
+
+#define ASM_WORD_SIZE (8)
+
+#define REG_RET ASM_ARM64_REG_X0
+#define REG_ARG_1 ASM_ARM64_REG_X0
+#define REG_ARG_2 ASM_ARM64_REG_X1
+#define REG_ARG_3 ASM_ARM64_REG_X2
+#define REG_ARG_4 ASM_ARM64_REG_X3
+
+#define REG_TEMP0 ASM_ARM64_REG_X0
+#define REG_TEMP1 ASM_ARM64_REG_X1
+#define REG_TEMP2 ASM_ARM64_REG_X2
+
+#define REG_LOCAL_1 ASM_ARM64_REG_X19
+#define REG_LOCAL_2 ASM_ARM64_REG_X20
+#define REG_LOCAL_3 ASM_ARM64_REG_X21
+#define REG_LOCAL_NUM (3)
+
+// Holds a pointer to mp_fun_table
+#define REG_FUN_TABLE ASM_ARM64_REG_FUN_TABLE
+
+#define ASM_T               asm_arm64_t
+#define ASM_END_PASS        asm_arm64_end_pass
+#define ASM_ENTRY           asm_arm64_entry
+#define ASM_EXIT            asm_arm64_exit
+
+#define ASM_JUMP            asm_arm64_b_label
+#define ASM_JUMP_IF_REG_ZERO(as, reg, label, bool_test) \
+    do { \
+        if (bool_test) { \
+            asm_arm64_tst_reg_u8((as), (reg)); \
+            asm_arm64_bcc_label((as), ASM_ARM64_CC_EQ, (label)); \
+        } else { \
+            asm_arm64_cbz_reg_label((as), false, (reg), (label)); \
+        } \
+    } while (0)
+#define ASM_JUMP_IF_REG_NONZERO(as, reg, label, bool_test) \
+    do { \
+        if (bool_test) { \
+            asm_arm64_tst_reg_u8((as), (reg)); \
+            asm_arm64_bcc_label((as), ASM_ARM64_CC_NE, (label)); \
+        } else { \
+            asm_arm64_cbz_reg_label((as), true, (reg), (label)); \
+        } \
+    } while (0)
+#define ASM_JUMP_IF_REG_EQ(as, reg1, reg2, label) \
+    do { \
+        asm_arm64_cmp_reg_reg((as), (reg1), (reg2)); \
+        asm_arm64_bcc_label((as), ASM_ARM64_CC_EQ, (label)); \
+    } while (0)
+#define ASM_JUMP_REG(as, reg) asm_arm64_br_reg((as), (reg))
+#define ASM_CALL_IND(as, idx) asm_arm64_call_ind((as), (idx))
+
+#define ASM_MOV_LOCAL_REG(as, local_num, reg_src) asm_arm64_mov_local_reg((as), (local_num), (reg_src))
+#define ASM_MOV_REG_IMM(as, reg_dest, imm) asm_arm64_mov_reg_i64_optimised((as), (reg_dest), (imm))
+#define ASM_MOV_REG_LOCAL(as, reg_dest, local_num) asm_arm64_mov_reg_local((as), (reg_dest), (local_num))
+#define ASM_MOV_REG_REG(as, reg_dest, reg_src) asm_arm64_mov_reg_reg((as), (reg_dest), (reg_src))
+#define ASM_MOV_REG_LOCAL_ADDR(as, reg_dest, local_num) asm_arm64_mov_reg_local_addr((as), (reg_dest), (local_num))
+#define ASM_MOV_REG_PCREL(as, reg_dest, label) asm_arm64_mov_reg_pcrel((as), (reg_dest), (label))
+
+#define ASM_NOT_REG(as, reg_dest) asm_arm64_mvn_reg_reg((as), (reg_dest), (reg_dest))
+#define ASM_NEG_REG(as, reg_dest) asm_arm64_neg_reg_reg((as), (reg_dest), (reg_dest))
+#define ASM_LSL_REG_REG(as, reg_dest, reg_shift) asm_arm64_lsl_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_shift))
+#define ASM_LSR_REG_REG(as, reg_dest, reg_shift) asm_arm64_lsr_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_shift))
+#define ASM_ASR_REG_REG(as, reg_dest, reg_shift) asm_arm64_asr_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_shift))
+#define ASM_OR_REG_REG(as, reg_dest, reg_src) asm_arm64_orr_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+#define ASM_XOR_REG_REG(as, reg_dest, reg_src) asm_arm64_eor_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+#define ASM_AND_REG_REG(as, reg_dest, reg_src) asm_arm64_and_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+#define ASM_ADD_REG_REG(as, reg_dest, reg_src) asm_arm64_add_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+#define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_arm64_sub_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+#define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_arm64_mul_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+
+#define ASM_LOAD_REG_REG(as, reg_dest, reg_base) asm_arm64_ldr_reg_reg_offset((as), 3, (reg_dest), (reg_base), 0)
+#define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, word_offset) asm_arm64_ldr_reg_reg_offset((as), 3, (reg_dest), (reg_base), 8 * (word_offset))
+#define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_arm64_ldr_reg_reg_offset((as), 0, (reg_dest), (reg_base), 0)
+#define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_arm64_ldr_reg_reg_offset((as), 1, (reg_dest), (reg_base), 0)
+#define ASM_LOAD16_REG_REG_OFFSET(as, reg_dest, reg_base, uint16_offset) asm_arm64_ldr_reg_reg_offset((as), 1, (reg_dest), (reg_base), 2 * (uint16_offset))
+#define ASM_LOAD32_REG_REG(as, reg_dest, reg_base) asm_arm64_ldr_reg_reg_offset((as), 2, (reg_dest), (reg_base), 0)
+
+#define ASM_STORE_REG_REG(as, reg_src, reg_base) asm_arm64_str_reg_reg_offset((as), 3, (reg_src), (reg_base), 0)
+#define ASM_STORE_REG_REG_OFFSET(as, reg_src, reg_base, word_offset) asm_arm64_str_reg_reg_offset((as), 3, (reg_src), (reg_base), 8 * (word_offset))
+#define ASM_STORE8_REG_REG(as, reg_src, reg_base) asm_arm64_str_reg_reg_offset((as), 0, (reg_src), (reg_base), 0)
+#define ASM_STORE16_REG_REG(as, reg_src, reg_base) asm_arm64_str_reg_reg_offset((as), 1, (reg_src), (reg_base), 0)
+#define ASM_STORE32_REG_REG(as, reg_src, reg_base) asm_arm64_str_reg_reg_offset((as), 2, (reg_src), (reg_base), 0)
+
+#endif // GENERIC_ASM_API
+
+#endif // MICROPY_INCLUDED_PY_ASMARM64_H
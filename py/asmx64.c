@@ -539,19 +539,29 @@ void asm_x64_jcc_label(asm_x64_t *as, int jcc_type, mp_uint_t label) {
     }
 }
 
-void asm_x64_entry(asm_x64_t *as, int num_locals) {
+void asm_x64_entry(asm_x64_t *as, int num_locals, bool save_r14_r15) {
     assert(num_locals >= 0);
     asm_x64_push_r64(as, ASM_X64_REG_RBP);
     asm_x64_push_r64(as, ASM_X64_REG_RBX);
     asm_x64_push_r64(as, ASM_X64_REG_R12);
     asm_x64_push_r64(as, ASM_X64_REG_R13);
+    if (save_r14_r15) {
+        // pushed as a pair so the stack alignment below is unchanged
+        asm_x64_push_r64(as, ASM_X64_REG_R14);
+        asm_x64_push_r64(as, ASM_X64_REG_R15);
+    }
     num_locals |= 1; // make it odd so stack is aligned on 16 byte boundary
     asm_x64_sub_r64_i32(as, ASM_X64_REG_RSP, num_locals * WORD_SIZE);
     as->num_locals = num_locals;
+    as->saved_r14_r15 = save_r14_r15;
 }
 
 void asm_x64_exit(asm_x64_t *as) {
     asm_x64_sub_r64_i32(as, ASM_X64_REG_RSP, -as->num_locals * WORD_SIZE);
+    if (as->saved_r14_r15) {
+        asm_x64_pop_r64(as, ASM_X64_REG_R15);
+        asm_x64_pop_r64(as, ASM_X64_REG_R14);
+    }
     asm_x64_pop_r64(as, ASM_X64_REG_R13);
     asm_x64_pop_r64(as, ASM_X64_REG_R12);
     asm_x64_pop_r64(as, ASM_X64_REG_RBX);
@@ -76,6 +76,7 @@
 typedef struct _asm_x64_t {
     mp_asm_base_t base;
     int num_locals;
+    bool saved_r14_r15;
 } asm_x64_t;
 
 static inline void asm_x64_end_pass(asm_x64_t *as) {
@@ -115,7 +116,7 @@ void asm_x64_setcc_r8(asm_x64_t *as, int jcc_type, int dest_r8);
 void asm_x64_jmp_reg(asm_x64_t *as, int src_r64);
 void asm_x64_jmp_label(asm_x64_t *as, mp_uint_t label);
 void asm_x64_jcc_label(asm_x64_t *as, int jcc_type, mp_uint_t label);
-void asm_x64_entry(asm_x64_t *as, int num_locals);
+void asm_x64_entry(asm_x64_t *as, int num_locals, bool save_r14_r15);
 void asm_x64_exit(asm_x64_t *as);
 void asm_x64_mov_local_to_r64(asm_x64_t *as, int src_local_num, int dest_r64);
 void asm_x64_mov_r64_to_local(asm_x64_t *as, int src_r64, int dest_local_num);
@@ -151,12 +152,16 @@ void asm_x64_call_ind(asm_x64_t *as, size_t fun_id, int temp_r32);
 #define REG_LOCAL_3 ASM_X64_REG_R13
 #define REG_LOCAL_NUM (3)
 
+// callee-save, only saved on entry when viper allocates locals to them
+#define REG_LOCAL_EXTRA_1 ASM_X64_REG_R14
+#define REG_LOCAL_EXTRA_2 ASM_X64_REG_R15
+
 // Holds a pointer to mp_fun_table
 #define REG_FUN_TABLE ASM_X64_REG_FUN_TABLE
 
 #define ASM_T               asm_x64_t
 #define ASM_END_PASS        asm_x64_end_pass
-#define ASM_ENTRY           asm_x64_entry
+#define ASM_ENTRY(as, num_locals) asm_x64_entry((as), (num_locals), false)
 #define ASM_EXIT            asm_x64_exit
 
 #define ASM_JUMP            asm_x64_jmp_label
@@ -332,6 +332,132 @@ void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw
     mp_setup_code_state_helper(code_state, n_args, n_kw, args);
 }
 
+// Get the source file, the block name and (returned) the source line of the
+// instruction at ip within the given bytecode function.
+size_t mp_bytecode_get_source_info(const mp_obj_fun_bc_t *fun_bc, const byte *ip, qstr *source_file, qstr *block_name) {
+    const byte *bc_ip = ip;
+    ip = fun_bc->bytecode;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    const byte *line_info_top = ip + n_info;
+    const byte *bytecode_start = ip + n_info + n_cell;
+    size_t bc = bc_ip - bytecode_start;
+    qstr block = mp_decode_uint_value(ip);
+    for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
+        ip = mp_decode_uint_skip(ip);
+    }
+    #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+    *block_name = fun_bc->context->constants.qstr_table[block];
+    *source_file = fun_bc->context->constants.qstr_table[0];
+    #else
+    *block_name = block;
+    *source_file = fun_bc->context->constants.source_file;
+    #endif
+    return mp_bytecode_get_source_line(ip, line_info_top, bc);
+}
+
+#if MICROPY_OPT_INLINE_CACHE
+// Allocates an inline cache for the given bytecode, sized for the number of
+// instructions that use it, or returns NULL if there are none.
+mp_inline_cache_t *mp_inline_cache_new(const byte *code, size_t len) {
+    const byte *ip = code;
+    const byte *top = code + len;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    ip += n_info + n_cell;
+    size_t n = 0;
+    while (ip < top) {
+        byte op = *ip++;
+        if (op == MP_BC_LOAD_GLOBAL || op == MP_BC_LOAD_ATTR || op == MP_BC_LOAD_METHOD) {
+            ++n;
+        }
+        switch (MP_BC_FORMAT(op)) {
+            case MP_BC_FORMAT_QSTR:
+            case MP_BC_FORMAT_VAR_UINT:
+                ip = mp_decode_uint_skip(ip);
+                break;
+            case MP_BC_FORMAT_OFFSET:
+                ip += 1 + ((*ip & 0x80) != 0);
+                break;
+        }
+        if ((op & MP_BC_MASK_EXTRA_BYTE) == 0) {
+            ++ip;
+        }
+    }
+    assert(ip == top);
+    if (n == 0) {
+        return NULL;
+    }
+
+    // keep the load factor at most 2/3, so probe sequences stay short
+    size_t n_slots = 2;
+    while (n_slots < n + n / 2) {
+        n_slots *= 2;
+    }
+    mp_inline_cache_t *cache = m_new_obj_var0(mp_inline_cache_t, entry, const mp_inline_cache_entry_t *, n_slots);
+    cache->mask = n_slots - 1;
+    return cache;
+}
+#endif
+
+#if MICROPY_OPT_QUICKEN_BINARY_OP
+const byte mp_bc_binary_op_quick_generic[MP_BC_BINARY_OP_QUICK_MULTI_NUM] = {
+    MP_BINARY_OP_ADD,
+    MP_BINARY_OP_INPLACE_ADD,
+    MP_BINARY_OP_SUBTRACT,
+    MP_BINARY_OP_MULTIPLY,
+    MP_BINARY_OP_LESS,
+    MP_BINARY_OP_MORE,
+    MP_BINARY_OP_EQUAL,
+    MP_BINARY_OP_ADD,
+    MP_BINARY_OP_SUBTRACT,
+    MP_BINARY_OP_MULTIPLY,
+    MP_BINARY_OP_TRUE_DIVIDE,
+    MP_BINARY_OP_LESS,
+    MP_BINARY_OP_MORE,
+    MP_BINARY_OP_ADD,
+};
+
+// Returns the opcode to use for the given op on operands like the given ones:
+// a quickened opcode if there is one for these operand types, otherwise the
+// generic opcode.
+static byte binary_op_quick_opcode(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs) {
+    size_t start, end;
+    if (mp_obj_is_small_int(lhs) && mp_obj_is_small_int(rhs)) {
+        start = MP_BC_BINARY_OP_INT_ADD;
+        end = MP_BC_BINARY_OP_FLOAT_ADD;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    } else if ((mp_obj_is_float(lhs) || mp_obj_is_small_int(lhs))
+               && (mp_obj_is_float(rhs) || mp_obj_is_small_int(rhs))) {
+        start = MP_BC_BINARY_OP_FLOAT_ADD;
+        end = MP_BC_BINARY_OP_STR_ADD;
+    #endif
+    } else if (mp_obj_is_str(lhs) && mp_obj_is_str(rhs)) {
+        start = MP_BC_BINARY_OP_STR_ADD;
+        end = MP_BC_BINARY_OP_QUICK_MULTI + MP_BC_BINARY_OP_QUICK_MULTI_NUM;
+    } else {
+        return MP_BC_BINARY_OP_MULTI + op;
+    }
+    for (size_t i = start; i < end; ++i) {
+        if (mp_bc_binary_op_quick_generic[i - MP_BC_BINARY_OP_QUICK_MULTI] == op) {
+            return i;
+        }
+    }
+    return MP_BC_BINARY_OP_MULTI + op;
+}
+
+// Performs the given op, first rewriting the BINARY_OP opcode at *opcode to
+// suit the types of the operands.  This is kept out of the VM loop so that the
+// operands don't linger in its stack frame, where the GC would find them.
+mp_obj_t mp_bc_binary_op_quicken(byte *opcode, mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs) {
+    byte quick_op = binary_op_quick_opcode(op, lhs, rhs);
+    if (quick_op != *opcode) {
+        *opcode = quick_op;
+    }
+    return mp_binary_op(op, lhs, rhs);
+}
+#endif
+
 #if MICROPY_EMIT_NATIVE
 // On entry code_state should be allocated somewhere (stack/heap) and
 // contain the following valid entries:
@@ -218,6 +218,7 @@ typedef struct _mp_compiled_module_t {
     const struct _mp_raw_code_t *rc;
     #if MICROPY_PERSISTENT_CODE_SAVE
     bool has_native;
+    bool has_superinstructions;
     size_t n_qstr;
     size_t n_obj;
     #endif
@@ -273,6 +274,63 @@ mp_uint_t mp_decode_uint(const byte **ptr);
 mp_uint_t mp_decode_uint_value(const byte *ptr);
 const byte *mp_decode_uint_skip(const byte *ptr);
 
+#if MICROPY_OPT_INLINE_CACHE
+// Where a LOAD_GLOBAL, LOAD_ATTR or LOAD_METHOD instruction last found its
+// name.  Entries are immutable once published in a cache so that threads
+// without a GIL always see a consistent entry.
+typedef struct _mp_inline_cache_entry_t {
+    // Type of the object the attribute was loaded from, NULL for globals.
+    const mp_obj_type_t *type;
+    // For class attributes, the locals map of the class that defines the
+    // attribute, and for builtins the builtins map.  NULL when the name is
+    // in the object's own map (or for globals, the globals map).
+    mp_map_t *map;
+    // Value of MP_STATE_VM(inline_cache_epoch) for class attributes.
+    size_t epoch;
+    // Offset of the instruction within its function's bytecode.
+    uint32_t offset;
+    // Index of the name in the map's table.
+    uint16_t index;
+    // How many times this instruction has had its entry replaced.
+    uint16_t fills;
+} mp_inline_cache_entry_t;
+
+typedef struct _mp_inline_cache_t {
+    size_t mask;
+    const mp_inline_cache_entry_t *entry[];
+} mp_inline_cache_t;
+
+mp_inline_cache_t *mp_inline_cache_new(const byte *code, size_t len);
+
+// Gets the slot for the instruction at the given offset, which holds either
+// this instruction's entry or NULL.  Returns NULL if the cache is full.
+static inline const mp_inline_cache_entry_t **mp_inline_cache_slot(mp_inline_cache_t *cache, size_t offset) {
+    for (size_t i = 0; i <= cache->mask; ++i) {
+        const mp_inline_cache_entry_t **slot = &cache->entry[(offset + i) & cache->mask];
+        if (*slot == NULL || (*slot)->offset == offset) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+#endif
+
+#if MICROPY_OPT_QUICKEN_BINARY_OP
+// The generic op for each quickened BINARY_OP opcode, indexed from
+// MP_BC_BINARY_OP_QUICK_MULTI.
+extern const byte mp_bc_binary_op_quick_generic[];
+
+// The set of ops that have at least one quickened opcode, so that the VM can
+// skip trying to quicken all other ops.
+#define MP_BC_BINARY_OP_QUICKEN_OPS ( \
+    1ULL << MP_BINARY_OP_LESS | 1ULL << MP_BINARY_OP_MORE \
+    | 1ULL << MP_BINARY_OP_EQUAL | 1ULL << MP_BINARY_OP_INPLACE_ADD \
+    | 1ULL << MP_BINARY_OP_ADD | 1ULL << MP_BINARY_OP_SUBTRACT \
+    | 1ULL << MP_BINARY_OP_MULTIPLY | 1ULL << MP_BINARY_OP_TRUE_DIVIDE)
+
+mp_obj_t mp_bc_binary_op_quicken(byte *opcode, mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs);
+#endif
+
 mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state,
 #ifndef __cplusplus
     volatile
@@ -281,6 +339,7 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state,
 mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t func, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state_native(mp_code_state_native_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
+size_t mp_bytecode_get_source_info(const struct _mp_obj_fun_bc_t *fun_bc, const byte *ip, qstr *source_file, qstr *block_name);
 void mp_bytecode_print(const mp_print_t *print, const struct _mp_raw_code_t *rc, size_t fun_data_len, const mp_module_constants_t *cm);
 void mp_bytecode_print2(const mp_print_t *print, const byte *ip, size_t len, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
 const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start, const byte *ip, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
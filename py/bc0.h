@@ -52,13 +52,13 @@
 #define MP_BC_FORMAT(op) ((0x000003a4 >> (2 * ((op) >> 4))) & 3)
 
 // Load, Store, Delete, Import, Make, Build, Unpack, Call, Jump, Exception, For, sTack, Return, Yield, Op
-#define MP_BC_BASE_RESERVED                 (0x00) // ----------------
+#define MP_BC_BASE_RESERVED                 (0x00) // --QQQQQQQQQQQQQQ
 #define MP_BC_BASE_QSTR_O                   (0x10) // LLLLLLSSSDDII---
 #define MP_BC_BASE_VINT_E                   (0x20) // MMLLLLSSDDBBBBBB
 #define MP_BC_BASE_VINT_O                   (0x30) // UUMMCCCC--------
-#define MP_BC_BASE_JUMP_E                   (0x40) // J-JJJJJEEEEF----
+#define MP_BC_BASE_JUMP_E                   (0x40) // JJJJJJJEEEEF----
 #define MP_BC_BASE_BYTE_O                   (0x50) // LLLLSSDTTTTTEEFF
-#define MP_BC_BASE_BYTE_E                   (0x60) // --BREEEYYI------
+#define MP_BC_BASE_BYTE_E                   (0x60) // OOBREEEYYI------
 #define MP_BC_LOAD_CONST_SMALL_INT_MULTI    (0x70) // LLLLLLLLLLLLLLLL
 //                                          (0x80) // LLLLLLLLLLLLLLLL
 //                                          (0x90) // LLLLLLLLLLLLLLLL
@@ -70,6 +70,7 @@
 //                                          (0xe0) // OOOOOOOOOOOOOOOO
 //                                          (0xf0) // OOOOOOOOOO------
 
+#define MP_BC_BINARY_OP_QUICK_MULTI_NUM     (14)
 #define MP_BC_LOAD_CONST_SMALL_INT_MULTI_NUM (64)
 #define MP_BC_LOAD_CONST_SMALL_INT_MULTI_EXCESS (16)
 #define MP_BC_LOAD_FAST_MULTI_NUM           (16)
@@ -159,4 +160,38 @@
 #define MP_BC_IMPORT_FROM                   (MP_BC_BASE_QSTR_O + 0x0c) // qstr
 #define MP_BC_IMPORT_STAR                   (MP_BC_BASE_BYTE_E + 0x09)
 
+// Superinstructions, each doing the work of a common sequence of opcodes.
+// These are emitted by the compiler with MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS.
+//  - INPLACE_ADD_FAST / INPLACE_SUBTRACT_FAST replace LOAD_FAST n, LOAD_CONST_SMALL_INT i,
+//    BINARY_OP +=/-=, STORE_FAST n; the extra byte is n << 4 | i, for n and i in 0-15
+//  - POP_JUMP_IF_COMPARE replaces BINARY_OP op, POP_JUMP_IF_TRUE/FALSE; the extra byte
+//    is op (a comparison), with 0x80 set to jump if true
+#define MP_BC_POP_JUMP_IF_COMPARE           (MP_BC_BASE_JUMP_E + 0x01) // signed relative bytecode offset; then a byte
+#define MP_BC_INPLACE_ADD_FAST              (MP_BC_BASE_BYTE_E + 0x00) // extra byte
+#define MP_BC_INPLACE_SUBTRACT_FAST         (MP_BC_BASE_BYTE_E + 0x01) // extra byte
+
+// Specialised ("quickened") forms of some BINARY_OP opcodes, for when both
+// operands are small ints, when they are floats or a float and a small int,
+// or when both are strs.  These are never emitted by the compiler, or stored
+// in .mpy files: with MICROPY_OPT_QUICKEN_BINARY_OP the VM writes them over
+// the generic opcode in bytecode that's in RAM, and writes the generic opcode
+// back when the operands have other types.  They take the 0x02-0x0f opcodes,
+// which like BINARY_OP are a single byte with no argument; 0x00 and 0x01 are
+// left invalid because their format would have an extra byte.
+#define MP_BC_BINARY_OP_QUICK_MULTI         (MP_BC_BASE_RESERVED + 0x02)
+#define MP_BC_BINARY_OP_INT_ADD             (MP_BC_BINARY_OP_QUICK_MULTI + 0x00)
+#define MP_BC_BINARY_OP_INT_INPLACE_ADD     (MP_BC_BINARY_OP_QUICK_MULTI + 0x01)
+#define MP_BC_BINARY_OP_INT_SUBTRACT        (MP_BC_BINARY_OP_QUICK_MULTI + 0x02)
+#define MP_BC_BINARY_OP_INT_MULTIPLY        (MP_BC_BINARY_OP_QUICK_MULTI + 0x03)
+#define MP_BC_BINARY_OP_INT_LESS            (MP_BC_BINARY_OP_QUICK_MULTI + 0x04)
+#define MP_BC_BINARY_OP_INT_MORE            (MP_BC_BINARY_OP_QUICK_MULTI + 0x05)
+#define MP_BC_BINARY_OP_INT_EQUAL           (MP_BC_BINARY_OP_QUICK_MULTI + 0x06)
+#define MP_BC_BINARY_OP_FLOAT_ADD           (MP_BC_BINARY_OP_QUICK_MULTI + 0x07)
+#define MP_BC_BINARY_OP_FLOAT_SUBTRACT      (MP_BC_BINARY_OP_QUICK_MULTI + 0x08)
+#define MP_BC_BINARY_OP_FLOAT_MULTIPLY      (MP_BC_BINARY_OP_QUICK_MULTI + 0x09)
+#define MP_BC_BINARY_OP_FLOAT_TRUE_DIVIDE   (MP_BC_BINARY_OP_QUICK_MULTI + 0x0a)
+#define MP_BC_BINARY_OP_FLOAT_LESS          (MP_BC_BINARY_OP_QUICK_MULTI + 0x0b)
+#define MP_BC_BINARY_OP_FLOAT_MORE          (MP_BC_BINARY_OP_QUICK_MULTI + 0x0c)
+#define MP_BC_BINARY_OP_STR_ADD             (MP_BC_BINARY_OP_QUICK_MULTI + 0x0d)
+
 #endif // MICROPY_INCLUDED_PY_BC0_H
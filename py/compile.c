@@ -102,6 +102,7 @@ static const emit_method_table_t *emit_native_table[] = {
     &emit_native_thumb_method_table,
     &emit_native_xtensa_method_table,
     &emit_native_xtensawin_method_table,
+    &emit_native_arm64_method_table,
 };
 
 #elif MICROPY_EMIT_NATIVE
@@ -114,6 +115,8 @@ static const emit_method_table_t *emit_native_table[] = {
 #define NATIVE_EMITTER(f) emit_native_thumb_##f
 #elif MICROPY_EMIT_ARM
 #define NATIVE_EMITTER(f) emit_native_arm_##f
+#elif MICROPY_EMIT_ARM64
+#define NATIVE_EMITTER(f) emit_native_arm64_##f
 #elif MICROPY_EMIT_XTENSA
 #define NATIVE_EMITTER(f) emit_native_xtensa_##f
 #elif MICROPY_EMIT_XTENSAWIN
@@ -1037,12 +1040,18 @@ static void compile_return_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
         mp_parse_node_struct_t *pns_test_if_expr = (mp_parse_node_struct_t *)pns->nodes[0];
         mp_parse_node_struct_t *pns_test_if_else = (mp_parse_node_struct_t *)pns_test_if_expr->nodes[1];
 
-        uint l_fail = comp_next_label(comp);
-        c_if_cond(comp, pns_test_if_else->nodes[0], false, l_fail); // condition
-        compile_node(comp, pns_test_if_expr->nodes[0]); // success value
-        EMIT(return_value);
-        EMIT_ARG(label_assign, l_fail);
-        compile_node(comp, pns_test_if_else->nodes[1]); // failure value
+        if (mp_parse_node_is_const_true(pns_test_if_else->nodes[0])
+            || mp_parse_node_is_const_false(pns_test_if_else->nodes[0])) {
+            // constant condition, only the selected value is compiled
+            compile_node(comp, pns->nodes[0]);
+        } else {
+            uint l_fail = comp_next_label(comp);
+            c_if_cond(comp, pns_test_if_else->nodes[0], false, l_fail); // condition
+            compile_node(comp, pns_test_if_expr->nodes[0]); // success value
+            EMIT(return_value);
+            EMIT_ARG(label_assign, l_fail);
+            compile_node(comp, pns_test_if_else->nodes[1]); // failure value
+        }
     } else {
         compile_node(comp, pns->nodes[0]);
     }
@@ -1294,6 +1303,11 @@ static void compile_assert_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
         return;
     }
 
+    // optimisation: don't emit anything for an assertion that always passes
+    if (mp_parse_node_is_const_true(pns->nodes[0])) {
+        return;
+    }
+
     uint l_end = comp_next_label(comp);
     c_if_cond(comp, pns->nodes[0], true, l_end);
     EMIT_LOAD_GLOBAL(MP_QSTR_AssertionError); // we load_global instead of load_id, to be consistent with CPython
@@ -2117,6 +2131,15 @@ static void compile_test_if_expr(compiler_t *comp, mp_parse_node_struct_t *pns)
     assert(MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_test_if_else));
     mp_parse_node_struct_t *pns_test_if_else = (mp_parse_node_struct_t *)pns->nodes[1];
 
+    // optimisation: only compile the value that is selected by a constant condition
+    if (mp_parse_node_is_const_true(pns_test_if_else->nodes[0])) {
+        compile_node(comp, pns->nodes[0]);
+        return;
+    } else if (mp_parse_node_is_const_false(pns_test_if_else->nodes[0])) {
+        compile_node(comp, pns_test_if_else->nodes[1]);
+        return;
+    }
+
     uint l_fail = comp_next_label(comp);
     uint l_end = comp_next_label(comp);
     c_if_cond(comp, pns_test_if_else->nodes[0], false, l_fail); // condition
@@ -3620,6 +3643,11 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
         cm->has_native = true;
     }
     #endif
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS && MICROPY_DYNAMIC_COMPILER
+    cm->has_superinstructions = mp_dynamic_compiler.bytecode_superinstructions;
+    #else
+    cm->has_superinstructions = MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS;
+    #endif
     cm->n_qstr = comp->emit_common.qstr_map.used;
     cm->n_obj = comp->emit_common.const_obj_list.len;
     #endif
@@ -73,8 +73,25 @@ struct _emit_t {
 
     size_t n_info;
     size_t n_cell;
+
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    // The most recent one-byte opcodes and their offsets (entry 0 is the last
+    // one), and the offset before which opcodes can't be fused with later ones
+    // because a label or source line boundary follows them.
+    byte recent_op[3];
+    size_t recent_op_offset[3];
+    size_t fuse_barrier;
+    #endif
 };
 
+#if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+#if MICROPY_DYNAMIC_COMPILER
+#define EMIT_SUPERINSTRUCTIONS (mp_dynamic_compiler.bytecode_superinstructions)
+#else
+#define EMIT_SUPERINSTRUCTIONS (1)
+#endif
+#endif
+
 emit_t *emit_bc_new(mp_emit_common_t *emit_common) {
     emit_t *emit = m_new0(emit_t, 1);
     emit->emit_common = emit_common;
@@ -166,10 +183,38 @@ static void emit_write_bytecode_raw_byte(emit_t *emit, byte b1) {
 
 static void emit_write_bytecode_byte(emit_t *emit, int stack_adj, byte b1) {
     mp_emit_bc_adjust_stack_size(emit, stack_adj);
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    if (!emit->suppress) {
+        emit->recent_op[2] = emit->recent_op[1];
+        emit->recent_op[1] = emit->recent_op[0];
+        emit->recent_op[0] = b1;
+        emit->recent_op_offset[2] = emit->recent_op_offset[1];
+        emit->recent_op_offset[1] = emit->recent_op_offset[0];
+        emit->recent_op_offset[0] = emit->bytecode_offset;
+    }
+    #endif
     byte *c = emit_get_cur_to_write_bytecode(emit, 1);
     c[0] = b1;
 }
 
+#if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+// Returns true if the last n opcodes were each one byte long with no argument
+// (so are recent_op[0..n-1]), they end at the current offset and nothing
+// can jump or assign a line number to a point between them.  If so they can
+// be replaced with a superinstruction by moving back bytecode_offset.
+static bool emit_can_fuse(emit_t *emit, size_t n) {
+    if (!EMIT_SUPERINSTRUCTIONS || emit->suppress || emit->bytecode_offset < emit->fuse_barrier + n) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (emit->recent_op_offset[i] != emit->bytecode_offset - 1 - i) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 // Similar to mp_encode_uint(), just some extra handling to encode sign
 static void emit_write_bytecode_byte_int(emit_t *emit, int stack_adj, byte b1, mp_int_t num) {
     emit_write_bytecode_byte(emit, stack_adj, b1);
@@ -290,6 +335,9 @@ void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     emit->bytecode_offset = 0;
     emit->code_info_offset = 0;
     emit->overflow = false;
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    emit->fuse_barrier = 0;
+    #endif
 
     // Write local state size, exception stack size, scope flags and number of arguments
     {
@@ -393,7 +441,7 @@ bool mp_emit_bc_end_pass(emit_t *emit) {
             mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("bytecode overflow"));
         }
 
-        #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_DEBUG_PRINTERS
+        #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_OPT_INLINE_CACHE || MICROPY_DEBUG_PRINTERS
         size_t bytecode_len = emit->code_info_size + emit->bytecode_size;
         #if MICROPY_DEBUG_PRINTERS
         emit->scope->raw_code_data_len = bytecode_len;
@@ -403,8 +451,10 @@ bool mp_emit_bc_end_pass(emit_t *emit) {
         // Bytecode is finalised, assign it to the raw code object.
         mp_emit_glue_assign_bytecode(emit->scope->raw_code, emit->code_base,
             emit->emit_common->children,
-            #if MICROPY_PERSISTENT_CODE_SAVE
+            #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_OPT_INLINE_CACHE
             bytecode_len,
+            #endif
+            #if MICROPY_PERSISTENT_CODE_SAVE
             emit->emit_common->ct_cur_child,
             #endif
             emit->scope->scope_flags);
@@ -436,6 +486,9 @@ void mp_emit_bc_set_source_line(emit_t *emit, mp_uint_t source_line) {
         emit_write_code_info_bytes_lines(emit, bytes_to_skip, lines_to_skip);
         emit->last_source_line_offset = emit->bytecode_offset;
         emit->last_source_line = source_line;
+        #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+        emit->fuse_barrier = emit->bytecode_offset;
+        #endif
     }
     #else
     (void)emit;
@@ -461,6 +514,9 @@ void mp_emit_bc_label_assign(emit_t *emit, mp_uint_t l) {
 
     // Assign label offset.
     emit->label_offsets[l] = emit->bytecode_offset;
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    emit->fuse_barrier = emit->bytecode_offset;
+    #endif
 }
 
 void mp_emit_bc_import(emit_t *emit, qstr qst, int kind) {
@@ -562,6 +618,24 @@ void mp_emit_bc_store_local(emit_t *emit, qstr qst, mp_uint_t local_num, int kin
     MP_STATIC_ASSERT(MP_BC_STORE_FAST_N + MP_EMIT_IDOP_LOCAL_FAST == MP_BC_STORE_FAST_N);
     MP_STATIC_ASSERT(MP_BC_STORE_FAST_N + MP_EMIT_IDOP_LOCAL_DEREF == MP_BC_STORE_DEREF);
     (void)qst;
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    // Fuse "n += i" and "n -= i" for small n and i into one opcode
+    if (kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15 && emit_can_fuse(emit, 3)
+        && emit->recent_op[2] == MP_BC_LOAD_FAST_MULTI + local_num
+        && emit->recent_op[1] >= MP_BC_LOAD_CONST_SMALL_INT_MULTI + MP_BC_LOAD_CONST_SMALL_INT_MULTI_EXCESS
+        && emit->recent_op[1] < MP_BC_LOAD_CONST_SMALL_INT_MULTI + MP_BC_LOAD_CONST_SMALL_INT_MULTI_EXCESS + 16
+        && (emit->recent_op[0] == MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_INPLACE_ADD
+            || emit->recent_op[0] == MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_INPLACE_SUBTRACT)) {
+        byte op = emit->recent_op[0] == MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_INPLACE_ADD
+            ? MP_BC_INPLACE_ADD_FAST : MP_BC_INPLACE_SUBTRACT_FAST;
+        byte arg = local_num << 4
+            | (emit->recent_op[1] - MP_BC_LOAD_CONST_SMALL_INT_MULTI - MP_BC_LOAD_CONST_SMALL_INT_MULTI_EXCESS);
+        emit->bytecode_offset -= 3;
+        emit_write_bytecode_byte(emit, -1, op);
+        emit_write_bytecode_raw_byte(emit, arg);
+        return;
+    }
+    #endif
     if (kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15) {
         emit_write_bytecode_byte(emit, -1, MP_BC_STORE_FAST_MULTI + local_num);
     } else {
@@ -614,6 +688,18 @@ void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
 }
 
 void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    // Fuse a comparison with the conditional jump that follows it
+    if (emit_can_fuse(emit, 1)
+        && emit->recent_op[0] >= MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_LESS
+        && emit->recent_op[0] <= MP_BC_BINARY_OP_MULTI + MP_BINARY_OP_NOT_EQUAL) {
+        byte op = emit->recent_op[0] - MP_BC_BINARY_OP_MULTI;
+        emit->bytecode_offset -= 1;
+        emit_write_bytecode_byte_label(emit, -1, MP_BC_POP_JUMP_IF_COMPARE, label);
+        emit_write_bytecode_raw_byte(emit, (cond ? 0x80 : 0) | op);
+        return;
+    }
+    #endif
     if (cond) {
         emit_write_bytecode_byte_label(emit, -1, MP_BC_POP_JUMP_IF_TRUE, label);
     } else {
@@ -25,6 +25,7 @@
  */
 
 #include <assert.h>
+#include <math.h>
 
 #include "py/emit.h"
 #include "py/nativeglue.h"
@@ -71,6 +72,13 @@ static bool strictly_equal(mp_obj_t a, mp_obj_t b) {
             }
         }
         return true;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    } else if (a_type == &mp_type_float) {
+        // 0.0 and -0.0 compare equal but are different constants
+        mp_float_t a_val = mp_obj_float_get(a);
+        mp_float_t b_val = mp_obj_float_get(b);
+        return a_val == b_val && !signbit(a_val) == !signbit(b_val);
+    #endif
     } else {
         return mp_obj_equal(a, b);
     }
@@ -62,8 +62,10 @@ mp_raw_code_t *mp_emit_glue_new_raw_code(void) {
 
 void mp_emit_glue_assign_bytecode(mp_raw_code_t *rc, const byte *code,
     mp_raw_code_t **children,
-    #if MICROPY_PERSISTENT_CODE_SAVE
+    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_OPT_INLINE_CACHE
     size_t len,
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE
     uint16_t n_children,
     #endif
     uint16_t scope_flags) {
@@ -83,8 +85,17 @@ void mp_emit_glue_assign_bytecode(mp_raw_code_t *rc, const byte *code,
     mp_prof_extract_prelude(code, prelude);
     #endif
 
+    #if MICROPY_OPT_INLINE_CACHE
+    rc->inline_cache = mp_inline_cache_new(code, len);
+    #endif
+
+    #if MICROPY_OPT_QUICKEN_BINARY_OP
+    // bytecode given here was built or loaded into RAM
+    rc->bytecode_is_writable = true;
+    #endif
+
     #if DEBUG_PRINT
-    #if !MICROPY_PERSISTENT_CODE_SAVE
+    #if !MICROPY_PERSISTENT_CODE_SAVE && !MICROPY_OPT_INLINE_CACHE
     const size_t len = 0;
     #endif
     DEBUG_printf("assign byte code: code=%p len=" UINT_FMT " flags=%x\n", code, len, (uint)scope_flags);
@@ -126,6 +137,8 @@ void mp_emit_glue_assign_native(mp_raw_code_t *rc, mp_raw_code_kind_t kind, cons
         "mcr p15, 0, r0, c7, c7, 0\n" // invalidate I-cache and D-cache
         : : : "r0", "cc");
     #endif
+    #elif MICROPY_EMIT_ARM64
+    __builtin___clear_cache((void *)fun_data, (uint8_t *)fun_data + fun_len);
     #endif
 
     rc->kind = kind;
@@ -228,6 +241,14 @@ mp_obj_t mp_make_function_from_proto_fun(mp_proto_fun_t proto_fun, const mp_modu
             self_fun->rc = rc;
             #endif
 
+            #if MICROPY_OPT_INLINE_CACHE
+            ((mp_obj_fun_bc_t *)MP_OBJ_TO_PTR(fun))->inline_cache = rc->inline_cache;
+            #endif
+
+            #if MICROPY_OPT_QUICKEN_BINARY_OP
+            ((mp_obj_fun_bc_t *)MP_OBJ_TO_PTR(fun))->bytecode_is_writable = rc->bytecode_is_writable;
+            #endif
+
             break;
     }
 
@@ -92,6 +92,12 @@ typedef struct _mp_raw_code_t {
     mp_bytecode_prelude_t prelude;
     #endif
     #endif
+    #if MICROPY_OPT_INLINE_CACHE
+    mp_inline_cache_t *inline_cache;
+    #endif
+    #if MICROPY_OPT_QUICKEN_BINARY_OP
+    bool bytecode_is_writable;
+    #endif
     #if MICROPY_EMIT_INLINE_ASM
     uint32_t asm_n_pos_args : 8;
     uint32_t asm_type_sig : 24; // compressed as 2-bit types; ret is MSB, then arg0, arg1, etc
@@ -118,14 +124,22 @@ typedef struct _mp_raw_code_truncated_t {
     mp_bytecode_prelude_t prelude;
     #endif
     #endif
+    #if MICROPY_OPT_INLINE_CACHE
+    mp_inline_cache_t *inline_cache;
+    #endif
+    #if MICROPY_OPT_QUICKEN_BINARY_OP
+    bool bytecode_is_writable;
+    #endif
 } mp_raw_code_truncated_t;
 
 mp_raw_code_t *mp_emit_glue_new_raw_code(void);
 
 void mp_emit_glue_assign_bytecode(mp_raw_code_t *rc, const byte *code,
     mp_raw_code_t **children,
-    #if MICROPY_PERSISTENT_CODE_SAVE
+    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_OPT_INLINE_CACHE
     size_t len,
+    #endif
+    #if MICROPY_PERSISTENT_CODE_SAVE
     uint16_t n_children,
     #endif
     uint16_t scope_flags);
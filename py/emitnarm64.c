@@ -0,0 +1,25 @@
+// ARM64 specific stuff
+
+#include "py/mpconfig.h"
+
+#if MICROPY_EMIT_ARM64
+
+// This is defined so that the assembler exports generic assembler API macros
+#define GENERIC_ASM_API (1)
+#include "py/asmarm64.h"
+
+// Word indices of REG_LOCAL_x in nlr_buf_t
+#define NLR_BUF_IDX_LOCAL_1 (4) // x19
+
+// Native code relies on nlr_jump restoring REG_LOCAL_1 from the above slot of
+// nlr_buf_t, so when it runs on this machine the NLR must be the AArch64 one
+#include "py/nlr.h"
+#if !MICROPY_DYNAMIC_COMPILER && !MICROPY_NLR_AARCH64
+#error "MICROPY_EMIT_ARM64 requires MICROPY_NLR_AARCH64"
+#endif
+
+#define N_ARM64 (1)
+#define EXPORT_FUN(name) emit_native_arm64_##name
+#include "py/emitnative.c"
+
+#endif
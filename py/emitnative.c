@@ -59,7 +59,7 @@
 #endif
 
 // wrapper around everything in this file
-#if N_X64 || N_X86 || N_THUMB || N_ARM || N_XTENSA || N_XTENSAWIN
+#if N_X64 || N_X86 || N_THUMB || N_ARM || N_ARM64 || N_XTENSA || N_XTENSAWIN
 
 // C stack layout for native functions:
 //  0:                          nlr_buf_t [optional]
@@ -86,7 +86,7 @@
 //  emit->code_state_start:     fun_obj, old_globals [optional]
 //  emit->stack_start:          Python object stack             | emit->n_state
 //                              locals (reversed, L0 at end)    |
-//                              (L0-L2 may be in regs instead)
+//                              (locals may be in regs instead)
 
 // Native emitter needs to know the following sizes and offsets of C structs (on the target):
 #if MICROPY_DYNAMIC_COMPILER
@@ -174,6 +174,22 @@ static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, RE
 
 #define REG_LOCAL_LAST (reg_local_table[MAX_REGS_FOR_LOCAL_VARS - 1])
 
+// On x64, viper functions allocate registers to locals by their live ranges,
+// and can also keep locals in the following callee-save registers, which are
+// only saved on entry if they are used.  Other emitters keep locals 0-2 in
+// registers, as for native functions.
+#if N_X64
+#define VIPER_ALLOC_LOCAL_REGS (1)
+#define MAX_REGS_FOR_LOCAL_VARS_EXTRA (2)
+static const uint8_t reg_local_extra_table[MAX_REGS_FOR_LOCAL_VARS_EXTRA] = {REG_LOCAL_EXTRA_1, REG_LOCAL_EXTRA_2};
+#else
+#define VIPER_ALLOC_LOCAL_REGS (0)
+#define MAX_REGS_FOR_LOCAL_VARS_EXTRA (0)
+#endif
+
+// Entry in local_reg for a local that lives on the C stack
+#define LOCAL_REG_NONE (0xff)
+
 #define EMIT_NATIVE_VIPER_TYPE_ERROR(emit, ...) do { \
         *emit->error_slot = mp_obj_new_exception_msg_varg(&mp_type_ViperTypeError, __VA_ARGS__); \
 } while (0)
@@ -200,6 +216,7 @@ typedef enum {
 
     VTYPE_UNBOUND = 0x60 | MP_NATIVE_TYPE_OBJ,
     VTYPE_BUILTIN_CAST = 0x70 | MP_NATIVE_TYPE_OBJ,
+    VTYPE_PTR_METHOD = 0x80 | MP_NATIVE_TYPE_OBJ,
 } vtype_kind_t;
 
 static qstr vtype_to_qstr(vtype_kind_t vtype) {
@@ -226,6 +243,20 @@ static qstr vtype_to_qstr(vtype_kind_t vtype) {
     }
 }
 
+// Live range of a local, as code offsets in MP_PASS_STACK_SIZE, and the cost
+// of keeping it on the C stack (uses within loops count more)
+typedef struct _local_live_t {
+    size_t start;
+    size_t end;
+    mp_uint_t weight;
+} local_live_t;
+
+typedef struct _local_use_t {
+    size_t pos;
+    uint16_t local_num;
+    uint16_t weight;
+} local_use_t;
+
 typedef struct _stack_info_t {
     vtype_kind_t vtype;
     stack_info_kind_t kind;
@@ -257,6 +288,16 @@ struct _emit_t {
     mp_uint_t local_vtype_alloc;
     vtype_kind_t *local_vtype;
 
+    // Register holding each local, or LOCAL_REG_NONE.  For viper these are
+    // allocated at the end of MP_PASS_STACK_SIZE using the live ranges of
+    // the locals, so locals whose ranges don't overlap can share a register.
+    uint8_t *local_reg;
+    bool local_reg_extra_used;
+    local_live_t *local_live;
+    size_t local_use_alloc;
+    size_t local_use_len;
+    local_use_t *local_use;
+
     mp_uint_t stack_info_alloc;
     stack_info_t *stack_info;
     vtype_kind_t saved_stack_vtype;
@@ -304,6 +345,9 @@ void EXPORT_FUN(free)(emit_t * emit) {
     m_del_obj(ASM_T, emit->as);
     m_del(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
+    m_del(uint8_t, emit->local_reg, emit->local_vtype_alloc);
+    m_del(local_live_t, emit->local_live, emit->local_vtype_alloc);
+    m_del(local_use_t, emit->local_use, emit->local_use_alloc);
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
     m_del_obj(emit_t, emit);
 }
@@ -372,9 +416,32 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
     // allocate memory for keeping track of the types of locals
     if (emit->local_vtype_alloc < scope->num_locals) {
         emit->local_vtype = m_renew(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc, scope->num_locals);
+        emit->local_reg = m_renew(uint8_t, emit->local_reg, emit->local_vtype_alloc, scope->num_locals);
+        emit->local_live = m_renew(local_live_t, emit->local_live, emit->local_vtype_alloc, scope->num_locals);
         emit->local_vtype_alloc = scope->num_locals;
     }
 
+    if (!emit->do_viper_types || !VIPER_ALLOC_LOCAL_REGS) {
+        // Native code keeps the first locals in registers
+        for (mp_uint_t i = 0; i < scope->num_locals; ++i) {
+            emit->local_reg[i] = LOCAL_REG_NONE;
+            if (i < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
+                emit->local_reg[i] = reg_local_table[i];
+            }
+        }
+        emit->local_reg_extra_used = false;
+    } else if (pass <= MP_PASS_STACK_SIZE) {
+        // Viper locals stay on the C stack in this pass, which works out their
+        // live ranges so registers can be allocated for the following passes
+        for (mp_uint_t i = 0; i < scope->num_locals; ++i) {
+            emit->local_reg[i] = LOCAL_REG_NONE;
+            emit->local_live[i].start = (size_t)-1;
+            emit->local_live[i].end = 0;
+        }
+        emit->local_reg_extra_used = false;
+        emit->local_use_len = 0;
+    }
+
     // set default type for arguments
     mp_uint_t num_args = emit->scope->num_pos_args + emit->scope->num_kwonly_args;
     if (scope->scope_flags & MP_SCOPE_FLAG_VARARGS) {
@@ -429,16 +496,16 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         // Work out size of state (locals plus stack)
         // n_state counts all stack and locals, even those in registers
         emit->n_state = scope->num_locals + scope->stack_size;
+
+        // Locals are stored in reverse at the end of the frame, so a leading run
+        // of locals that are in registers doesn't need space in the frame.  An
+        // argument in REG_LOCAL_LAST needs a spot if REG_LOCAL_LAST still holds
+        // the args array when that argument is stored (see below).
         int num_locals_in_regs = 0;
-        if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            num_locals_in_regs = scope->num_locals;
-            if (num_locals_in_regs > MAX_REGS_FOR_LOCAL_VARS) {
-                num_locals_in_regs = MAX_REGS_FOR_LOCAL_VARS;
-            }
-            // Need a spot for REG_LOCAL_LAST (see below)
-            if (scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1) {
-                --num_locals_in_regs;
-            }
+        while (num_locals_in_regs < scope->num_locals
+               && emit->local_reg[num_locals_in_regs] != LOCAL_REG_NONE
+               && !(emit->local_reg[num_locals_in_regs] == REG_LOCAL_LAST && num_locals_in_regs < scope->num_pos_args - 1)) {
+            ++num_locals_in_regs;
         }
 
         // Work out where the locals and Python stack start within the C stack
@@ -452,8 +519,12 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
             emit->stack_start = emit->code_state_start + 0;
         }
 
-        // Entry to function
+        // Entry to function, saving any extra registers used for locals
+        #if N_X64
+        asm_x64_entry(emit->as, emit->stack_start + emit->n_state - num_locals_in_regs, emit->local_reg_extra_used);
+        #else
         ASM_ENTRY(emit->as, emit->stack_start + emit->n_state - num_locals_in_regs);
+        #endif
 
         #if N_X86
         asm_x86_mov_arg_to_r32(emit->as, 0, REG_PARENT_ARG_1);
@@ -501,15 +572,18 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
                 r = REG_RET;
             }
             // REG_LOCAL_LAST points to the args array so be sure not to overwrite it if it's still needed
-            if (i < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit) && (i != MAX_REGS_FOR_LOCAL_VARS - 1 || emit->scope->num_pos_args == MAX_REGS_FOR_LOCAL_VARS)) {
-                ASM_MOV_REG_REG(emit->as, reg_local_table[i], r);
+            int reg_local = emit->local_reg[i];
+            if (reg_local != LOCAL_REG_NONE && (reg_local != REG_LOCAL_LAST || i == emit->scope->num_pos_args - 1)) {
+                ASM_MOV_REG_REG(emit->as, reg_local, r);
             } else {
                 emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), r);
             }
         }
         // Get local from the stack back into REG_LOCAL_LAST if this reg couldn't be written to above
-        if (emit->scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1 && CAN_USE_REGS_FOR_LOCALS(emit)) {
-            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, MAX_REGS_FOR_LOCAL_VARS - 1));
+        for (int i = 0; i < emit->scope->num_pos_args - 1; i++) {
+            if (emit->local_reg[i] == REG_LOCAL_LAST) {
+                ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, i));
+            }
         }
 
         emit_native_global_exc_entry(emit);
@@ -632,6 +706,153 @@ static inline void emit_native_write_code_info_qstr(emit_t *emit, qstr qst) {
     mp_encode_uint(&emit->as->base, mp_asm_base_get_cur_to_write_bytes, mp_emit_common_use_qstr(emit->emit_common, qst));
 }
 
+// Record a load or store of a viper local, to work out its live range
+static void local_live_use(emit_t *emit, mp_uint_t local_num) {
+    if (!VIPER_ALLOC_LOCAL_REGS || emit->pass != MP_PASS_STACK_SIZE || !emit->do_viper_types) {
+        return;
+    }
+    size_t pos = mp_asm_base_get_code_pos(&emit->as->base);
+    local_live_t *live = &emit->local_live[local_num];
+    if (live->start == (size_t)-1) {
+        live->start = pos;
+    }
+    if (pos > live->end) {
+        live->end = pos;
+    }
+    if (emit->local_use_len >= emit->local_use_alloc) {
+        emit->local_use = m_renew(local_use_t, emit->local_use, emit->local_use_alloc, emit->local_use_alloc + 32);
+        emit->local_use_alloc += 32;
+    }
+    local_use_t *use = &emit->local_use[emit->local_use_len++];
+    use->pos = pos;
+    use->local_num = local_num;
+    use->weight = 1;
+}
+
+// Record a jump.  A backwards jump closes a loop, and a local that is live
+// anywhere in the loop must keep its register for the whole loop.
+static void local_live_jump(emit_t *emit, mp_uint_t label) {
+    if (!VIPER_ALLOC_LOCAL_REGS || emit->pass != MP_PASS_STACK_SIZE || !emit->do_viper_types) {
+        return;
+    }
+    size_t loop_start = emit->as->base.label_offsets[label];
+    if (loop_start == (size_t)-1) {
+        // Forward jump
+        return;
+    }
+    size_t loop_end = mp_asm_base_get_code_pos(&emit->as->base);
+    for (mp_uint_t i = 0; i < emit->scope->num_locals; ++i) {
+        local_live_t *live = &emit->local_live[i];
+        if (live->start <= loop_end && live->end >= loop_start) {
+            live->start = MIN(live->start, loop_start);
+            live->end = MAX(live->end, loop_end);
+        }
+    }
+    // Uses in the loop make a local more costly to keep on the C stack
+    for (size_t i = emit->local_use_len; i > 0 && emit->local_use[i - 1].pos >= loop_start; --i) {
+        if (emit->local_use[i - 1].weight < 0x1000) {
+            emit->local_use[i - 1].weight *= 8;
+        }
+    }
+}
+
+// Allocate registers to viper locals by a linear scan over their live ranges.
+// If a local doesn't fit then the local with the lowest weight is spilled to
+// the C stack, for the whole function.
+static void local_live_alloc_regs(emit_t *emit) {
+    scope_t *scope = emit->scope;
+    if (!CAN_USE_REGS_FOR_LOCALS(emit)) {
+        return;
+    }
+
+    size_t code_end = mp_asm_base_get_code_pos(&emit->as->base);
+    for (mp_uint_t i = 0; i < scope->num_locals; ++i) {
+        emit->local_live[i].weight = 0;
+    }
+    for (size_t i = 0; i < emit->local_use_len; ++i) {
+        emit->local_live[emit->local_use[i].local_num].weight += emit->local_use[i].weight;
+    }
+    for (mp_uint_t i = 0; i < scope->num_locals; ++i) {
+        local_live_t *live = &emit->local_live[i];
+        if (live->start == (size_t)-1) {
+            continue;
+        }
+        if (i < scope->num_pos_args) {
+            // Arguments are assigned on entry
+            live->start = 0;
+        }
+        if (emit->local_vtype[i] == VTYPE_PYOBJ) {
+            // An object gets a register to itself so that, if it's read before
+            // being assigned, it can't see a native value of another local
+            live->start = 0;
+            live->end = code_end;
+        }
+    }
+
+    int num_regs = MAX_REGS_FOR_LOCAL_VARS + MAX_REGS_FOR_LOCAL_VARS_EXTRA;
+    int reg_holder[MAX_REGS_FOR_LOCAL_VARS + MAX_REGS_FOR_LOCAL_VARS_EXTRA];
+    for (int k = 0; k < num_regs; ++k) {
+        reg_holder[k] = -1;
+    }
+
+    // Visit the locals in order of the start of their live range
+    size_t prev_start = 0;
+    int prev_local = -1;
+    for (;;) {
+        int cur = -1;
+        for (mp_uint_t i = 0; i < scope->num_locals; ++i) {
+            local_live_t *live = &emit->local_live[i];
+            if (live->start == (size_t)-1 || live->start < prev_start
+                || (live->start == prev_start && (int)i <= prev_local)) {
+                continue;
+            }
+            if (cur < 0 || live->start < emit->local_live[cur].start) {
+                cur = i;
+            }
+        }
+        if (cur < 0) {
+            break;
+        }
+        local_live_t *live = &emit->local_live[cur];
+        prev_start = live->start;
+        prev_local = cur;
+
+        // Free the registers of locals whose live range has ended, and find
+        // a free register or else the one holding the cheapest local
+        int free_k = -1;
+        int spill_k = -1;
+        for (int k = 0; k < num_regs; ++k) {
+            int holder = reg_holder[k];
+            if (holder >= 0 && emit->local_live[holder].end < live->start) {
+                reg_holder[k] = holder = -1;
+            }
+            if (holder < 0) {
+                if (free_k < 0) {
+                    free_k = k;
+                }
+            } else if (spill_k < 0 || emit->local_live[holder].weight < emit->local_live[reg_holder[spill_k]].weight) {
+                spill_k = k;
+            }
+        }
+        if (free_k < 0) {
+            if (spill_k < 0 || live->weight <= emit->local_live[reg_holder[spill_k]].weight) {
+                continue;
+            }
+            emit->local_reg[reg_holder[spill_k]] = LOCAL_REG_NONE;
+            free_k = spill_k;
+        }
+        reg_holder[free_k] = cur;
+        #if N_X64
+        if (free_k >= MAX_REGS_FOR_LOCAL_VARS) {
+            emit->local_reg[cur] = reg_local_extra_table[free_k - MAX_REGS_FOR_LOCAL_VARS];
+            emit->local_reg_extra_used = true;
+            continue;
+        }
+        #endif
+        emit->local_reg[cur] = reg_local_table[free_k];
+    }
+}
+
 static bool emit_native_end_pass(emit_t *emit) {
     emit_native_global_exc_exit(emit);
 
@@ -674,6 +895,8 @@ static bool emit_native_end_pass(emit_t *emit) {
         }
         emit->n_cell = mp_asm_base_get_code_pos(&emit->as->base) - cell_start;
 
+    } else if (VIPER_ALLOC_LOCAL_REGS && emit->pass == MP_PASS_STACK_SIZE && emit->do_viper_types) {
+        local_live_alloc_regs(emit);
     }
 
     ASM_END_PASS(emit->as);
@@ -1390,8 +1613,10 @@ static void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("local '%q' used before type known"), qst);
     }
     emit_native_pre(emit);
-    if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_post_push_reg(emit, vtype, reg_local_table[local_num]);
+    local_live_use(emit, local_num);
+    int reg_local = emit->local_reg[local_num];
+    if (reg_local != LOCAL_REG_NONE) {
+        emit_post_push_reg(emit, vtype, reg_local);
     } else {
         need_reg_single(emit, REG_TEMP0, 0);
         emit_native_mov_reg_state(emit, REG_TEMP0, LOCAL_IDX_LOCAL_VAR(emit, local_num));
@@ -1460,6 +1685,26 @@ static void emit_native_load_method(emit_t *emit, qstr qst, bool is_super) {
     } else {
         vtype_kind_t vtype_base;
         emit_pre_pop_reg(emit, &vtype_base, REG_ARG_1); // arg1 = base
+        if (vtype_base == VTYPE_PTR8 || vtype_base == VTYPE_PTR16 || vtype_base == VTYPE_PTR32) {
+            // viper pointer method, the call is lowered to a helper by emit_native_call_method
+            switch (qst) {
+                case MP_QSTR_copy_from:
+                case MP_QSTR_fill:
+                case MP_QSTR_xor_from:
+                case MP_QSTR_sum:
+                    break;
+                default:
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        MP_ERROR_TEXT("'%q' has no method '%q'"), vtype_to_qstr(vtype_base), qst);
+                    // push placeholders so the call is compiled as a normal method call
+                    emit_post_push_imm(emit, VTYPE_PYOBJ, 0);
+                    emit_post_push_imm(emit, VTYPE_PYOBJ, 0);
+                    return;
+            }
+            emit_post_push_imm(emit, VTYPE_PTR_METHOD, qst);
+            emit_post_push_reg(emit, vtype_base, REG_ARG_1);
+            return;
+        }
         assert(vtype_base == VTYPE_PYOBJ);
         emit_get_stack_pointer_to_reg_for_push(emit, REG_ARG_3, 2); // arg3 = dest ptr
         emit_call_with_qstr_arg(emit, MP_F_LOAD_METHOD, qst, REG_ARG_2); // arg2 = method name
@@ -1520,6 +1765,12 @@ static void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_ARM64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_arm64_ldr_reg_reg_offset(emit->as, 0, REG_RET, reg_base, index_value << 0);
+                            break;
+                        }
+                        #endif
                         need_reg_single(emit, reg_index, 0);
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add index to base
@@ -1538,6 +1789,12 @@ static void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_ARM64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_arm64_ldr_reg_reg_offset(emit->as, 1, REG_RET, reg_base, index_value << 1);
+                            break;
+                        }
+                        #endif
                         need_reg_single(emit, reg_index, 0);
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 1);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 2*index to base
@@ -1556,6 +1813,12 @@ static void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_ARM64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_arm64_ldr_reg_reg_offset(emit->as, 2, REG_RET, reg_base, index_value << 2);
+                            break;
+                        }
+                        #endif
                         need_reg_single(emit, reg_index, 0);
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 2);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 4*index to base
@@ -1583,12 +1846,20 @@ static void emit_native_load_subscr(emit_t *emit) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
                     // TODO optimise to use thumb ldrb r1, [r2, r3]
+                    #if N_ARM64
+                    asm_arm64_ldr_reg_reg_reg(emit->as, 0, REG_RET, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_LOAD8_REG_REG(emit->as, REG_RET, REG_ARG_1); // store value to (base+index)
                     break;
                 }
                 case VTYPE_PTR16: {
                     // pointer to 16-bit memory
+                    #if N_ARM64
+                    asm_arm64_ldr_reg_reg_reg(emit->as, 1, REG_RET, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+2*index)
@@ -1596,6 +1867,10 @@ static void emit_native_load_subscr(emit_t *emit) {
                 }
                 case VTYPE_PTR32: {
                     // pointer to word-size memory
+                    #if N_ARM64
+                    asm_arm64_ldr_reg_reg_reg(emit->as, 2, REG_RET, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1614,8 +1889,10 @@ static void emit_native_load_subscr(emit_t *emit) {
 
 static void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
-    if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_pre_pop_reg(emit, &vtype, reg_local_table[local_num]);
+    local_live_use(emit, local_num);
+    int reg_local = emit->local_reg[local_num];
+    if (reg_local != LOCAL_REG_NONE) {
+        emit_pre_pop_reg(emit, &vtype, reg_local);
     } else {
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
         emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, local_num), REG_TEMP0);
@@ -1636,6 +1913,15 @@ static void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num)
 
 static void emit_native_store_deref(emit_t *emit, qstr qst, mp_uint_t local_num) {
     DEBUG_printf("store_deref(%s, " UINT_FMT ")\n", qstr_str(qst), local_num);
+    #if MICROPY_GC_INCREMENTAL || MICROPY_DYNAMIC_COMPILER
+    // An incremental GC may have already scanned the cell, so store via
+    // mp_obj_cell_set which has the write barrier.  This is always done for
+    // code from mpy-cross because the target's GC configuration isn't known.
+    emit_native_load_fast(emit, qst, local_num);
+    vtype_kind_t vtype_cell, vtype_val;
+    emit_pre_pop_reg_reg(emit, &vtype_cell, REG_ARG_1, &vtype_val, REG_ARG_2);
+    emit_call(emit, MP_F_CELL_SET);
+    #else
     need_reg_single(emit, REG_TEMP0, 0);
     need_reg_single(emit, REG_TEMP1, 0);
     emit_native_load_fast(emit, qst, local_num);
@@ -1645,6 +1931,7 @@ static void emit_native_store_deref(emit_t *emit, qstr qst, mp_uint_t local_num)
     int reg_src = REG_TEMP1;
     emit_pre_pop_reg_flexible(emit, &vtype, &reg_src, reg_base, reg_base);
     ASM_STORE_REG_REG_OFFSET(emit->as, reg_src, reg_base, 1);
+    #endif
     emit_post(emit);
 }
 
@@ -1752,6 +2039,12 @@ static void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_ARM64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_arm64_str_reg_reg_offset(emit->as, 0, reg_value, reg_base, index_value << 0);
+                            break;
+                        }
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         #if N_ARM
                         asm_arm_strb_reg_reg_reg(emit->as, reg_value, reg_base, reg_index);
@@ -1773,6 +2066,12 @@ static void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_ARM64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_arm64_str_reg_reg_offset(emit->as, 1, reg_value, reg_base, index_value << 1);
+                            break;
+                        }
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 1);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 2*index to base
                         reg_base = reg_index;
@@ -1790,6 +2089,12 @@ static void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_ARM64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_arm64_str_reg_reg_offset(emit->as, 2, reg_value, reg_base, index_value << 2);
+                            break;
+                        }
+                        #endif
                         #if N_ARM
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         asm_arm_str_reg_reg_reg(emit->as, reg_value, reg_base, reg_index);
@@ -1834,6 +2139,9 @@ static void emit_native_store_subscr(emit_t *emit) {
                     #if N_ARM
                     asm_arm_strb_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
                     break;
+                    #elif N_ARM64
+                    asm_arm64_str_reg_reg_reg(emit->as, 0, reg_value, REG_ARG_1, reg_index);
+                    break;
                     #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_STORE8_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+index)
@@ -1844,6 +2152,9 @@ static void emit_native_store_subscr(emit_t *emit) {
                     #if N_ARM
                     asm_arm_strh_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
                     break;
+                    #elif N_ARM64
+                    asm_arm64_str_reg_reg_reg(emit->as, 1, reg_value, REG_ARG_1, reg_index);
+                    break;
                     #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1855,6 +2166,9 @@ static void emit_native_store_subscr(emit_t *emit) {
                     #if N_ARM
                     asm_arm_str_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
                     break;
+                    #elif N_ARM64
+                    asm_arm64_str_reg_reg_reg(emit->as, 2, reg_value, REG_ARG_1, reg_index);
+                    break;
                     #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1968,6 +2282,7 @@ static void emit_native_jump(emit_t *emit, mp_uint_t label) {
     emit_native_pre(emit);
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
+    local_live_jump(emit, label);
     ASM_JUMP(emit->as, label);
     emit_post(emit);
     mp_asm_base_suppress_code(&emit->as->base);
@@ -1998,6 +2313,7 @@ static void emit_native_jump_helper(emit_t *emit, bool cond, mp_uint_t label, bo
     }
     // need to commit stack because we may jump elsewhere
     need_stack_settled(emit);
+    local_live_jump(emit, label);
     // Emit the jump
     if (cond) {
         ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label, vtype == VTYPE_PYOBJ);
@@ -2499,6 +2815,25 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
                 ASM_ARM_CC_NE,
             };
             asm_arm_setcc_reg(emit->as, REG_RET, ccs[op_idx]);
+            #elif N_ARM64
+            asm_arm64_cmp_reg_reg(emit->as, REG_ARG_2, reg_rhs);
+            static uint8_t ccs[6 + 6] = {
+                // unsigned
+                ASM_ARM64_CC_CC,
+                ASM_ARM64_CC_HI,
+                ASM_ARM64_CC_EQ,
+                ASM_ARM64_CC_LS,
+                ASM_ARM64_CC_CS,
+                ASM_ARM64_CC_NE,
+                // signed
+                ASM_ARM64_CC_LT,
+                ASM_ARM64_CC_GT,
+                ASM_ARM64_CC_EQ,
+                ASM_ARM64_CC_LE,
+                ASM_ARM64_CC_GE,
+                ASM_ARM64_CC_NE,
+            };
+            asm_arm64_cset_reg(emit->as, REG_RET, ccs[op_idx]);
             #elif N_XTENSA || N_XTENSAWIN
             static uint8_t ccs[6 + 6] = {
                 // unsigned
@@ -2761,7 +3096,75 @@ static void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
     }
 }
 
+// Lower a call to one of the viper pointer methods to a helper in mp_fun_table:
+//   ptr.copy_from(src, n)  copy n elements from src to ptr
+//   ptr.fill(val, n)       store val in n elements of ptr
+//   ptr.xor_from(src, n)   xor n elements of src into ptr
+//   ptr.sum(n)             return the sum of n elements of ptr, as an int
+// Element size is taken from the type of ptr (ptr8, ptr16 or ptr32).
+static void emit_native_call_ptr_method(emit_t *emit, mp_uint_t n_positional, mp_uint_t n_keyword, mp_uint_t star_flags) {
+    mp_uint_t n_items = n_positional + 2 * n_keyword + (star_flags ? 1 : 0);
+    qstr qst = peek_stack(emit, n_items + 1)->data.u_imm;
+    vtype_kind_t vtype_self = peek_vtype(emit, n_items);
+    mp_uint_t n_args_wanted = qst == MP_QSTR_sum ? 1 : 2;
+    if (n_keyword != 0 || star_flags || n_positional != n_args_wanted) {
+        adjust_stack(emit, -(mp_int_t)(n_items + 1));
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("wrong number of arguments to '%q'"), qst);
+        return;
+    }
+
+    // arguments to the helper are: self, [src/val,] n, log2 of element size
+    vtype_kind_t vtype_arg1 = VTYPE_INT;
+    vtype_kind_t vtype_n;
+    int reg_size_log2;
+    if (n_args_wanted == 2) {
+        emit_pre_pop_reg_reg_reg(emit, &vtype_n, REG_ARG_3, &vtype_arg1, REG_ARG_2, &vtype_self, REG_ARG_1);
+        reg_size_log2 = REG_ARG_4;
+    } else {
+        emit_pre_pop_reg_reg(emit, &vtype_n, REG_ARG_2, &vtype_self, REG_ARG_1);
+        reg_size_log2 = REG_ARG_3;
+    }
+    emit_pre_pop_discard(emit); // the method marker
+    if (vtype_n != VTYPE_INT && vtype_n != VTYPE_UINT) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't pass '%q' as length to '%q'"), vtype_to_qstr(vtype_n), qst);
+    }
+    if (vtype_arg1 == VTYPE_PYOBJ || vtype_arg1 == VTYPE_PTR_NONE
+        || (qst == MP_QSTR_fill && vtype_arg1 != VTYPE_INT && vtype_arg1 != VTYPE_UINT && vtype_arg1 != VTYPE_BOOL)) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't pass '%q' to '%q'"), vtype_to_qstr(vtype_arg1), qst);
+    }
+
+    mp_fun_kind_t fun_kind;
+    switch (qst) {
+        case MP_QSTR_copy_from:
+            fun_kind = MP_F_PTR_COPY;
+            break;
+        case MP_QSTR_fill:
+            fun_kind = MP_F_PTR_FILL;
+            break;
+        case MP_QSTR_xor_from:
+            fun_kind = MP_F_PTR_XOR;
+            break;
+        default:
+            fun_kind = MP_F_PTR_SUM;
+            break;
+    }
+    emit_call_with_imm_arg(emit, fun_kind, vtype_self - VTYPE_PTR8, reg_size_log2);
+    if (fun_kind == MP_F_PTR_SUM) {
+        emit_post_push_reg(emit, VTYPE_INT, REG_RET);
+    } else {
+        emit_post_push_imm(emit, VTYPE_PTR_NONE, 0);
+    }
+}
+
 static void emit_native_call_method(emit_t *emit, mp_uint_t n_positional, mp_uint_t n_keyword, mp_uint_t star_flags) {
+    if (emit->do_viper_types
+        && peek_vtype(emit, n_positional + 2 * n_keyword + (star_flags ? 1 : 0) + 1) == VTYPE_PTR_METHOD) {
+        emit_native_call_ptr_method(emit, n_positional, n_keyword, star_flags);
+        return;
+    }
     if (star_flags) {
         emit_get_stack_pointer_to_reg_for_pop(emit, REG_ARG_3, n_positional + 2 * n_keyword + 3); // pointer to args
         emit_call_with_2_imm_args(emit, MP_F_CALL_METHOD_N_KW_VAR, 1, REG_ARG_1, n_positional | (n_keyword << 8), REG_ARG_2);
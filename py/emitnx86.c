@@ -61,6 +61,11 @@ static byte mp_f_n_args[MP_F_NUMBER_OF] = {
     [MP_F_SMALL_INT_MODULO] = 2,
     [MP_F_NATIVE_YIELD_FROM] = 3,
     [MP_F_SETJMP] = 1,
+    [MP_F_PTR_COPY] = 4,
+    [MP_F_PTR_FILL] = 4,
+    [MP_F_PTR_XOR] = 4,
+    [MP_F_PTR_SUM] = 3,
+    [MP_F_CELL_SET] = 2,
 };
 
 #define N_X86 (1)
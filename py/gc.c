@@ -31,6 +31,7 @@
 
 #include "py/gc.h"
 #include "py/runtime.h"
+#include "py/bc.h"
 
 #if MICROPY_DEBUG_VALGRIND
 #include <valgrind/memcheck.h>
@@ -91,6 +92,8 @@
 #define ATB_FREE_TO_TAIL(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_TAIL << BLOCK_SHIFT(block)); } while (0)
 #define ATB_HEAD_TO_MARK(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_MARK << BLOCK_SHIFT(block)); } while (0)
 #define ATB_MARK_TO_HEAD(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_TAIL << BLOCK_SHIFT(block))); } while (0)
+// true for AT_HEAD and AT_MARK, which outside of a collection only occurs during an incremental cycle
+#define ATB_IS_HEAD(area, block) (ATB_GET_KIND(area, block) & AT_HEAD)
 
 #define BLOCK_FROM_PTR(area, ptr) (((byte *)(ptr) - area->gc_pool_start) / BYTES_PER_BLOCK)
 #define PTR_FROM_BLOCK(area, block) (((block) * BYTES_PER_BLOCK + (uintptr_t)area->gc_pool_start))
@@ -112,6 +115,37 @@
 #define FTB_CLEAR(area, block) do { area->gc_finaliser_table_start[(block) / BLOCKS_PER_FTB] &= (~(1 << ((block) & 7))); } while (0)
 #endif
 
+#if MICROPY_OPT_GC_WORD_SCAN
+// Process the ATB a machine word at a time where possible, so that runs of
+// free, used or marked blocks can be skipped with a single test.  Words are
+// loaded with memcpy so the ATB needs no particular alignment, and the masks
+// below give the same result on little- and big-endian machines because each
+// block's two bits never straddle a byte.
+
+#define BLOCKS_PER_WORD (BLOCKS_PER_ATB * sizeof(uintptr_t))
+
+// Low bit of every 2-bit entry in a word, ie 0x5555...
+#define ATB_WORD_LOW_BITS ((uintptr_t)-1 / 3)
+// Every entry set to AT_TAIL, ie 0xaaaa...
+#define ATB_WORD_ALL_TAIL (ATB_WORD_LOW_BITS << 1)
+
+// These give a mask with the low bit of each matching entry set.
+#define ATB_WORD_FREE(w) (~((w) | ((w) >> 1)) & ATB_WORD_LOW_BITS)
+#define ATB_WORD_HEADS(w) ((w) & ~((w) >> 1) & ATB_WORD_LOW_BITS)
+#define ATB_WORD_MARKS(w) ((w) & ((w) >> 1) & ATB_WORD_LOW_BITS)
+
+// Block must be a multiple of BLOCKS_PER_WORD.
+static inline uintptr_t gc_atb_load_word(const mp_state_mem_area_t *area, size_t block) {
+    uintptr_t w;
+    memcpy(&w, &area->gc_alloc_table_start[block / BLOCKS_PER_ATB], sizeof(w));
+    return w;
+}
+
+static inline void gc_atb_store_word(mp_state_mem_area_t *area, size_t block, uintptr_t w) {
+    memcpy(&area->gc_alloc_table_start[block / BLOCKS_PER_ATB], &w, sizeof(w));
+}
+#endif
+
 #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
 #define GC_ENTER() mp_thread_mutex_lock(&MP_STATE_MEM(gc_mutex), 1)
 #define GC_EXIT() mp_thread_mutex_unlock(&MP_STATE_MEM(gc_mutex))
@@ -120,6 +154,117 @@
 #define GC_EXIT()
 #endif
 
+#if MICROPY_GC_FREE_INDEX
+// The free index keeps, for each chunk of FREE_INDEX_BLOCKS_PER_CHUNK blocks,
+// the number of free blocks at the start and end of the chunk and the longest
+// free run within it.  A multi-block allocation can then find the first run
+// of free blocks that is long enough by looking at one entry per chunk, and
+// only needs to scan the ATB of the single chunk that contains the run.
+// Whenever a block changes between free and used its chunk is marked dirty,
+// by setting longest to FREE_INDEX_DIRTY, and the summary of a dirty chunk is
+// only rebuilt when gc_free_index_find reaches it.  This keeps allocating and
+// freeing cheap.  Most allocations are satisfied close to where the search
+// starts, so gc_alloc first scans the ATB to the end of the starting chunk
+// and only then uses the index; 1-block allocations never use it.
+
+#define FREE_INDEX_ATB_PER_CHUNK (64)
+#define FREE_INDEX_BLOCKS_PER_CHUNK (FREE_INDEX_ATB_PER_CHUNK * BLOCKS_PER_ATB)
+#define FREE_INDEX_NUM_CHUNKS(area) (((area)->gc_alloc_table_byte_len + FREE_INDEX_ATB_PER_CHUNK - 1) / FREE_INDEX_ATB_PER_CHUNK)
+#define FREE_INDEX_DIRTY (0xffff)
+
+static size_t gc_free_index_chunk_len(mp_state_mem_area_t *area, size_t chunk) {
+    return MIN(FREE_INDEX_BLOCKS_PER_CHUNK, area->gc_alloc_table_byte_len * BLOCKS_PER_ATB - chunk * FREE_INDEX_BLOCKS_PER_CHUNK);
+}
+
+static void gc_free_index_rebuild_chunk(mp_state_mem_area_t *area, size_t chunk) {
+    size_t block = chunk * FREE_INDEX_BLOCKS_PER_CHUNK;
+    size_t n = gc_free_index_chunk_len(area, chunk);
+    size_t lead = 0;
+    size_t run = 0;
+    size_t longest = 0;
+    for (size_t i = 0; i < n;) {
+        size_t n_free = ATB_GET_KIND(area, block + i) == AT_FREE;
+        size_t n_step = 1;
+        #if MICROPY_OPT_GC_WORD_SCAN
+        if (i % BLOCKS_PER_WORD == 0 && i + BLOCKS_PER_WORD <= n) {
+            uintptr_t w = gc_atb_load_word(area, block + i);
+            if (w == 0) {
+                n_free = n_step = BLOCKS_PER_WORD;
+            } else if (ATB_WORD_FREE(w) == 0) {
+                n_step = BLOCKS_PER_WORD;
+            }
+        }
+        #endif
+        if (n_free) {
+            run += n_free;
+            if (run > longest) {
+                longest = run;
+            }
+        } else {
+            if (lead == 0 && run == i) {
+                lead = run;
+            }
+            run = 0;
+        }
+        i += n_step;
+    }
+    mp_gc_free_index_t *entry = &area->gc_free_index[chunk];
+    entry->lead = run == n ? n : lead;
+    entry->trail = run;
+    entry->longest = longest;
+}
+
+// Mark the index as out of date after the free/used state of the given
+// (inclusive) range of blocks has changed.
+static inline void gc_free_index_update(mp_state_mem_area_t *area, size_t first_block, size_t last_block) {
+    for (size_t chunk = first_block / FREE_INDEX_BLOCKS_PER_CHUNK; chunk <= last_block / FREE_INDEX_BLOCKS_PER_CHUNK; chunk++) {
+        area->gc_free_index[chunk].longest = FREE_INDEX_DIRTY;
+    }
+}
+
+static void gc_free_index_invalidate(mp_state_mem_area_t *area) {
+    for (size_t chunk = 0; chunk < FREE_INDEX_NUM_CHUNKS(area); chunk++) {
+        area->gc_free_index[chunk].longest = FREE_INDEX_DIRTY;
+    }
+}
+
+// Find the first run of n_blocks free blocks in the area, starting at the given
+// chunk, where run is the number of free blocks just before that chunk.  Returns
+// the last block of the run, or (size_t)-1 if there is no such run.  This gives
+// the same result as a linear ATB scan.
+static size_t gc_free_index_find(mp_state_mem_area_t *area, size_t n_blocks, size_t chunk, size_t run) {
+    for (; chunk < FREE_INDEX_NUM_CHUNKS(area); chunk++) {
+        MICROPY_GC_HOOK_LOOP(chunk);
+        const mp_gc_free_index_t *entry = &area->gc_free_index[chunk];
+        if (entry->longest == FREE_INDEX_DIRTY) {
+            gc_free_index_rebuild_chunk(area, chunk);
+        }
+        size_t block = chunk * FREE_INDEX_BLOCKS_PER_CHUNK;
+        if (run + entry->lead >= n_blocks) {
+            // run that started in an earlier chunk completes in this one
+            return block + n_blocks - run - 1;
+        }
+        if (entry->longest >= n_blocks) {
+            // run is entirely within this chunk, scan for it
+            run = 0;
+            for (;; block++) {
+                if (ATB_GET_KIND(area, block) != AT_FREE) {
+                    run = 0;
+                } else if (++run >= n_blocks) {
+                    return block;
+                }
+            }
+        }
+        if (entry->lead == gc_free_index_chunk_len(area, chunk)) {
+            run += entry->lead;
+        } else {
+            run = entry->trail;
+        }
+    }
+    return (size_t)-1;
+}
+#endif // MICROPY_GC_FREE_INDEX
+
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, P=pool; all in bytes):
@@ -128,6 +273,16 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     //     P = A * BLOCKS_PER_ATB * BYTES_PER_BLOCK
     // => T = A * (1 + BLOCKS_PER_ATB / BLOCKS_PER_FTB + BLOCKS_PER_ATB * BYTES_PER_BLOCK)
     size_t total_byte_len = (byte *)end - (byte *)start;
+
+    #if MICROPY_GC_FREE_INDEX
+    // Place the free index at the start of the area, sized (generously) as if
+    // the whole area were pool, and rounded up to keep the ATB word aligned.
+    size_t free_index_byte_len = (total_byte_len / (FREE_INDEX_BLOCKS_PER_CHUNK * BYTES_PER_BLOCK) + 1) * sizeof(mp_gc_free_index_t);
+    free_index_byte_len = (free_index_byte_len + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1);
+    area->gc_free_index = (mp_gc_free_index_t *)start;
+    start = (byte *)start + free_index_byte_len;
+    total_byte_len -= free_index_byte_len;
+    #endif
     #if MICROPY_ENABLE_FINALISER
     area->gc_alloc_table_byte_len = (total_byte_len - ALLOC_TABLE_GAP_BYTE)
         * MP_BITS_PER_BYTE
@@ -166,6 +321,10 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     area->gc_last_free_atb_index = 0;
     area->gc_last_used_block = 0;
 
+    #if MICROPY_GC_FREE_INDEX
+    gc_free_index_invalidate(area);
+    #endif
+
     #if MICROPY_GC_SPLIT_HEAP
     area->next = NULL;
     #endif
@@ -213,6 +372,30 @@ void gc_init(void *start, void *end) {
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_MEM(gc_mutex));
     #endif
+
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_PHASE_NONE;
+    MP_STATE_MEM(gc_inc_auto) = false;
+    MP_STATE_MEM(gc_inc_poll) = false;
+    MP_STATE_MEM(gc_inc_sp) = 0;
+    MP_STATE_MEM(gc_inc_dirty_len) = 0;
+    MP_STATE_MEM(gc_inc_dirty_overflow) = false;
+    MP_STATE_MEM(gc_inc_alloc_amount) = 0;
+    // by default, start a cycle after allocating a quarter of the heap
+    MP_STATE_MEM(gc_inc_trigger) = MP_STATE_MEM(area).gc_alloc_table_byte_len * BLOCKS_PER_ATB / 4;
+    #endif
+
+    #if MICROPY_GC_PARALLEL_MARK
+    MP_STATE_MEM(gc_mark_n_workers) = 1;
+    for (size_t i = 0; i < MICROPY_GC_PARALLEL_MARK_MAX_WORKERS; i++) {
+        mp_thread_mutex_init(&MP_STATE_MEM(gc_mark_deque)[i].mutex);
+        MP_STATE_MEM(gc_mark_deque)[i].len = 0;
+    }
+    #endif
+
+    #if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    MP_STATE_MEM(gc_prof_period) = 0;
+    #endif
 }
 
 #if MICROPY_GC_SPLIT_HEAP
@@ -235,6 +418,10 @@ void gc_add(void *start, void *end) {
 
     // Add this area to the linked list
     prev_area->next = area;
+
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_trigger) += area->gc_alloc_table_byte_len * BLOCKS_PER_ATB / 4;
+    #endif
 }
 
 #if MICROPY_GC_SPLIT_HEAP_AUTO
@@ -378,6 +565,60 @@ static inline mp_state_mem_area_t *gc_get_ptr_area(const void *ptr) {
 #endif
 #endif
 
+// Check all the children of the given block: mark the unmarked child blocks
+// and put those newly marked blocks on the stack, starting at index sp.
+// Returns the new stack pointer.
+static inline size_t gc_mark_children(mp_state_mem_area_t *area, size_t block, size_t sp, size_t *n_blocks_out) {
+    // work out number of consecutive blocks in the chain starting with this one
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
+    *n_blocks_out = n_blocks;
+
+    // check that the consecutive blocks didn't overflow past the end of the area
+    assert(area->gc_pool_start + (block + n_blocks) * BYTES_PER_BLOCK <= area->gc_pool_end);
+
+    // check this block's children
+    void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+    for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
+        MICROPY_GC_HOOK_LOOP(i);
+        void *ptr = *ptrs;
+        // If this is a heap pointer that hasn't been marked, mark it and push
+        // it's children to the stack.
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+        if (!ptr_area) {
+            // Not a heap-allocated pointer (might even be random data).
+            continue;
+        }
+        #else
+        if (!VERIFY_PTR(ptr)) {
+            continue;
+        }
+        mp_state_mem_area_t *ptr_area = area;
+        #endif
+        size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
+        if (ATB_GET_KIND(ptr_area, ptr_block) != AT_HEAD) {
+            // This block is already marked.
+            continue;
+        }
+        // An unmarked head. Mark it, and push it on gc stack.
+        TRACE_MARK(ptr_block, ptr);
+        ATB_HEAD_TO_MARK(ptr_area, ptr_block);
+        if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
+            MP_STATE_MEM(gc_block_stack)[sp] = ptr_block;
+            #if MICROPY_GC_SPLIT_HEAP
+            MP_STATE_MEM(gc_area_stack)[sp] = ptr_area;
+            #endif
+            sp += 1;
+        } else {
+            MP_STATE_MEM(gc_stack_overflow) = 1;
+        }
+    }
+    return sp;
+}
+
 // Take the given block as the topmost block on the stack. Check all it's
 // children: mark the unmarked child blocks and put those newly marked
 // blocks on the stack. When all children have been checked, pop off the
@@ -395,52 +636,8 @@ static void gc_mark_subtree(size_t block)
         mp_state_mem_area_t *area = &MP_STATE_MEM(area);
         #endif
 
-        // work out number of consecutive blocks in the chain starting with this one
-        size_t n_blocks = 0;
-        do {
-            n_blocks += 1;
-        } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
-
-        // check that the consecutive blocks didn't overflow past the end of the area
-        assert(area->gc_pool_start + (block + n_blocks) * BYTES_PER_BLOCK <= area->gc_pool_end);
-
-        // check this block's children
-        void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
-        for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
-            MICROPY_GC_HOOK_LOOP(i);
-            void *ptr = *ptrs;
-            // If this is a heap pointer that hasn't been marked, mark it and push
-            // it's children to the stack.
-            #if MICROPY_GC_SPLIT_HEAP
-            mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
-            if (!ptr_area) {
-                // Not a heap-allocated pointer (might even be random data).
-                continue;
-            }
-            #else
-            if (!VERIFY_PTR(ptr)) {
-                continue;
-            }
-            mp_state_mem_area_t *ptr_area = area;
-            #endif
-            size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
-            if (ATB_GET_KIND(ptr_area, ptr_block) != AT_HEAD) {
-                // This block is already marked.
-                continue;
-            }
-            // An unmarked head. Mark it, and push it on gc stack.
-            TRACE_MARK(ptr_block, ptr);
-            ATB_HEAD_TO_MARK(ptr_area, ptr_block);
-            if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
-                MP_STATE_MEM(gc_block_stack)[sp] = ptr_block;
-                #if MICROPY_GC_SPLIT_HEAP
-                MP_STATE_MEM(gc_area_stack)[sp] = ptr_area;
-                #endif
-                sp += 1;
-            } else {
-                MP_STATE_MEM(gc_stack_overflow) = 1;
-            }
-        }
+        size_t n_blocks;
+        sp = gc_mark_children(area, block, sp, &n_blocks);
 
         // Are there any blocks on the stack?
         if (sp == 0) {
@@ -456,6 +653,198 @@ static void gc_mark_subtree(size_t block)
     }
 }
 
+#if MICROPY_GC_PARALLEL_MARK
+
+#if !MICROPY_PY_THREAD
+#error MICROPY_GC_PARALLEL_MARK requires MICROPY_PY_THREAD
+#endif
+
+// The parallel mark phase works as follows.  Root pointers are marked as
+// usual by gc_collect_root, but rather than tracing their children straight
+// away the blocks are distributed round-robin over the workers' deques.  At
+// the start of gc_collect_end the port runs gc_mark_worker on each worker
+// thread.  A worker pops blocks from its own deque, scans them and pushes
+// newly marked children back onto it, and when it runs out it steals half of
+// the entries of another worker's deque.  Mark bits are set with an atomic
+// OR on the ATB byte so that each block is claimed by exactly one worker.
+// Marking is complete when no worker is active and every deque is empty.
+
+static inline bool gc_mark_deque_push(mp_gc_mark_deque_t *dq, mp_state_mem_area_t *area, size_t block) {
+    if (dq->len == MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE) {
+        return false;
+    }
+    size_t i = (dq->top + dq->len++) % MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE;
+    dq->block[i] = block;
+    #if MICROPY_GC_SPLIT_HEAP
+    dq->area[i] = area;
+    #else
+    (void)area;
+    #endif
+    return true;
+}
+
+// Called for each marked root block; returns false if there's no room, in
+// which case the caller must trace the block itself.
+static bool gc_mark_seed(mp_state_mem_area_t *area, size_t block) {
+    size_t w = MP_STATE_MEM(gc_mark_seed_next)++ % MP_STATE_MEM(gc_mark_n_workers);
+    // No locking needed: the workers are not running yet.
+    return gc_mark_deque_push(&MP_STATE_MEM(gc_mark_deque)[w], area, block);
+}
+
+static bool gc_mark_worker_pop(mp_gc_mark_deque_t *dq, mp_state_mem_area_t **area, size_t *block) {
+    mp_thread_mutex_lock(&dq->mutex, 1);
+    bool ok = dq->len > 0;
+    if (ok) {
+        size_t i = (dq->top + --dq->len) % MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE;
+        *block = dq->block[i];
+        #if MICROPY_GC_SPLIT_HEAP
+        *area = dq->area[i];
+        #else
+        *area = &MP_STATE_MEM(area);
+        #endif
+    }
+    mp_thread_mutex_unlock(&dq->mutex);
+    return ok;
+}
+
+// Maximum number of entries taken from another worker's deque in one go.
+#define GC_MARK_STEAL_MAX (64)
+
+// Move up to half of the oldest entries of another worker's deque to this
+// one (which must be empty).  Only one deque is locked at a time.
+static bool gc_mark_worker_steal(size_t worker) {
+    mp_gc_mark_deque_t *own = &MP_STATE_MEM(gc_mark_deque)[worker];
+    size_t n_workers = MP_STATE_MEM(gc_mark_n_workers);
+    MICROPY_GC_STACK_ENTRY_TYPE blocks[GC_MARK_STEAL_MAX];
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *areas[GC_MARK_STEAL_MAX];
+    #endif
+    for (size_t j = 1; j < n_workers; j++) {
+        mp_gc_mark_deque_t *victim = &MP_STATE_MEM(gc_mark_deque)[(worker + j) % n_workers];
+        if (__atomic_load_n(&victim->len, __ATOMIC_RELAXED) == 0) {
+            continue;
+        }
+        mp_thread_mutex_lock(&victim->mutex, 1);
+        size_t n = MIN((victim->len + 1) / 2, GC_MARK_STEAL_MAX);
+        for (size_t k = 0; k < n; k++) {
+            blocks[k] = victim->block[victim->top];
+            #if MICROPY_GC_SPLIT_HEAP
+            areas[k] = victim->area[victim->top];
+            #endif
+            victim->top = (victim->top + 1) % MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE;
+            victim->len--;
+        }
+        mp_thread_mutex_unlock(&victim->mutex);
+        if (n > 0) {
+            mp_thread_mutex_lock(&own->mutex, 1);
+            for (size_t k = 0; k < n; k++) {
+                #if MICROPY_GC_SPLIT_HEAP
+                gc_mark_deque_push(own, areas[k], blocks[k]);
+                #else
+                gc_mark_deque_push(own, NULL, blocks[k]);
+                #endif
+            }
+            mp_thread_mutex_unlock(&own->mutex);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Scan the children of the given block, claiming and queuing unmarked ones.
+static void gc_mark_worker_scan(mp_gc_mark_deque_t *dq, mp_state_mem_area_t *area, size_t block) {
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
+
+    void **ptrs = (void **)PTR_FROM_BLOCK(area, block);
+    for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
+        void *ptr = *ptrs;
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *ptr_area = gc_get_ptr_area(ptr);
+        if (!ptr_area) {
+            continue;
+        }
+        #else
+        if (!VERIFY_PTR(ptr)) {
+            continue;
+        }
+        mp_state_mem_area_t *ptr_area = area;
+        #endif
+        size_t ptr_block = BLOCK_FROM_PTR(ptr_area, ptr);
+        if (ATB_GET_KIND(ptr_area, ptr_block) != AT_HEAD) {
+            continue;
+        }
+        // Claim the block: only one worker will see it change from HEAD to MARK.
+        byte *atb = &ptr_area->gc_alloc_table_start[ptr_block / BLOCKS_PER_ATB];
+        byte old = __atomic_fetch_or(atb, AT_MARK << BLOCK_SHIFT(ptr_block), __ATOMIC_RELAXED);
+        if (((old >> BLOCK_SHIFT(ptr_block)) & 3) != AT_HEAD) {
+            continue;
+        }
+        TRACE_MARK(ptr_block, ptr);
+        mp_thread_mutex_lock(&dq->mutex, 1);
+        bool pushed = gc_mark_deque_push(dq, ptr_area, ptr_block);
+        mp_thread_mutex_unlock(&dq->mutex);
+        if (!pushed) {
+            __atomic_store_n(&MP_STATE_MEM(gc_stack_overflow), 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void gc_mark_worker(size_t worker) {
+    mp_gc_mark_deque_t *dq = &MP_STATE_MEM(gc_mark_deque)[worker];
+    __atomic_add_fetch(&MP_STATE_MEM(gc_mark_n_active), 1, __ATOMIC_SEQ_CST);
+    for (;;) {
+        mp_state_mem_area_t *area;
+        size_t block;
+        if (gc_mark_worker_pop(dq, &area, &block)) {
+            gc_mark_worker_scan(dq, area, block);
+            continue;
+        }
+        if (gc_mark_worker_steal(worker)) {
+            continue;
+        }
+
+        // Nothing to do: go idle until there is something to steal.  Only
+        // active workers can add entries to a deque, so once no worker is
+        // active and all deques are empty the marking is finished.
+        __atomic_sub_fetch(&MP_STATE_MEM(gc_mark_n_active), 1, __ATOMIC_SEQ_CST);
+        for (;;) {
+            bool done = __atomic_load_n(&MP_STATE_MEM(gc_mark_n_active), __ATOMIC_SEQ_CST) == 0;
+            bool work = false;
+            for (size_t j = 0; j < MP_STATE_MEM(gc_mark_n_workers); j++) {
+                if (__atomic_load_n(&MP_STATE_MEM(gc_mark_deque)[j].len, __ATOMIC_SEQ_CST) != 0) {
+                    work = true;
+                    break;
+                }
+            }
+            if (work) {
+                __atomic_add_fetch(&MP_STATE_MEM(gc_mark_n_active), 1, __ATOMIC_SEQ_CST);
+                break;
+            }
+            if (done) {
+                return;
+            }
+            MICROPY_GC_PARALLEL_MARK_IDLE();
+        }
+    }
+}
+
+static void gc_mark_parallel(void) {
+    size_t n_workers = MP_STATE_MEM(gc_mark_n_workers);
+    bool seeded = false;
+    for (size_t i = 0; i < n_workers; i++) {
+        seeded |= MP_STATE_MEM(gc_mark_deque)[i].len != 0;
+    }
+    if (seeded) {
+        MP_STATE_MEM(gc_mark_n_active) = 0;
+        gc_mark_run_workers(n_workers);
+    }
+}
+
+#endif // MICROPY_GC_PARALLEL_MARK
+
 static void gc_deal_with_stack_overflow(void) {
     while (MP_STATE_MEM(gc_stack_overflow)) {
         MP_STATE_MEM(gc_stack_overflow) = 0;
@@ -477,6 +866,128 @@ static void gc_deal_with_stack_overflow(void) {
     }
 }
 
+#if MICROPY_OPT_GC_WORD_SCAN && !CLEAR_ON_SWEEP && !DEBUG_PRINT
+// Try to sweep a whole word of the ATB at once, which is possible when it
+// contains only live blocks, or only garbage without finalisers.  Returns
+// false if the word has a mix and must be swept block-by-block.
+static bool gc_sweep_word(mp_state_mem_area_t *area, size_t block, int *free_tail, size_t *last_used_block) {
+    uintptr_t w = gc_atb_load_word(area, block);
+    uintptr_t heads = ATB_WORD_HEADS(w);
+    uintptr_t marks = ATB_WORD_MARKS(w);
+    // Leading tail blocks belong to the chain that started in an earlier word.
+    bool leading_tail = ATB_GET_KIND(area, block) == AT_TAIL;
+    bool leading_tail_freed = leading_tail && *free_tail;
+
+    if (heads == 0 && !leading_tail_freed) {
+        // only free, tail and marked blocks: unmark them all
+        if (w != 0) {
+            gc_atb_store_word(area, block, w & ~(marks << 1));
+            // find the last used block in this word
+            size_t i = BLOCKS_PER_WORD / BLOCKS_PER_ATB;
+            while (area->gc_alloc_table_start[block / BLOCKS_PER_ATB + --i] == 0) {
+            }
+            size_t bl = block + i * BLOCKS_PER_ATB + BLOCKS_PER_ATB - 1;
+            while (ATB_GET_KIND(area, bl) == AT_FREE) {
+                bl -= 1;
+            }
+            *last_used_block = bl;
+        }
+        if (marks != 0) {
+            *free_tail = 0;
+        }
+        return true;
+    }
+
+    if (marks == 0 && (!leading_tail || leading_tail_freed)) {
+        // only free blocks and garbage: free them all, unless there are finalisers to run
+        #if MICROPY_ENABLE_FINALISER
+        for (size_t i = 0; i < BLOCKS_PER_WORD / BLOCKS_PER_FTB; i++) {
+            if (area->gc_finaliser_table_start[block / BLOCKS_PER_FTB + i] != 0) {
+                return false;
+            }
+        }
+        #endif
+        gc_atb_store_word(area, block, 0);
+        if (heads != 0) {
+            *free_tail = 1;
+        }
+        #if MICROPY_PY_GC_COLLECT_RETVAL
+        for (; heads != 0; heads &= heads - 1) {
+            MP_STATE_MEM(gc_collected)++;
+        }
+        #endif
+        return true;
+    }
+
+    return false;
+}
+#endif
+
+// Sweep blocks from block up to (but not including) end_block of the given
+// area: free unmarked heads and their tails, and unmark marked heads.
+static void gc_sweep_range(mp_state_mem_area_t *area, size_t block, size_t end_block, int *free_tail, size_t *last_used_block) {
+    for (; block < end_block; block++) {
+        MICROPY_GC_HOOK_LOOP(block);
+        #if MICROPY_OPT_GC_WORD_SCAN && !CLEAR_ON_SWEEP && !DEBUG_PRINT
+        if (block % BLOCKS_PER_WORD == 0 && block + BLOCKS_PER_WORD <= end_block) {
+            if (gc_sweep_word(area, block, free_tail, last_used_block)) {
+                block += BLOCKS_PER_WORD - 1;
+                continue;
+            }
+        }
+        #endif
+        switch (ATB_GET_KIND(area, block)) {
+            case AT_HEAD:
+                #if MICROPY_ENABLE_FINALISER
+                if (FTB_GET(area, block)) {
+                    mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
+                    if (obj->type != NULL) {
+                        // if the object has a type then see if it has a __del__ method
+                        mp_obj_t dest[2];
+                        mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
+                        if (dest[0] != MP_OBJ_NULL) {
+                            // load_method returned a method, execute it in a protected environment
+                            #if MICROPY_ENABLE_SCHEDULER
+                            mp_sched_lock();
+                            #endif
+                            mp_call_function_1_protected(dest[0], dest[1]);
+                            #if MICROPY_ENABLE_SCHEDULER
+                            mp_sched_unlock();
+                            #endif
+                        }
+                    }
+                    // clear finaliser flag
+                    FTB_CLEAR(area, block);
+                }
+                #endif
+                *free_tail = 1;
+                DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
+                #if MICROPY_PY_GC_COLLECT_RETVAL
+                MP_STATE_MEM(gc_collected)++;
+                #endif
+                // fall through to free the head
+                MP_FALLTHROUGH
+
+            case AT_TAIL:
+                if (*free_tail) {
+                    ATB_ANY_TO_FREE(area, block);
+                    #if CLEAR_ON_SWEEP
+                    memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+                    #endif
+                } else {
+                    *last_used_block = block;
+                }
+                break;
+
+            case AT_MARK:
+                ATB_MARK_TO_HEAD(area, block);
+                *free_tail = 0;
+                *last_used_block = block;
+                break;
+        }
+    }
+}
+
 static void gc_sweep(void) {
     #if MICROPY_PY_GC_COLLECT_RETVAL
     MP_STATE_MEM(gc_collected) = 0;
@@ -494,60 +1005,16 @@ static void gc_sweep(void) {
 
         size_t last_used_block = 0;
 
-        for (size_t block = 0; block < end_block; block++) {
-            MICROPY_GC_HOOK_LOOP(block);
-            switch (ATB_GET_KIND(area, block)) {
-                case AT_HEAD:
-                    #if MICROPY_ENABLE_FINALISER
-                    if (FTB_GET(area, block)) {
-                        mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
-                        if (obj->type != NULL) {
-                            // if the object has a type then see if it has a __del__ method
-                            mp_obj_t dest[2];
-                            mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
-                            if (dest[0] != MP_OBJ_NULL) {
-                                // load_method returned a method, execute it in a protected environment
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_lock();
-                                #endif
-                                mp_call_function_1_protected(dest[0], dest[1]);
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_unlock();
-                                #endif
-                            }
-                        }
-                        // clear finaliser flag
-                        FTB_CLEAR(area, block);
-                    }
-                    #endif
-                    free_tail = 1;
-                    DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
-                    #if MICROPY_PY_GC_COLLECT_RETVAL
-                    MP_STATE_MEM(gc_collected)++;
-                    #endif
-                    // fall through to free the head
-                    MP_FALLTHROUGH
+        gc_sweep_range(area, 0, end_block, &free_tail, &last_used_block);
 
-                case AT_TAIL:
-                    if (free_tail) {
-                        ATB_ANY_TO_FREE(area, block);
-                        #if CLEAR_ON_SWEEP
-                        memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
-                        #endif
-                    } else {
-                        last_used_block = block;
-                    }
-                    break;
+        area->gc_last_used_block = last_used_block;
 
-                case AT_MARK:
-                    ATB_MARK_TO_HEAD(area, block);
-                    free_tail = 0;
-                    last_used_block = block;
-                    break;
-            }
+        #if MICROPY_GC_FREE_INDEX
+        // sweeping only frees blocks, so chunks past end_block are unchanged
+        if (end_block > 0) {
+            gc_free_index_update(area, 0, end_block - 1);
         }
-
-        area->gc_last_used_block = last_used_block;
+        #endif
 
         #if MICROPY_GC_SPLIT_HEAP_AUTO
         // Free any empty area, aside from the first one
@@ -562,17 +1029,10 @@ static void gc_sweep(void) {
     }
 }
 
-void gc_collect_start(void) {
-    GC_ENTER();
-    MP_STATE_THREAD(gc_lock_depth)++;
-    #if MICROPY_GC_ALLOC_THRESHOLD
-    MP_STATE_MEM(gc_alloc_amount) = 0;
-    #endif
-    MP_STATE_MEM(gc_stack_overflow) = 0;
-
-    // Trace root pointers.  This relies on the root pointers being organised
-    // correctly in the mp_state_ctx structure.  We scan nlr_top, dict_locals,
-    // dict_globals, then the root pointer section of mp_state_vm.
+// Trace root pointers.  This relies on the root pointers being organised
+// correctly in the mp_state_ctx structure.  We scan nlr_top, dict_locals,
+// dict_globals, then the root pointer section of mp_state_vm.
+static void gc_collect_root_pointers(void) {
     void **ptrs = (void **)(void *)&mp_state_ctx;
     size_t root_start = offsetof(mp_state_ctx_t, thread.dict_locals);
     size_t root_end = offsetof(mp_state_ctx_t, vm.qstr_last_chunk);
@@ -585,6 +1045,362 @@ void gc_collect_start(void) {
     #endif
 }
 
+#if MICROPY_GC_INCREMENTAL
+
+// An incremental collection cycle goes through the following phases:
+// - MARK: the root pointers are marked and queued on gc_block_stack, and each
+//   gc_step scans some of the queued blocks.  Blocks allocated during this
+//   phase are marked and remembered as runs of new blocks, because a pointer
+//   to them may be stored in a block that's already scanned without going
+//   through GC_WRITE_BARRIER.  GC_WRITE_BARRIER marks the blocks written to
+//   and remembers them in the dirty list.
+// - FINISH: once the queue is empty gc_step calls gc_collect(), which scans
+//   the C stacks and the root pointers again, also rescanning roots that are
+//   already marked, then rescans the dirty blocks and the new blocks and
+//   traces anything newly reachable.  The length of this pause depends on the
+//   size of the roots and the number of objects written to and allocated,
+//   rather than the size of the heap.
+// - SWEEP: each gc_step sweeps part of the heap.  Blocks allocated past the
+//   sweep position are marked so they aren't freed.
+// A full collection started while a cycle is in progress abandons the cycle.
+
+static void gc_inc_set_phase(uint8_t phase) {
+    MP_STATE_MEM(gc_inc_phase) = phase;
+    MP_STATE_MEM(gc_inc_poll) = phase != GC_INC_PHASE_NONE && MP_STATE_MEM(gc_inc_auto);
+}
+
+// Abandon any incremental cycle that's in progress, unmarking all blocks.
+static void gc_inc_abort(void) {
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_PHASE_NONE) {
+        for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            for (size_t i = 0; i < area->gc_alloc_table_byte_len; i++) {
+                // turn every AT_MARK into AT_HEAD by clearing its upper bit
+                byte a = area->gc_alloc_table_start[i];
+                area->gc_alloc_table_start[i] = a & ~((a & (a >> 1) & 0x55) << 1);
+            }
+        }
+        gc_inc_set_phase(GC_INC_PHASE_NONE);
+    }
+    MP_STATE_MEM(gc_inc_sp) = 0;
+    MP_STATE_MEM(gc_inc_dirty_len) = 0;
+    MP_STATE_MEM(gc_inc_dirty_overflow) = false;
+    MP_STATE_MEM(gc_inc_new_len) = 0;
+    MP_STATE_MEM(gc_inc_alloc_amount) = 0;
+    MP_STATE_MEM(gc_stack_overflow) = 0;
+}
+
+// Whether the given block has yet to be reached by the sweep in progress.
+static bool gc_inc_is_unswept(mp_state_mem_area_t *area, size_t block) {
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_PHASE_SWEEP) {
+        return false;
+    }
+    if (area == MP_STATE_MEM(gc_inc_sweep_area)) {
+        return block >= MP_STATE_MEM(gc_inc_sweep_block);
+    }
+    #if MICROPY_GC_SPLIT_HEAP
+    for (mp_state_mem_area_t *a = MP_STATE_MEM(gc_inc_sweep_area); a != NULL; a = NEXT_AREA(a)) {
+        if (a == area) {
+            return true;
+        }
+    }
+    #endif
+    return false;
+}
+
+static void gc_inc_push(mp_state_mem_area_t *area, size_t block) {
+    size_t sp = MP_STATE_MEM(gc_inc_sp);
+    if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
+        MP_STATE_MEM(gc_block_stack)[sp] = block;
+        #if MICROPY_GC_SPLIT_HEAP
+        MP_STATE_MEM(gc_area_stack)[sp] = area;
+        #else
+        (void)area;
+        #endif
+        MP_STATE_MEM(gc_inc_sp) = sp + 1;
+    } else {
+        MP_STATE_MEM(gc_stack_overflow) = 1;
+    }
+}
+
+// Called by gc_alloc for blocks allocated while marking.  Consecutive
+// allocations are usually close together, so they're merged into runs, and
+// once there's no room for another run the last one is extended.
+static void gc_inc_add_new(mp_state_mem_area_t *area, size_t start_block, size_t end_block) {
+    ATB_HEAD_TO_MARK(area, start_block);
+    size_t n = MP_STATE_MEM(gc_inc_new_len);
+    if (n > 0
+        #if MICROPY_GC_SPLIT_HEAP
+        && MP_STATE_MEM(gc_inc_new_area)[n - 1] == area
+        #endif
+        && (n == MICROPY_GC_INCREMENTAL_NEW_SIZE
+            || (start_block <= MP_STATE_MEM(gc_inc_new_end)[n - 1] + 1
+                && end_block + 1 >= MP_STATE_MEM(gc_inc_new_start)[n - 1]))) {
+        MP_STATE_MEM(gc_inc_new_start)[n - 1] = MIN(MP_STATE_MEM(gc_inc_new_start)[n - 1], start_block);
+        MP_STATE_MEM(gc_inc_new_end)[n - 1] = MAX(MP_STATE_MEM(gc_inc_new_end)[n - 1], end_block);
+    } else if (n < MICROPY_GC_INCREMENTAL_NEW_SIZE) {
+        MP_STATE_MEM(gc_inc_new_start)[n] = start_block;
+        MP_STATE_MEM(gc_inc_new_end)[n] = end_block;
+        #if MICROPY_GC_SPLIT_HEAP
+        MP_STATE_MEM(gc_inc_new_area)[n] = area;
+        #endif
+        MP_STATE_MEM(gc_inc_new_len) = n + 1;
+    } else {
+        // the last run is in another area
+        MP_STATE_MEM(gc_inc_dirty_overflow) = true;
+    }
+}
+
+static void gc_inc_start(void) {
+    gc_inc_abort();
+    gc_inc_set_phase(GC_INC_PHASE_MARK);
+    // With the phase set to MARK, gc_collect_root queues the blocks it marks.
+    gc_collect_root_pointers();
+}
+
+// Scan queued blocks until the given amount of work is done or the queue is
+// empty.  Returns the amount of work left over.
+static size_t gc_inc_mark(size_t work) {
+    size_t sp = MP_STATE_MEM(gc_inc_sp);
+    while (sp > 0 && work > 0) {
+        sp -= 1;
+        size_t block = MP_STATE_MEM(gc_block_stack)[sp];
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *area = MP_STATE_MEM(gc_area_stack)[sp];
+        #else
+        mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+        #endif
+        if (ATB_GET_KIND(area, block) != AT_MARK) {
+            // freed since it was queued
+            continue;
+        }
+        size_t n_blocks;
+        sp = gc_mark_children(area, block, sp, &n_blocks);
+        work -= MIN(work, n_blocks);
+    }
+    MP_STATE_MEM(gc_inc_sp) = sp;
+    return work;
+}
+
+// Called by gc_collect_start when finishing the mark phase of a cycle.
+static void gc_inc_finish_mark(void) {
+    gc_inc_mark((size_t)-1);
+    if (MP_STATE_MEM(gc_inc_dirty_overflow)) {
+        // too many blocks were written to, so rescan all marked blocks
+        MP_STATE_MEM(gc_stack_overflow) = 1;
+    }
+    for (size_t i = 0; i < MP_STATE_MEM(gc_inc_dirty_len); i++) {
+        size_t block = MP_STATE_MEM(gc_inc_dirty_block)[i];
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *area = MP_STATE_MEM(gc_inc_dirty_area)[i];
+        #else
+        mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+        #endif
+        if (ATB_GET_KIND(area, block) == AT_MARK) {
+            #if MICROPY_GC_SPLIT_HEAP
+            gc_mark_subtree(area, block);
+            #else
+            gc_mark_subtree(block);
+            #endif
+        }
+    }
+    MP_STATE_MEM(gc_inc_dirty_len) = 0;
+    MP_STATE_MEM(gc_inc_dirty_overflow) = false;
+    for (size_t i = 0; i < MP_STATE_MEM(gc_inc_new_len); i++) {
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *area = MP_STATE_MEM(gc_inc_new_area)[i];
+        #else
+        mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+        #endif
+        // a run may also contain older blocks, rescanning those is harmless
+        for (size_t block = MP_STATE_MEM(gc_inc_new_start)[i]; block <= MP_STATE_MEM(gc_inc_new_end)[i]; block++) {
+            if (ATB_GET_KIND(area, block) == AT_MARK) {
+                #if MICROPY_GC_SPLIT_HEAP
+                gc_mark_subtree(area, block);
+                #else
+                gc_mark_subtree(block);
+                #endif
+            }
+        }
+    }
+    MP_STATE_MEM(gc_inc_new_len) = 0;
+}
+
+// Sweep until the given amount of work is done or the sweep is complete.
+static void gc_inc_sweep(size_t work) {
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_inc_sweep_area);
+    size_t block = MP_STATE_MEM(gc_inc_sweep_block);
+    // as for a full sweep, finalisers can't allocate
+    MP_STATE_THREAD(gc_lock_depth)++;
+    while (area != NULL && work > 0) {
+        // recompute the end each time because blocks may have been allocated
+        size_t end_block = MIN(area->gc_alloc_table_byte_len * BLOCKS_PER_ATB, area->gc_last_used_block + 1);
+        size_t stop = block + MIN(work, end_block > block ? end_block - block : 0);
+        // Don't stop in the middle of a chain, so that the next step can start
+        // with free_tail = 0 (any tail at the start of a step must then belong
+        // to a chain allocated since, which is live).
+        while (stop < end_block && ATB_GET_KIND(area, stop) == AT_TAIL) {
+            stop += 1;
+        }
+        if (block < stop) {
+            int free_tail = 0;
+            size_t last_used_block = 0;
+            gc_sweep_range(area, block, stop, &free_tail, &last_used_block);
+            #if MICROPY_GC_FREE_INDEX
+            gc_free_index_update(area, block, stop - 1);
+            #endif
+            if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+                area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
+            }
+            #if MICROPY_GC_SPLIT_HEAP
+            if (MP_STATE_MEM(gc_last_free_area) != area) {
+                // See comment in gc_free.
+                MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+            }
+            #endif
+            work -= MIN(work, stop - block);
+            block = stop;
+        }
+        if (block >= end_block) {
+            area = NEXT_AREA(area);
+            block = 0;
+        }
+    }
+    MP_STATE_THREAD(gc_lock_depth)--;
+    MP_STATE_MEM(gc_inc_sweep_area) = area;
+    MP_STATE_MEM(gc_inc_sweep_block) = block;
+    if (area == NULL) {
+        gc_inc_set_phase(GC_INC_PHASE_NONE);
+    }
+}
+
+bool gc_step(size_t work) {
+    if (MP_STATE_THREAD(gc_lock_depth) > 0) {
+        return false;
+    }
+
+    GC_ENTER();
+
+    bool done = false;
+    switch (MP_STATE_MEM(gc_inc_phase)) {
+        case GC_INC_PHASE_NONE:
+            gc_inc_start();
+            MP_FALLTHROUGH
+
+        case GC_INC_PHASE_MARK:
+            gc_inc_mark(work);
+            if (MP_STATE_MEM(gc_inc_sp) == 0) {
+                // Everything reachable from the root pointers has been
+                // marked, so finish off with the C stacks.
+                gc_inc_set_phase(GC_INC_PHASE_FINISH);
+                GC_EXIT();
+                gc_collect();
+                return false;
+            }
+            break;
+
+        case GC_INC_PHASE_SWEEP:
+            gc_inc_sweep(work);
+            done = MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_NONE;
+            break;
+
+        default:
+            // another thread is finishing the mark phase
+            break;
+    }
+
+    GC_EXIT();
+
+    return done;
+}
+
+void gc_step_auto(bool enable) {
+    GC_ENTER();
+    MP_STATE_MEM(gc_inc_auto) = enable;
+    MP_STATE_MEM(gc_inc_alloc_amount) = 0;
+    gc_inc_set_phase(MP_STATE_MEM(gc_inc_phase));
+    GC_EXIT();
+}
+
+void gc_step_poll(void) {
+    if (MP_STATE_MEM(gc_auto_collect_enabled)) {
+        gc_step(MICROPY_GC_INCREMENTAL_POLL_WORK);
+    }
+}
+
+// Called by gc_alloc when allocating n_blocks with automatic steps enabled.
+static void gc_step_alloc(size_t n_blocks) {
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_NONE) {
+        MP_STATE_MEM(gc_inc_alloc_amount) += n_blocks;
+        if (MP_STATE_MEM(gc_inc_alloc_amount) < MP_STATE_MEM(gc_inc_trigger)) {
+            return;
+        }
+    }
+    gc_step(n_blocks * MICROPY_GC_INCREMENTAL_WORK_PER_BLOCK);
+}
+
+void gc_write_barrier(const void *ptr) {
+    GC_ENTER();
+    if (GC_INC_IS_MARKING()) {
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
+        #else
+        mp_state_mem_area_t *area = VERIFY_PTR(ptr) ? &MP_STATE_MEM(area) : NULL;
+        #endif
+        if (area != NULL) {
+            size_t block = BLOCK_FROM_PTR(area, ptr);
+            size_t kind = ATB_GET_KIND(area, block);
+            if (kind == AT_HEAD) {
+                ATB_HEAD_TO_MARK(area, block);
+                kind = AT_MARK;
+            }
+            size_t n = MP_STATE_MEM(gc_inc_dirty_len);
+            if (kind != AT_MARK) {
+                // not the start of an allocated block
+            } else if (n > 0 && MP_STATE_MEM(gc_inc_dirty_block)[n - 1] == block
+                       #if MICROPY_GC_SPLIT_HEAP
+                       && MP_STATE_MEM(gc_inc_dirty_area)[n - 1] == area
+                       #endif
+                       ) {
+                // same as the last one
+            } else if (n < MICROPY_GC_INCREMENTAL_DIRTY_SIZE) {
+                MP_STATE_MEM(gc_inc_dirty_block)[n] = block;
+                #if MICROPY_GC_SPLIT_HEAP
+                MP_STATE_MEM(gc_inc_dirty_area)[n] = area;
+                #endif
+                MP_STATE_MEM(gc_inc_dirty_len) = n + 1;
+            } else {
+                MP_STATE_MEM(gc_inc_dirty_overflow) = true;
+            }
+        }
+    }
+    GC_EXIT();
+}
+
+#endif // MICROPY_GC_INCREMENTAL
+
+void gc_collect_start(void) {
+    GC_ENTER();
+    MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    MP_STATE_MEM(gc_alloc_amount) = 0;
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_FINISH) {
+        // finish the mark phase of an incremental cycle, keeping its marks
+        gc_inc_finish_mark();
+    } else {
+        gc_inc_abort();
+    }
+    #else
+    MP_STATE_MEM(gc_stack_overflow) = 0;
+    #endif
+    #if MICROPY_GC_PARALLEL_MARK
+    MP_STATE_MEM(gc_mark_seed_next) = 0;
+    #endif
+
+    gc_collect_root_pointers();
+}
+
 // Address sanitizer needs to know that the access to ptrs[i] must always be
 // considered OK, even if it's a load from an address that would normally be
 // prohibited (due to being undefined, in a red zone, etc).
@@ -621,17 +1437,55 @@ void gc_collect_root(void **ptrs, size_t len) {
         if (ATB_GET_KIND(area, block) == AT_HEAD) {
             // An unmarked head: mark it, and mark all its children
             ATB_HEAD_TO_MARK(area, block);
+            #if MICROPY_GC_INCREMENTAL
+            if (MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_MARK) {
+                // starting an incremental cycle: children are marked by gc_step
+                gc_inc_push(area, block);
+                continue;
+            }
+            #endif
+            #if MICROPY_GC_PARALLEL_MARK
+            if (MP_STATE_MEM(gc_mark_n_workers) > 1 && gc_mark_seed(area, block)) {
+                // children will be marked by the parallel mark workers
+                continue;
+            }
+            #endif
+            #if MICROPY_GC_SPLIT_HEAP
+            gc_mark_subtree(area, block);
+            #else
+            gc_mark_subtree(block);
+            #endif
+        }
+        #if MICROPY_GC_INCREMENTAL
+        else if (MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_FINISH && ATB_GET_KIND(area, block) == AT_MARK) {
+            // Finishing an incremental cycle: this block may have been written
+            // to since it was scanned, so scan it again.
             #if MICROPY_GC_SPLIT_HEAP
             gc_mark_subtree(area, block);
             #else
             gc_mark_subtree(block);
             #endif
         }
+        #endif
     }
 }
 
 void gc_collect_end(void) {
+    #if MICROPY_GC_PARALLEL_MARK
+    gc_mark_parallel();
+    #endif
     gc_deal_with_stack_overflow();
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_FINISH) {
+        // marking is complete, leave the sweep to gc_step
+        gc_inc_set_phase(GC_INC_PHASE_SWEEP);
+        MP_STATE_MEM(gc_inc_sweep_area) = &MP_STATE_MEM(area);
+        MP_STATE_MEM(gc_inc_sweep_block) = 0;
+        MP_STATE_THREAD(gc_lock_depth)--;
+        GC_EXIT();
+        return;
+    }
+    #endif
     gc_sweep();
     #if MICROPY_GC_SPLIT_HEAP
     MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
@@ -646,6 +1500,9 @@ void gc_collect_end(void) {
 void gc_sweep_all(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_INCREMENTAL
+    gc_inc_abort();
+    #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
     gc_collect_end();
 }
@@ -665,36 +1522,46 @@ void gc_info(gc_info_t *info) {
         for (size_t block = 0, len = 0, len_free = 0; !finish;) {
             MICROPY_GC_HOOK_LOOP(block);
             size_t kind = ATB_GET_KIND(area, block);
+            size_t n = 1;
+            #if MICROPY_OPT_GC_WORD_SCAN
+            // count a whole word at once if it is entirely free or entirely tail blocks
+            if (block % BLOCKS_PER_WORD == 0 && block + BLOCKS_PER_WORD <= area->gc_alloc_table_byte_len * BLOCKS_PER_ATB) {
+                uintptr_t w = gc_atb_load_word(area, block);
+                if (w == 0 || w == ATB_WORD_ALL_TAIL) {
+                    n = BLOCKS_PER_WORD;
+                }
+            }
+            #endif
             switch (kind) {
                 case AT_FREE:
-                    info->free += 1;
-                    len_free += 1;
+                    info->free += n;
+                    len_free += n;
                     len = 0;
                     break;
 
+                case AT_MARK:
+                    // only seen during an incremental collection
+                    MP_FALLTHROUGH
+
                 case AT_HEAD:
                     info->used += 1;
                     len = 1;
                     break;
 
                 case AT_TAIL:
-                    info->used += 1;
-                    len += 1;
-                    break;
-
-                case AT_MARK:
-                    // shouldn't happen
+                    info->used += n;
+                    len += n;
                     break;
             }
 
-            block++;
+            block += n;
             finish = (block == area->gc_alloc_table_byte_len * BLOCKS_PER_ATB);
             // Get next block type if possible
             if (!finish) {
                 kind = ATB_GET_KIND(area, block);
             }
 
-            if (finish || kind == AT_FREE || kind == AT_HEAD) {
+            if (finish || kind != AT_TAIL) {
                 if (len == 1) {
                     info->num_1block += 1;
                 } else if (len == 2) {
@@ -703,7 +1570,7 @@ void gc_info(gc_info_t *info) {
                 if (len > info->max_block) {
                     info->max_block = len;
                 }
-                if (finish || kind == AT_HEAD) {
+                if (finish || kind != AT_FREE) {
                     if (len_free > info->max_free) {
                         info->max_free = len_free;
                     }
@@ -723,6 +1590,51 @@ void gc_info(gc_info_t *info) {
     GC_EXIT();
 }
 
+#if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+void gc_prof_start(size_t period) {
+    GC_ENTER();
+    if (period != 0) {
+        memset(MP_STATE_MEM(gc_prof_site), 0, sizeof(MP_STATE_MEM(gc_prof_site)));
+    }
+    MP_STATE_MEM(gc_prof_period) = period;
+    MP_STATE_MEM(gc_prof_countdown) = period;
+    GC_EXIT();
+}
+
+// Attributes a sampled allocation to the source line of the running bytecode.
+// Must be called with the GC mutex held, and must not allocate.
+static void gc_prof_sample(size_t n_bytes) {
+    mp_gc_prof_site_t *site = &MP_STATE_MEM(gc_prof_site)[0];
+    const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    if (code_state != NULL) {
+        qstr source_file, block_name;
+        size_t line = mp_bytecode_get_source_info(code_state->fun_bc, code_state->ip, &source_file, &block_name);
+        // open addressing over entries 1..N-1, falling back to entry 0 when full
+        const size_t n = MICROPY_PY_MICROPYTHON_HEAP_PROFILE_SITES - 1;
+        size_t i = (source_file * 31 + block_name * 7 + line) % n;
+        for (size_t probe = 0; probe < n; ++probe) {
+            mp_gc_prof_site_t *s = &MP_STATE_MEM(gc_prof_site)[1 + i];
+            if (s->count == 0) {
+                s->source_file = source_file;
+                s->block_name = block_name;
+                s->line = line;
+                site = s;
+                break;
+            }
+            if (s->line == line && s->block_name == block_name && s->source_file == source_file) {
+                site = s;
+                break;
+            }
+            if (++i == n) {
+                i = 0;
+            }
+        }
+    }
+    site->count += 1;
+    site->bytes += n_bytes;
+}
+#endif
+
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     bool has_finaliser = alloc_flags & GC_ALLOC_FLAG_HAS_FINALISER;
     size_t n_blocks = ((n_bytes + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1))) / BYTES_PER_BLOCK;
@@ -738,6 +1650,12 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         return NULL;
     }
 
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_auto) && MP_STATE_MEM(gc_auto_collect_enabled)) {
+        gc_step_alloc(n_blocks);
+    }
+    #endif
+
     GC_ENTER();
 
     mp_state_mem_area_t *area;
@@ -769,9 +1687,33 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
 
         // look for a run of n_blocks available blocks
         for (; area != NULL; area = NEXT_AREA(area), i = 0) {
+            size_t atb_end = area->gc_alloc_table_byte_len;
+            #if MICROPY_GC_FREE_INDEX
+            if (n_blocks > 1) {
+                // scan to the end of the first chunk, then use the free index
+                atb_end = MIN(atb_end, (area->gc_last_free_atb_index / FREE_INDEX_ATB_PER_CHUNK + 1) * FREE_INDEX_ATB_PER_CHUNK);
+            }
+            #endif
             n_free = 0;
-            for (i = area->gc_last_free_atb_index; i < area->gc_alloc_table_byte_len; i++) {
+            for (i = area->gc_last_free_atb_index; i < atb_end; i++) {
                 MICROPY_GC_HOOK_LOOP(i);
+                #if MICROPY_OPT_GC_WORD_SCAN
+                if (i % sizeof(uintptr_t) == 0 && i + sizeof(uintptr_t) <= atb_end) {
+                    uintptr_t w = gc_atb_load_word(area, i * BLOCKS_PER_ATB);
+                    if (ATB_WORD_FREE(w) == 0) {
+                        // no free blocks in this word
+                        n_free = 0;
+                        i += sizeof(uintptr_t) - 1;
+                        continue;
+                    }
+                    if (w == 0 && n_free + BLOCKS_PER_WORD < n_blocks) {
+                        // all blocks in this word are free but the run isn't long enough yet
+                        n_free += BLOCKS_PER_WORD;
+                        i += sizeof(uintptr_t) - 1;
+                        continue;
+                    }
+                }
+                #endif
                 byte a = area->gc_alloc_table_start[i];
                 // *FORMAT-OFF*
                 if (ATB_0_IS_FREE(a)) { if (++n_free >= n_blocks) { i = i * BLOCKS_PER_ATB + 0; goto found; } } else { n_free = 0; }
@@ -781,6 +1723,17 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
                 // *FORMAT-ON*
             }
 
+            #if MICROPY_GC_FREE_INDEX
+            if (atb_end < area->gc_alloc_table_byte_len) {
+                i = gc_free_index_find(area, n_blocks, atb_end / FREE_INDEX_ATB_PER_CHUNK, n_free);
+                if (i != (size_t)-1) {
+                    n_free = n_blocks;
+                    goto found;
+                }
+                continue;
+            }
+            #endif
+
             // No free blocks found on this heap. Mark this heap as
             // filled, so we won't try to find free space here again until
             // space is freed.
@@ -831,12 +1784,26 @@ found:
     // mark first block as used head
     ATB_FREE_TO_HEAD(area, start_block);
 
+    #if MICROPY_GC_INCREMENTAL
+    if (GC_INC_IS_MARKING()) {
+        // keep it, and rescan it when marking finishes
+        gc_inc_add_new(area, start_block, end_block);
+    } else if (gc_inc_is_unswept(area, start_block)) {
+        // keep it from being freed by the incremental sweep in progress
+        ATB_HEAD_TO_MARK(area, start_block);
+    }
+    #endif
+
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
     for (size_t bl = start_block + 1; bl <= end_block; bl++) {
         ATB_FREE_TO_TAIL(area, bl);
     }
 
+    #if MICROPY_GC_FREE_INDEX
+    gc_free_index_update(area, start_block, end_block);
+    #endif
+
     // get pointer to first block
     // we must create this pointer before unlocking the GC so a collection can find it
     void *ret_ptr = (void *)(area->gc_pool_start + start_block * BYTES_PER_BLOCK);
@@ -846,6 +1813,13 @@ found:
     MP_STATE_MEM(gc_alloc_amount) += n_blocks;
     #endif
 
+    #if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    if (MP_STATE_MEM(gc_prof_period) != 0 && --MP_STATE_MEM(gc_prof_countdown) == 0) {
+        MP_STATE_MEM(gc_prof_countdown) = MP_STATE_MEM(gc_prof_period);
+        gc_prof_sample(n_blocks * BYTES_PER_BLOCK);
+    }
+    #endif
+
     GC_EXIT();
 
     #if MICROPY_GC_CONSERVATIVE_CLEAR
@@ -921,7 +1895,7 @@ void gc_free(void *ptr) {
     #endif
 
     size_t block = BLOCK_FROM_PTR(area, ptr);
-    assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    assert(ATB_IS_HEAD(area, block));
 
     #if MICROPY_ENABLE_FINALISER
     FTB_CLEAR(area, block);
@@ -948,11 +1922,18 @@ void gc_free(void *ptr) {
     }
 
     // free head and all of its tail blocks
+    #if MICROPY_GC_FREE_INDEX
+    size_t start_block = block;
+    #endif
     do {
         ATB_ANY_TO_FREE(area, block);
         block += 1;
     } while (ATB_GET_KIND(area, block) == AT_TAIL);
 
+    #if MICROPY_GC_FREE_INDEX
+    gc_free_index_update(area, start_block, block - 1);
+    #endif
+
     GC_EXIT();
 
     #if EXTENSIVE_HEAP_PROFILING
@@ -976,7 +1957,7 @@ size_t gc_nbytes(const void *ptr) {
 
     if (area) {
         size_t block = BLOCK_FROM_PTR(area, ptr);
-        if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        if (ATB_IS_HEAD(area, block)) {
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
@@ -1051,7 +2032,7 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     area = &MP_STATE_MEM(area);
     #endif
     size_t block = BLOCK_FROM_PTR(area, ptr);
-    assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    assert(ATB_IS_HEAD(area, block));
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -1095,6 +2076,10 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
             ATB_ANY_TO_FREE(area, bl);
         }
 
+        #if MICROPY_GC_FREE_INDEX
+        gc_free_index_update(area, block + new_blocks, block + n_blocks - 1);
+        #endif
+
         #if MICROPY_GC_SPLIT_HEAP
         if (MP_STATE_MEM(gc_last_free_area) != area) {
             // See comment in gc_free.
@@ -1125,10 +2110,17 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
             ATB_FREE_TO_TAIL(area, bl);
         }
 
+        #if MICROPY_GC_FREE_INDEX
+        gc_free_index_update(area, block + n_blocks, end_block - 1);
+        #endif
+
         area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
         GC_EXIT();
 
+        // the caller may store pointers in the new blocks without a barrier
+        GC_WRITE_BARRIER(ptr_in);
+
         #if MICROPY_GC_CONSERVATIVE_CLEAR
         // be conservative and zero out all the newly allocated blocks
         memset((byte *)ptr_in + n_blocks * BYTES_PER_BLOCK, 0, (new_blocks - n_blocks) * BYTES_PER_BLOCK);
@@ -1150,6 +2142,10 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     bool ftb_state = false;
     #endif
 
+    #if MICROPY_GC_INCREMENTAL
+    bool marked = ATB_GET_KIND(area, block) == AT_MARK;
+    #endif
+
     GC_EXIT();
 
     if (!allow_move) {
@@ -1167,6 +2163,12 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
 
     DEBUG_printf("gc_realloc(%p -> %p)\n", ptr_in, ptr_out);
     memcpy(ptr_out, ptr_in, n_blocks * BYTES_PER_BLOCK);
+    #if MICROPY_GC_INCREMENTAL
+    if (marked) {
+        // the pointer to the new block may be stored in a block already scanned
+        GC_WRITE_BARRIER(ptr_out);
+    }
+    #endif
     gc_free(ptr_in);
     return ptr_out;
 }
@@ -55,6 +55,62 @@ void gc_collect_start(void);
 void gc_collect_root(void **ptrs, size_t len);
 void gc_collect_end(void);
 
+#if MICROPY_GC_PARALLEL_MARK
+// Does a share of the parallel mark phase of a collection.
+void gc_mark_worker(size_t worker);
+// Must be implemented by the port: calls gc_mark_worker(i) concurrently for
+// every i in [0, n_workers), on separate threads, and returns when all of
+// these calls have returned.  The caller's thread may be used as one worker.
+void gc_mark_run_workers(size_t n_workers);
+#endif
+
+#if MICROPY_GC_INCREMENTAL
+enum {
+    GC_INC_PHASE_NONE,
+    GC_INC_PHASE_MARK,
+    GC_INC_PHASE_FINISH,
+    GC_INC_PHASE_SWEEP,
+};
+
+// Does up to the given amount of incremental collection work (measured in
+// blocks marked or swept), starting a new cycle if none is in progress.
+// Returns true if this completed a cycle.
+bool gc_step(size_t work);
+
+// Enables or disables collection work being done automatically by gc_alloc
+// and the VM.
+void gc_step_auto(bool enable);
+
+// Called by the VM when MP_STATE_MEM(gc_inc_poll) is set.
+void gc_step_poll(void);
+
+// Whether an incremental cycle is marking, including the window between the
+// end of its steps and the port's gc_collect() finishing the mark.
+#define GC_INC_IS_MARKING() (MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_MARK \
+    || MP_STATE_MEM(gc_inc_phase) == GC_INC_PHASE_FINISH)
+
+// While an incremental cycle is marking, a block that was already scanned
+// won't be scanned again, so code that stores a heap pointer into an
+// existing heap object must tell the GC.  ptr must point to the start of the
+// heap block that was written to, or that was newly stored into an existing
+// object; it is kept alive and rescanned when marking finishes.  Blocks
+// allocated while marking are also kept alive and rescanned.
+void gc_write_barrier(const void *ptr);
+#define GC_WRITE_BARRIER(ptr) do { \
+        if (GC_INC_IS_MARKING()) { \
+            gc_write_barrier(ptr); \
+        } \
+} while (0)
+#else
+#define GC_WRITE_BARRIER(ptr) (void)0
+#endif
+
+#if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+// Clears the allocation-site table and samples every period'th allocation
+// from now on.  A period of 0 stops sampling and keeps the table.
+void gc_prof_start(size_t period);
+#endif
+
 // Use this function to sweep the whole heap and run all finalisers
 void gc_sweep_all(void);
 
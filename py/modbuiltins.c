@@ -33,6 +33,7 @@
 #include "py/objtype.h"
 #include "py/runtime.h"
 #include "py/builtin.h"
+#include "py/gc.h"
 #include "py/stream.h"
 
 #if MICROPY_PY_BUILTINS_FLOAT
@@ -27,6 +27,7 @@
 #include "py/mpstate.h"
 #include "py/obj.h"
 #include "py/gc.h"
+#include "py/mphal.h"
 
 #if MICROPY_PY_GC && MICROPY_ENABLE_GC
 
@@ -100,6 +101,35 @@ static mp_obj_t gc_threshold(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_threshold_obj, 0, 1, gc_threshold);
 #endif
 
+#if MICROPY_GC_INCREMENTAL
+// step([budget_us]): do incremental collection work for up to budget_us
+// microseconds, returning True if a collection cycle was completed
+static mp_obj_t gc_step_(size_t n_args, const mp_obj_t *args) {
+    mp_uint_t budget = n_args == 0 ? 1000 : mp_obj_get_int(args[0]);
+    mp_uint_t start = mp_hal_ticks_us();
+    do {
+        if (gc_is_locked()) {
+            break;
+        }
+        if (gc_step(256)) {
+            return mp_const_true;
+        }
+    } while (mp_hal_ticks_us() - start < budget);
+    return mp_const_false;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_step_obj, 0, 1, gc_step_);
+
+// incremental([enable]): get or set whether allocations drive incremental steps
+static mp_obj_t gc_incremental(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0) {
+        return mp_obj_new_bool(MP_STATE_MEM(gc_inc_auto));
+    }
+    gc_step_auto(mp_obj_is_true(args[0]));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_incremental_obj, 0, 1, gc_incremental);
+#endif
+
 static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_gc) },
     { MP_ROM_QSTR(MP_QSTR_collect), MP_ROM_PTR(&gc_collect_obj) },
@@ -111,6 +141,10 @@ static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     #if MICROPY_GC_ALLOC_THRESHOLD
     { MP_ROM_QSTR(MP_QSTR_threshold), MP_ROM_PTR(&gc_threshold_obj) },
     #endif
+    #if MICROPY_GC_INCREMENTAL
+    { MP_ROM_QSTR(MP_QSTR_step), MP_ROM_PTR(&gc_step_obj) },
+    { MP_ROM_QSTR(MP_QSTR_incremental), MP_ROM_PTR(&gc_incremental_obj) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_gc_globals, mp_module_gc_globals_table);
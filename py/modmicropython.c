@@ -142,6 +142,45 @@ static mp_obj_t mp_micropython_heap_locked(void) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_heap_locked_obj, mp_micropython_heap_locked);
 #endif
+
+#if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+static mp_obj_t mp_micropython_heap_profile(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 1) {
+        mp_int_t period = mp_obj_get_int(args[0]);
+        if (period < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        gc_prof_start(period);
+        return mp_const_none;
+    }
+
+    // pause sampling so that building the result doesn't count towards it
+    size_t period = MP_STATE_MEM(gc_prof_period);
+    MP_STATE_MEM(gc_prof_period) = 0;
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < MICROPY_PY_MICROPYTHON_HEAP_PROFILE_SITES; ++i) {
+        const mp_gc_prof_site_t *site = &MP_STATE_MEM(gc_prof_site)[i];
+        if (site->count == 0) {
+            continue;
+        }
+        mp_obj_t items[5] = {
+            mp_const_none,
+            mp_const_none,
+            MP_OBJ_NEW_SMALL_INT(site->line),
+            mp_obj_new_int_from_uint(site->count),
+            mp_obj_new_int_from_uint(site->bytes),
+        };
+        if (i != 0) {
+            items[0] = MP_OBJ_NEW_QSTR(site->source_file);
+            items[1] = MP_OBJ_NEW_QSTR(site->block_name);
+        }
+        mp_obj_list_append(list, mp_obj_new_tuple(5, items));
+    }
+    MP_STATE_MEM(gc_prof_period) = period;
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_heap_profile_obj, 0, 1, mp_micropython_heap_profile);
+#endif
 #endif
 
 #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && (MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0)
@@ -196,6 +235,9 @@ static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_PY_MICROPYTHON_HEAP_LOCKED
     { MP_ROM_QSTR(MP_QSTR_heap_locked), MP_ROM_PTR(&mp_micropython_heap_locked_obj) },
     #endif
+    #if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    { MP_ROM_QSTR(MP_QSTR_heap_profile), MP_ROM_PTR(&mp_micropython_heap_profile_obj) },
+    #endif
     #endif
     #if MICROPY_KBD_EXCEPTION
     { MP_ROM_QSTR(MP_QSTR_kbd_intr), MP_ROM_PTR(&mp_micropython_kbd_intr_obj) },
@@ -208,6 +208,14 @@
 #define MICROPY_ALLOC_QSTR_CHUNK_INIT (128)
 #endif
 
+// Whether to maintain an open-addressed hash index over the qstr pools that
+// are allocated at runtime.  Without it each lookup scans every dynamic pool
+// linearly, so interning gets slower as more qstrs are created.  The index
+// costs about two words of heap per dynamically interned qstr.
+#ifndef MICROPY_QSTR_HASH_INDEX
+#define MICROPY_QSTR_HASH_INDEX (0)
+#endif
+
 // Initial amount for lexer indentation level
 #ifndef MICROPY_ALLOC_LEXER_INDENT_INIT
 #define MICROPY_ALLOC_LEXER_INDENT_INIT (10)
@@ -391,6 +399,11 @@
 #define MICROPY_EMIT_ARM (0)
 #endif
 
+// Whether to emit ARM64 (AArch64) native code
+#ifndef MICROPY_EMIT_ARM64
+#define MICROPY_EMIT_ARM64 (0)
+#endif
+
 // Whether to emit Xtensa native code
 #ifndef MICROPY_EMIT_XTENSA
 #define MICROPY_EMIT_XTENSA (0)
@@ -407,7 +420,7 @@
 #endif
 
 // Convenience definition for whether any native emitter is enabled
-#define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_XTENSA || MICROPY_EMIT_XTENSAWIN)
+#define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_ARM64 || MICROPY_EMIT_XTENSA || MICROPY_EMIT_XTENSAWIN)
 
 // Some architectures cannot read byte-wise from executable memory.  In this case
 // the prelude for a native function (which usually sits after the machine code)
@@ -456,6 +469,20 @@
 #define MICROPY_COMP_CONST_FOLDING (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Whether constant folding also applies to floats, str/bytes/tuple concatenation
+// and repetition, and comparisons; eg "a" + "b" rewritten as "ab", X > 1 as True
+#ifndef MICROPY_COMP_CONST_FOLDING_EXTENDED
+#define MICROPY_COMP_CONST_FOLDING_EXTENDED (MICROPY_COMP_CONST_FOLDING && MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Whether extended constant folding also applies to floats; eg 2.0 ** 100 or 1 / 3.
+// A folded float is saved to a .mpy file as text that may not give back the same
+// value, and is computed at the host's float precision, so by default this is
+// disabled when compiling for another target (eg mpy-cross)
+#ifndef MICROPY_COMP_CONST_FOLDING_FLOAT
+#define MICROPY_COMP_CONST_FOLDING_FLOAT (MICROPY_COMP_CONST_FOLDING_EXTENDED && !MICROPY_DYNAMIC_COMPILER)
+#endif
+
 // Whether to compile constant tuples immediately to their respective objects; eg (1, True)
 // Otherwise the tuple will be built at runtime
 #ifndef MICROPY_COMP_CONST_TUPLE
@@ -572,12 +599,78 @@
 #define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
 #endif
 
+// Give each bytecode function a table of per-instruction caches for the
+// LOAD_GLOBAL, LOAD_ATTR and LOAD_METHOD opcodes, which remember where the
+// name was last found.  Costs RAM for each function that uses these opcodes
+// (up to 3 pointers per instruction, plus a heap block per cached site), but
+// avoids most map lookups and class hierarchy walks when running loops.
+#ifndef MICROPY_OPT_INLINE_CACHE
+#define MICROPY_OPT_INLINE_CACHE (0)
+#endif
+
+// Whether the VM rewrites BINARY_OP opcodes in bytecode that's in RAM into
+// forms specialised for small int, float or str operands, when it sees such
+// operands, and back again when it sees other types.  The specialised forms
+// skip the type dispatch in mp_binary_op.  Bytecode in ROM (eg frozen) is
+// not changed.
+#ifndef MICROPY_OPT_QUICKEN_BINARY_OP
+#define MICROPY_OPT_QUICKEN_BINARY_OP (0)
+#endif
+
+// Whether the bytecode compiler fuses some common sequences of opcodes into
+// single superinstructions (eg "x += 1" on a local, and a comparison followed
+// by a conditional jump), which the VM then runs with one dispatch.  .mpy files
+// that use them are marked, and can only be loaded by a VM with this enabled.
+// mpy-cross emits them when given -msuperinstructions.
+#ifndef MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+#define MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS (0)
+#endif
+
+// Whether the quickened float ops store their result in a float operand that
+// the VM knows is a dead temporary, instead of allocating a new float.  This
+// only applies where floats are objects on the heap.
+#ifndef MICROPY_OPT_REUSE_FLOAT_TEMPS
+#define MICROPY_OPT_REUSE_FLOAT_TEMPS (MICROPY_OPT_QUICKEN_BINARY_OP && MICROPY_PY_BUILTINS_FLOAT && (MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_B))
+#endif
+
+// Whether the GC scans its allocation table a machine word at a time when
+// searching for free blocks, sweeping and gathering heap info.  This is
+// mostly a benefit on 64-bit machines with large heaps, at some code size.
+#ifndef MICROPY_OPT_GC_WORD_SCAN
+#define MICROPY_OPT_GC_WORD_SCAN (0)
+#endif
+
+// Whether substring searches (str.find, in, replace, split, count etc) use the
+// Two-Way algorithm, which takes linear time, for all but short inputs.  The
+// simple search takes time proportional to the product of the lengths in the
+// worst case.  Increases code size by about 600 bytes.
+#ifndef MICROPY_OPT_STR_FIND_TWO_WAY
+#define MICROPY_OPT_STR_FIND_TWO_WAY (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Whether str objects created at runtime record if their data is pure ASCII,
+// so that indexing, slicing and len() of such strings take constant time, and
+// whether long non-ASCII strings get a lazily built index of character offsets
+// so that indexing them doesn't need a scan from the start of the string.
+// Only has an effect with MICROPY_PY_BUILTINS_STR_UNICODE.  The indices are
+// not built when threads run without the GIL.
+#ifndef MICROPY_OPT_STR_UNICODE_INDEX
+#define MICROPY_OPT_STR_UNICODE_INDEX (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
 #define MICROPY_OPT_MPZ_BITWISE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether mpz uses subquadratic algorithms for large numbers: Karatsuba
+// multiplication, recursive (Burnikel-Ziegler) division, and divide-and-conquer
+// conversion to and from strings.  The thresholds are set in py/mpz.h.
+#ifndef MICROPY_OPT_MPZ_SUBQUADRATIC
+#define MICROPY_OPT_MPZ_SUBQUADRATIC (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_FULL_FEATURES)
+#endif
+
 
 // Whether math.factorial is large, fast and recursive (1) or small and slow (0).
 #ifndef MICROPY_OPT_MATH_FACTORIAL
@@ -652,6 +745,74 @@
 #define MICROPY_GC_SPLIT_HEAP_AUTO (0)
 #endif
 
+// Whether the mark phase of a collection is shared between several worker
+// threads.  The port must then implement gc_mark_run_workers(), and the
+// compiler must provide the GCC __atomic builtins.
+#ifndef MICROPY_GC_PARALLEL_MARK
+#define MICROPY_GC_PARALLEL_MARK (0)
+#endif
+
+// Maximum number of worker threads (including the collecting thread) for
+// the parallel mark phase.
+#ifndef MICROPY_GC_PARALLEL_MARK_MAX_WORKERS
+#define MICROPY_GC_PARALLEL_MARK_MAX_WORKERS (8)
+#endif
+
+// Number of entries in each parallel mark worker's deque of blocks still to
+// be scanned.  When a deque fills up, the heap is rescanned afterwards in the
+// same way as for an overflow of the GC stack.  The deques are part of
+// mp_state_mem_t, so this directly adds to its size.
+#ifndef MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE
+#define MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE (256)
+#endif
+
+// Hook called by a parallel mark worker while it waits for work to steal.
+#ifndef MICROPY_GC_PARALLEL_MARK_IDLE
+#define MICROPY_GC_PARALLEL_MARK_IDLE()
+#endif
+
+// Whether to support incremental garbage collection, where a collection
+// cycle is split into bounded steps interleaved with the running program.
+// Stores of heap pointers into existing heap objects must then go through
+// GC_WRITE_BARRIER (see py/gc.h).
+#ifndef MICROPY_GC_INCREMENTAL
+#define MICROPY_GC_INCREMENTAL (0)
+#endif
+
+// Number of objects written to during the mark phase of an incremental
+// collection that are remembered for rescanning when marking finishes.  If
+// more are written then all marked blocks are rescanned instead.
+#ifndef MICROPY_GC_INCREMENTAL_DIRTY_SIZE
+#define MICROPY_GC_INCREMENTAL_DIRTY_SIZE (256)
+#endif
+
+// Number of runs of blocks allocated during the mark phase of an incremental
+// collection that are remembered for rescanning when marking finishes.  If
+// there are more then the last run is extended to cover the new blocks.
+#ifndef MICROPY_GC_INCREMENTAL_NEW_SIZE
+#define MICROPY_GC_INCREMENTAL_NEW_SIZE (32)
+#endif
+
+// Amount of incremental collection work, in blocks marked or swept, done for
+// each block allocated while a cycle is in progress.
+#ifndef MICROPY_GC_INCREMENTAL_WORK_PER_BLOCK
+#define MICROPY_GC_INCREMENTAL_WORK_PER_BLOCK (8)
+#endif
+
+// Amount of incremental collection work, in blocks marked or swept, done each
+// time the VM checks for pending events while a cycle is in progress.
+#ifndef MICROPY_GC_INCREMENTAL_POLL_WORK
+#define MICROPY_GC_INCREMENTAL_POLL_WORK (32)
+#endif
+
+// Whether to keep a summary of the free blocks in each chunk of the heap, so
+// that multi-block allocations can skip over fully-used regions rather than
+// scanning the allocation table block-by-block.  Costs a few bytes per 256
+// blocks of heap.
+#ifndef MICROPY_GC_FREE_INDEX
+#define MICROPY_GC_FREE_INDEX (0)
+#endif
+
 // Hook to run code during time consuming garbage collector operations
 // *i* is the loop index variable (e.g. can be used to run every x loops)
 #ifndef MICROPY_GC_HOOK_LOOP
@@ -1294,6 +1455,17 @@ typedef double mp_float_t;
 #define MICROPY_PY_MICROPYTHON_HEAP_LOCKED (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
 #endif
 
+// Whether to provide the "micropython.heap_profile" function, which samples
+// heap allocations and records the source line of the bytecode that made them
+#ifndef MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+#define MICROPY_PY_MICROPYTHON_HEAP_PROFILE (0)
+#endif
+
+// Number of distinct allocation sites recorded by "micropython.heap_profile"
+#ifndef MICROPY_PY_MICROPYTHON_HEAP_PROFILE_SITES
+#define MICROPY_PY_MICROPYTHON_HEAP_PROFILE_SITES (64)
+#endif
+
 // Whether to provide "array" module. Note that large chunk of the
 // underlying code is shared with "bytearray" builtin type, so to
 // get real savings, it should be disabled too.
@@ -1630,6 +1802,25 @@ typedef double mp_float_t;
 #define MICROPY_PY_DEFLATE_COMPRESS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_FULL_FEATURES)
 #endif
 
+// Whether to support compression levels 1-9 in "deflate" module, which use
+// hash chains and dynamic Huffman blocks and need more RAM
+#ifndef MICROPY_PY_DEFLATE_COMPRESS_LEVEL
+#define MICROPY_PY_DEFLATE_COMPRESS_LEVEL (MICROPY_PY_DEFLATE_COMPRESS)
+#endif
+
+// Whether to decompress with Huffman lookup tables, and read ahead in blocks
+// from seekable source streams, at the cost of about 3.4KB more RAM for each
+// decompressor
+#ifndef MICROPY_PY_DEFLATE_FAST_INFLATE
+#define MICROPY_PY_DEFLATE_FAST_INFLATE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
+#endif
+
+// Whether to use faster CRC32 and Adler32 routines for "deflate" and
+// binascii.crc32, at the cost of 8KB of tables and some code size
+#ifndef MICROPY_PY_DEFLATE_FAST_CHECKSUM
+#define MICROPY_PY_DEFLATE_FAST_CHECKSUM (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
+#endif
+
 #ifndef MICROPY_PY_JSON
 #define MICROPY_PY_JSON (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -1639,6 +1830,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_JSON_SEPARATORS (1)
 #endif
 
+// Size in bytes of the chunks that json.load reads from its stream
+#ifndef MICROPY_PY_JSON_LOAD_CHUNK_SIZE
+#define MICROPY_PY_JSON_LOAD_CHUNK_SIZE (256)
+#endif
+
 #ifndef MICROPY_PY_OS
 #define MICROPY_PY_OS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -1667,6 +1863,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_RE_SUB (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether to run ambiguous patterns, like "(a*)*", with a Pike VM which takes
+// linear time, instead of backtracking, and to find the start of a search
+// with memchr when the pattern starts with a literal character
+#ifndef MICROPY_PY_RE_PIKEVM
+#define MICROPY_PY_RE_PIKEVM (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 #ifndef MICROPY_PY_HEAPQ
 #define MICROPY_PY_HEAPQ (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -63,6 +63,7 @@ typedef struct mp_dynamic_compiler_t {
     uint8_t small_int_bits; // must be <= host small_int_bits
     uint8_t native_arch;
     uint8_t nlr_buf_num_regs;
+    bool bytecode_superinstructions; // requires MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
 } mp_dynamic_compiler_t;
 extern mp_dynamic_compiler_t mp_dynamic_compiler;
 #endif
@@ -77,6 +78,15 @@ typedef struct _mp_sched_item_t {
     mp_obj_t arg;
 } mp_sched_item_t;
 
+#if MICROPY_GC_FREE_INDEX
+// Summary of the free blocks within one chunk of the GC heap, see gc.c.
+typedef struct _mp_gc_free_index_t {
+    uint16_t lead; // number of free blocks at the start of the chunk
+    uint16_t trail; // number of free blocks at the end of the chunk
+    uint16_t longest; // longest run of free blocks within the chunk
+} mp_gc_free_index_t;
+#endif
+
 // This structure holds information about a single contiguous area of
 // memory reserved for the memory manager.
 typedef struct _mp_state_mem_area_t {
@@ -91,11 +101,40 @@ typedef struct _mp_state_mem_area_t {
     #endif
     byte *gc_pool_start;
     byte *gc_pool_end;
+    #if MICROPY_GC_FREE_INDEX
+    mp_gc_free_index_t *gc_free_index;
+    #endif
 
     size_t gc_last_free_atb_index;
     size_t gc_last_used_block; // The block ID of the highest block allocated in the area
 } mp_state_mem_area_t;
 
+#if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+// Sampled allocations made by one source line, see micropython.heap_profile.
+typedef struct _mp_gc_prof_site_t {
+    qstr source_file;
+    qstr block_name;
+    size_t line;
+    size_t count;
+    size_t bytes;
+} mp_gc_prof_site_t;
+#endif
+
+#if MICROPY_GC_PARALLEL_MARK
+// A parallel mark worker's queue of marked blocks whose children still need
+// to be scanned.  The owner pushes and pops at the bottom, other workers
+// steal from the top.
+typedef struct _mp_gc_mark_deque_t {
+    mp_thread_mutex_t mutex;
+    size_t top;
+    size_t len;
+    MICROPY_GC_STACK_ENTRY_TYPE block[MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE];
+    #if MICROPY_GC_SPLIT_HEAP
+    struct _mp_state_mem_area_t *area[MICROPY_GC_PARALLEL_MARK_DEQUE_SIZE];
+    #endif
+} mp_gc_mark_deque_t;
+#endif
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
@@ -127,6 +166,54 @@ typedef struct _mp_state_mem_t {
     mp_state_mem_area_t *gc_last_free_area;
     #endif
 
+    #if MICROPY_GC_PARALLEL_MARK
+    // Number of threads to use for the mark phase, may be set by the port.
+    size_t gc_mark_n_workers;
+    size_t gc_mark_n_active;
+    size_t gc_mark_seed_next;
+    mp_gc_mark_deque_t gc_mark_deque[MICROPY_GC_PARALLEL_MARK_MAX_WORKERS];
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL
+    // State of the incremental collector, see gc_step.
+    uint8_t gc_inc_phase;
+    // Whether allocations and the VM drive incremental collection.
+    uint8_t gc_inc_auto;
+    // Set when the VM should call gc_step_poll.
+    uint8_t gc_inc_poll;
+    bool gc_inc_dirty_overflow;
+    // Number of entries of gc_block_stack still to be scanned.
+    size_t gc_inc_sp;
+    // Blocks allocated since the last cycle started, and the amount at which
+    // the next cycle is started.
+    size_t gc_inc_alloc_amount;
+    size_t gc_inc_trigger;
+    // Position of the incremental sweep.
+    mp_state_mem_area_t *gc_inc_sweep_area;
+    size_t gc_inc_sweep_block;
+    // Blocks written to during the mark phase, rescanned when it finishes.
+    size_t gc_inc_dirty_len;
+    MICROPY_GC_STACK_ENTRY_TYPE gc_inc_dirty_block[MICROPY_GC_INCREMENTAL_DIRTY_SIZE];
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *gc_inc_dirty_area[MICROPY_GC_INCREMENTAL_DIRTY_SIZE];
+    #endif
+    // Runs of blocks allocated during the mark phase, also rescanned.
+    size_t gc_inc_new_len;
+    MICROPY_GC_STACK_ENTRY_TYPE gc_inc_new_start[MICROPY_GC_INCREMENTAL_NEW_SIZE];
+    MICROPY_GC_STACK_ENTRY_TYPE gc_inc_new_end[MICROPY_GC_INCREMENTAL_NEW_SIZE];
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *gc_inc_new_area[MICROPY_GC_INCREMENTAL_NEW_SIZE];
+    #endif
+    #endif
+
+    #if MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    // Every gc_prof_period'th allocation is sampled, 0 when not profiling.
+    size_t gc_prof_period;
+    size_t gc_prof_countdown;
+    // Entry 0 counts samples that couldn't be attributed to a source line.
+    mp_gc_prof_site_t gc_prof_site[MICROPY_PY_MICROPYTHON_HEAP_PROFILE_SITES];
+    #endif
+
     #if MICROPY_PY_GC_COLLECT_RETVAL
     size_t gc_collected;
     #endif
@@ -149,6 +236,10 @@ typedef struct _mp_state_vm_t {
 
     qstr_pool_t *last_pool;
 
+    #if MICROPY_QSTR_HASH_INDEX
+    qstr_index_t *qstr_index;
+    #endif
+
     #if MICROPY_TRACKED_ALLOC
     struct _m_tracked_node_t *m_tracked_head;
     #endif
@@ -247,6 +338,12 @@ typedef struct _mp_state_vm_t {
     // See mp_map_lookup.
     uint8_t map_lookup_cache[MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE];
     #endif
+
+    #if MICROPY_OPT_INLINE_CACHE
+    // Incremented when an attribute is added to or deleted from a class, which
+    // invalidates all inline cache entries for class attributes.
+    size_t inline_cache_epoch;
+    #endif
 } mp_state_vm_t;
 
 // This structure holds state that is specific to a given thread. Everything
@@ -291,6 +388,10 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
+    #endif
+
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    // The bytecode function currently being executed by this thread.
     struct _mp_code_state_t *current_code_state;
     #endif
 } mp_state_thread_t;
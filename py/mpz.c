@@ -427,12 +427,161 @@ static size_t mpn_mul_dig_add_dig(mpz_dig_t *idig, size_t ilen, mpz_dig_t dmul,
     return idig - oidig;
 }
 
+#if MICROPY_OPT_MPZ_SUBQUADRATIC
+
+#if MPZ_KARATSUBA_THRESHOLD < 4
+#error MPZ_KARATSUBA_THRESHOLD must be at least 4
+#endif
+#if MPZ_DIV_THRESHOLD < 2 || MPZ_STR_THRESHOLD < 2
+#error MPZ_DIV_THRESHOLD and MPZ_STR_THRESHOLD must be at least 2
+#endif
+
+static size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *kdig, size_t klen);
+
+/* computes i = i + j
+   returns the carry out of i
+   assumes ilen >= jlen
+*/
+static mpz_dig_t mpn_add_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_t carry = 0;
+
+    ilen -= jlen;
+
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        carry += (mpz_dbl_dig_t)*idig + (mpz_dbl_dig_t)*jdig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    for (; ilen > 0 && carry != 0; --ilen, ++idig) {
+        carry += *idig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    return carry;
+}
+
+/* computes i = i - j
+   assumes ilen >= jlen; assumes i >= j
+*/
+static void mpn_sub_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_signed_t borrow = 0;
+
+    ilen -= jlen;
+
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        borrow += (mpz_dbl_dig_t)*idig - (mpz_dbl_dig_t)*jdig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+
+    for (; ilen > 0 && borrow != 0; --ilen, ++idig) {
+        borrow += *idig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+}
+
+/* returns the number of scratch digits needed by mpn_mul_karatsuba for n digits */
+static size_t mpn_karatsuba_scratch(size_t n) {
+    size_t size = 0;
+    while (n >= MPZ_KARATSUBA_THRESHOLD) {
+        n = n - n / 2 + 1;
+        size += 4 * n;
+    }
+    return size;
+}
+
+/* computes i = j * k, where j and k have n digits each
+   all 2n digits of i are written; j, k need not be normalised
+   t is scratch memory of mpn_karatsuba_scratch(n) digits
+   can have j, k point to same memory, but not to i or t
+*/
+static void mpn_mul_karatsuba(mpz_dig_t *idig, mpz_dig_t *jdig, mpz_dig_t *kdig, size_t n, mpz_dig_t *t) {
+    if (n < MPZ_KARATSUBA_THRESHOLD) {
+        memset(idig, 0, 2 * n * sizeof(mpz_dig_t));
+        mpn_mul(idig, jdig, n, kdig, n);
+        return;
+    }
+
+    // split j = j1 * B^h + j0 and k = k1 * B^h + k0, with j1, k1 having m >= h digits
+    size_t h = n / 2;
+    size_t m = n - h;
+
+    // low part of i is j0 * k0, and high part is j1 * k1
+    mpn_mul_karatsuba(idig, jdig, kdig, h, t);
+    mpn_mul_karatsuba(idig + 2 * h, jdig + h, kdig + h, m, t);
+
+    // compute (j0 + j1) * (k0 + k1) - j0 * k0 - j1 * k1 = j0 * k1 + j1 * k0
+    mpz_dig_t *sj = t;
+    mpz_dig_t *sk = sj + m + 1;
+    mpz_dig_t *mid = sk + m + 1;
+    memcpy(sj, jdig + h, m * sizeof(mpz_dig_t));
+    sj[m] = mpn_add_inpl(sj, m, jdig, h);
+    memcpy(sk, kdig + h, m * sizeof(mpz_dig_t));
+    sk[m] = mpn_add_inpl(sk, m, kdig, h);
+    mpn_mul_karatsuba(mid, sj, sk, m + 1, mid + 2 * (m + 1));
+    mpn_sub_inpl(mid, 2 * (m + 1), idig, 2 * h);
+    mpn_sub_inpl(mid, 2 * (m + 1), idig + 2 * h, 2 * m);
+
+    // the middle term is less than 2 * B^n, so has at most n + 1 digits
+    mpn_add_inpl(idig + h, 2 * n - h, mid, n + 1);
+}
+
+/* computes i = j * k using Karatsuba multiplication
+   returns number of digits in i
+   assumes enough memory in i; assumes i is zeroed; assumes normalised j, k
+   can have j, k point to same memory
+*/
+static size_t mpn_mul_large(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *kdig, size_t klen) {
+    if (jlen < klen) {
+        mpz_dig_t *temp = jdig;
+        jdig = kdig;
+        kdig = temp;
+        size_t temp_len = jlen;
+        jlen = klen;
+        klen = temp_len;
+    }
+
+    // multiply k by pieces of j of klen digits, adding the products to i
+    size_t t_len = 2 * klen + mpn_karatsuba_scratch(klen);
+    mpz_dig_t *t = m_new(mpz_dig_t, t_len);
+    for (size_t off = 0; off < jlen; off += klen) {
+        size_t n = jlen - off;
+        if (n >= klen) {
+            n = klen;
+            mpn_mul_karatsuba(t, jdig + off, kdig, klen, t + 2 * klen);
+        } else {
+            // the last piece is normalised as it has the top digit of j
+            memset(t, 0, (n + klen) * sizeof(mpz_dig_t));
+            mpn_mul(t, jdig + off, n, kdig, klen);
+        }
+        mpn_add_inpl(idig + off, jlen + klen - off, t, n + klen);
+    }
+    m_del(mpz_dig_t, t, t_len);
+
+    size_t ilen = jlen + klen;
+    while (ilen > 0 && idig[ilen - 1] == 0) {
+        --ilen;
+    }
+    return ilen;
+}
+
+#endif
+
 /* computes i = j * k
    returns number of digits in i
    assumes enough memory in i; assumes i is zeroed; assumes normalised j, k
    can have j, k point to same memory
 */
 static size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *kdig, size_t klen) {
+    #if MICROPY_OPT_MPZ_SUBQUADRATIC
+    if (jlen >= MPZ_KARATSUBA_THRESHOLD && klen >= MPZ_KARATSUBA_THRESHOLD) {
+        return mpn_mul_large(idig, jdig, jlen, kdig, klen);
+    }
+    #endif
+
     mpz_dig_t *oidig = idig;
     size_t ilen = 0;
 
@@ -813,6 +962,81 @@ void mpz_set_from_float(mpz_t *z, mp_float_t src) {
 }
 #endif
 
+// returns the value of a digit character, or 36 or more if it's not a digit
+static mp_uint_t mpz_char_value(mp_uint_t v) {
+    if ('0' <= v && v <= '9') {
+        v -= '0';
+    } else if ('A' <= v && v <= 'Z') {
+        v -= 'A' - 10;
+    } else if ('a' <= v && v <= 'z') {
+        v -= 'a' - 10;
+    } else {
+        v = 36;
+    }
+    return v;
+}
+
+// returns the largest power of base that fits in a digit, and sets *n to the exponent
+static mpz_dig_t mpz_base_chunk(unsigned int base, size_t *n) {
+    mpz_dig_t chunk = base;
+    *n = 1;
+    while (chunk <= DIG_MASK / base) {
+        chunk *= base;
+        ++*n;
+    }
+    return chunk;
+}
+
+// sets z to the non-negative value of str, whose characters are all valid digits
+static void mpz_set_from_digits(mpz_t *z, const char *str, size_t len, unsigned int base) {
+    size_t chunk_len;
+    mpz_base_chunk(base, &chunk_len);
+
+    mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
+    z->neg = 0;
+    z->len = 0;
+
+    // convert a chunk of characters at a time, the first one being partial
+    size_t n = len % chunk_len;
+    if (n == 0) {
+        n = chunk_len;
+    }
+    while (len > 0) {
+        mpz_dig_t mul = 1;
+        mpz_dig_t val = 0;
+        for (; n > 0; --n, --len, ++str) { // XXX UTF8 next char
+            mul *= base;
+            val = val * base + mpz_char_value(*str);
+        }
+        z->len = mpn_mul_dig_add_dig(z->dig, z->len, mul, val);
+        n = chunk_len;
+    }
+}
+
+#if MICROPY_OPT_MPZ_SUBQUADRATIC
+// pw[i] is base ** (chunk_len * 2 ** i)
+static void mpz_set_from_digits_large(mpz_t *z, const char *str, size_t len, unsigned int base, size_t chunk_len, mpz_t *pw) {
+    if (len < MPZ_STR_THRESHOLD * chunk_len) {
+        mpz_set_from_digits(z, str, len, base);
+        return;
+    }
+
+    // split off the low w characters, where w < len <= 2 * w
+    size_t level = 0;
+    while ((chunk_len << (level + 1)) < len) {
+        ++level;
+    }
+    size_t w = chunk_len << level;
+    mpz_t low;
+    mpz_init_zero(&low);
+    mpz_set_from_digits_large(z, str, len - w, base, chunk_len, pw);
+    mpz_set_from_digits_large(&low, str + len - w, w, base, chunk_len, pw);
+    mpz_mul_inpl(z, z, &pw[level]);
+    mpz_add_inpl(z, z, &low);
+    mpz_deinit(&low);
+}
+#endif
+
 // returns number of bytes from str that were processed
 size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
     assert(base <= 36);
@@ -820,7 +1044,33 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
     const char *cur = str;
     const char *top = str + len;
 
-    mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
+    // find the end of the digits
+    for (; cur < top && mpz_char_value(*cur) < base; ++cur) { // XXX UTF8 next char
+    }
+    len = cur - str;
+
+    #if MICROPY_OPT_MPZ_SUBQUADRATIC
+    size_t chunk_len;
+    mpz_dig_t chunk = mpz_base_chunk(base, &chunk_len);
+    if (len >= MPZ_STR_THRESHOLD * chunk_len) {
+        // divide and conquer, using powers of the base from the chunk upwards
+        mpz_t pw[8 * sizeof(size_t)];
+        size_t num_pw = 1;
+        mpz_init_from_int(&pw[0], chunk);
+        while ((chunk_len << num_pw) < len) {
+            mpz_init_zero(&pw[num_pw]);
+            mpz_mul_inpl(&pw[num_pw], &pw[num_pw - 1], &pw[num_pw - 1]);
+            ++num_pw;
+        }
+        mpz_set_from_digits_large(z, str, len, base, chunk_len, pw);
+        while (num_pw > 0) {
+            mpz_deinit(&pw[--num_pw]);
+        }
+    } else
+    #endif
+    {
+        mpz_set_from_digits(z, str, len, base);
+    }
 
     if (neg) {
         z->neg = 1;
@@ -828,26 +1078,7 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
         z->neg = 0;
     }
 
-    z->len = 0;
-    for (; cur < top; ++cur) { // XXX UTF8 next char
-        // mp_uint_t v = char_to_numeric(cur#); // XXX UTF8 get char
-        mp_uint_t v = *cur;
-        if ('0' <= v && v <= '9') {
-            v -= '0';
-        } else if ('A' <= v && v <= 'Z') {
-            v -= 'A' - 10;
-        } else if ('a' <= v && v <= 'z') {
-            v -= 'a' - 10;
-        } else {
-            break;
-        }
-        if (v >= base) {
-            break;
-        }
-        z->len = mpn_mul_dig_add_dig(z->dig, z->len, base, v);
-    }
-
-    return cur - str;
+    return len;
 }
 
 void mpz_set_from_bytes(mpz_t *z, bool big_endian, size_t len, const byte *buf) {
@@ -1474,6 +1705,156 @@ mpz_t *mpz_lcm(const mpz_t *z1, const mpz_t *z2) {
 }
 #endif
 
+#if MICROPY_OPT_MPZ_SUBQUADRATIC
+
+/* sets v to a read-only view of the non-negative value of digits [lo, hi) of z
+   v must not be written to, and is only valid while z is unchanged
+*/
+static void mpz_view(mpz_t *v, const mpz_t *z, size_t lo, size_t hi) {
+    if (hi > z->len) {
+        hi = z->len;
+    }
+    if (lo > hi) {
+        lo = hi;
+    }
+    while (hi > lo && z->dig[hi - 1] == 0) {
+        --hi;
+    }
+    v->neg = 0;
+    v->fixed_dig = 1;
+    v->alloc = hi - lo;
+    v->len = hi - lo;
+    v->dig = z->dig + lo;
+}
+
+static void mpz_div2n1n(mpz_t *quo, mpz_t *rem, const mpz_t *a, const mpz_t *b, size_t n);
+
+/* computes quo, rem of [a12, a3] / b, where b = [b1, b2] has 2n digits, a3 and
+   b2 have n digits, and a12 < b
+*/
+static void mpz_div3n2n(mpz_t *quo, mpz_t *rem, const mpz_t *a12, const mpz_t *a3,
+    const mpz_t *b, const mpz_t *b1, const mpz_t *b2, size_t n) {
+    mpz_t t;
+    mpz_view(&t, a12, n, 2 * n);
+    if (mpz_cmp(&t, b1) == 0) {
+        // quotient estimate is B^n - 1, with remainder a12 - b1 * B^n + b1
+        mpz_need_dig(quo, n);
+        for (size_t i = 0; i < n; ++i) {
+            quo->dig[i] = DIG_MASK;
+        }
+        quo->len = n;
+        quo->neg = 0;
+        mpz_view(&t, a12, 0, n);
+        mpz_add_inpl(rem, &t, b1);
+    } else {
+        mpz_div2n1n(quo, rem, a12, b1, n);
+    }
+
+    // rem = rem * B^n + a3 - quo * b2, correcting the estimate while negative
+    mpz_shl_inpl(rem, rem, n * DIG_SIZE);
+    mpz_add_inpl(rem, rem, a3);
+    mpz_init_zero(&t);
+    mpz_mul_inpl(&t, quo, b2);
+    mpz_sub_inpl(rem, rem, &t);
+    mpz_deinit(&t);
+    mpz_t one;
+    mpz_dig_t one_dig[MPZ_NUM_DIG_FOR_INT];
+    mpz_init_fixed_from_int(&one, one_dig, MPZ_NUM_DIG_FOR_INT, 1);
+    while (rem->neg) {
+        mpz_sub_inpl(quo, quo, &one);
+        mpz_add_inpl(rem, rem, b);
+    }
+}
+
+/* computes quo, rem of a / b, where b has n digits and its top bit set, and
+   a < b * B^n
+*/
+static void mpz_div2n1n(mpz_t *quo, mpz_t *rem, const mpz_t *a, const mpz_t *b, size_t n) {
+    if (n < MPZ_DIV_THRESHOLD) {
+        mpz_divmod_inpl(quo, rem, a, b);
+        return;
+    }
+
+    if (n & 1) {
+        // make n even by multiplying a and b by B
+        mpz_t a2, b2;
+        mpz_init_zero(&a2);
+        mpz_init_zero(&b2);
+        mpz_shl_inpl(&a2, a, DIG_SIZE);
+        mpz_shl_inpl(&b2, b, DIG_SIZE);
+        mpz_div2n1n(quo, rem, &a2, &b2, n + 1);
+        mpz_shr_inpl(rem, rem, DIG_SIZE);
+        mpz_deinit(&a2);
+        mpz_deinit(&b2);
+        return;
+    }
+
+    // divide the top 3 halves of a by b, then the remainder and the last half
+    size_t h = n / 2;
+    mpz_t b1, b2, a12, a3, q1, r1;
+    mpz_view(&b1, b, h, n);
+    mpz_view(&b2, b, 0, h);
+    mpz_view(&a12, a, n, 2 * n);
+    mpz_view(&a3, a, h, n);
+    mpz_init_zero(&q1);
+    mpz_init_zero(&r1);
+    mpz_div3n2n(&q1, &r1, &a12, &a3, b, &b1, &b2, h);
+    mpz_view(&a3, a, 0, h);
+    mpz_div3n2n(quo, rem, &r1, &a3, b, &b1, &b2, h);
+    mpz_shl_inpl(&q1, &q1, h * DIG_SIZE);
+    mpz_add_inpl(quo, quo, &q1);
+    mpz_deinit(&q1);
+    mpz_deinit(&r1);
+}
+
+/* computes quo, rem of abs(lhs) / abs(rhs) with Burnikel-Ziegler recursive division
+   quo, rem must not be the same as lhs, rhs
+*/
+static void mpz_divmod_recursive(mpz_t *quo, mpz_t *rem, const mpz_t *lhs, const mpz_t *rhs) {
+    // normalise so that the top bit of b is set
+    mp_uint_t shift = 0;
+    for (mpz_dig_t d = rhs->dig[rhs->len - 1]; !(d & DIG_MSB); d <<= 1) {
+        ++shift;
+    }
+    mpz_t a, b, t, c, q;
+    mpz_init_zero(&a);
+    mpz_init_zero(&b);
+    mpz_init_zero(&t);
+    mpz_init_zero(&q);
+    mpz_abs_inpl(&a, lhs);
+    mpz_shl_inpl(&a, &a, shift);
+    mpz_abs_inpl(&b, rhs);
+    mpz_shl_inpl(&b, &b, shift);
+
+    // divide each piece of n digits of a, from the top, appended to the
+    // remainder so far
+    size_t n = b.len;
+    size_t num = (a.len + n - 1) / n;
+    mpz_need_dig(quo, num * n);
+    memset(quo->dig, 0, num * n * sizeof(mpz_dig_t));
+    mpz_set_from_int(rem, 0);
+    for (size_t i = num; i-- > 0;) {
+        mpz_view(&c, &a, i * n, (i + 1) * n);
+        mpz_shl_inpl(&t, rem, n * DIG_SIZE);
+        mpz_add_inpl(&t, &t, &c);
+        mpz_div2n1n(&q, rem, &t, &b, n);
+        memcpy(quo->dig + i * n, q.dig, q.len * sizeof(mpz_dig_t));
+    }
+    quo->neg = 0;
+    quo->len = num * n;
+    while (quo->len > 0 && quo->dig[quo->len - 1] == 0) {
+        --quo->len;
+    }
+    mpz_shr_inpl(rem, rem, shift);
+
+    mpz_deinit(&a);
+    mpz_deinit(&b);
+    mpz_deinit(&t);
+    mpz_deinit(&q);
+}
+
+#endif
+
 /* computes new integers in quo and rem such that:
        quo * rhs + rem = lhs
        0 <= rem < rhs
@@ -1483,14 +1864,30 @@ mpz_t *mpz_lcm(const mpz_t *z1, const mpz_t *z2) {
 void mpz_divmod_inpl(mpz_t *dest_quo, mpz_t *dest_rem, const mpz_t *lhs, const mpz_t *rhs) {
     assert(!mpz_is_zero(rhs));
 
-    mpz_need_dig(dest_quo, lhs->len + 1); // +1 necessary?
-    memset(dest_quo->dig, 0, (lhs->len + 1) * sizeof(mpz_dig_t));
-    dest_quo->neg = 0;
-    dest_quo->len = 0;
-    mpz_need_dig(dest_rem, lhs->len + 1); // +1 necessary?
-    mpz_set(dest_rem, lhs);
-    mpn_div(dest_rem->dig, &dest_rem->len, rhs->dig, rhs->len, dest_quo->dig, &dest_quo->len);
-    dest_rem->neg &= !!dest_rem->len;
+    #if MICROPY_OPT_MPZ_SUBQUADRATIC
+    if (rhs->len >= MPZ_DIV_THRESHOLD && lhs->len >= rhs->len + MPZ_DIV_THRESHOLD) {
+        // compute into temporaries as dest_quo, dest_rem may be lhs, rhs
+        mpz_t quo, rem;
+        mpz_init_zero(&quo);
+        mpz_init_zero(&rem);
+        mpz_divmod_recursive(&quo, &rem, lhs, rhs);
+        rem.neg = lhs->neg & !!rem.len;
+        mpz_set(dest_quo, &quo);
+        mpz_set(dest_rem, &rem);
+        mpz_deinit(&quo);
+        mpz_deinit(&rem);
+    } else
+    #endif
+    {
+        mpz_need_dig(dest_quo, lhs->len + 1); // +1 necessary?
+        memset(dest_quo->dig, 0, (lhs->len + 1) * sizeof(mpz_dig_t));
+        dest_quo->neg = 0;
+        dest_quo->len = 0;
+        mpz_need_dig(dest_rem, lhs->len + 1); // +1 necessary?
+        mpz_set(dest_rem, lhs);
+        mpn_div(dest_rem->dig, &dest_rem->len, rhs->dig, rhs->len, dest_quo->dig, &dest_quo->len);
+        dest_rem->neg &= !!dest_rem->len;
+    }
 
     // check signs and do Python style modulo
     if (lhs->neg != rhs->neg) {
@@ -1657,6 +2054,103 @@ char *mpz_as_str(const mpz_t *i, unsigned int base) {
 }
 #endif
 
+/* writes the digits of i to str, least significant first, padded with zeros
+   to at least width characters
+   returns the end of the digits written; i is destroyed
+*/
+static char *mpn_as_str(char *str, mpz_dig_t *idig, size_t ilen, unsigned int base, char base_char, size_t width) {
+    size_t chunk_len;
+    mpz_dig_t chunk = mpz_base_chunk(base, &chunk_len);
+
+    char *s = str;
+    while (ilen > 0) {
+        mpz_dig_t *d = idig + ilen;
+        mpz_dbl_dig_t a = 0;
+
+        // compute next remainder, for a chunk of characters
+        while (--d >= idig) {
+            a = (a << DIG_SIZE) | *d;
+            *d = a / chunk;
+            a %= chunk;
+        }
+        while (ilen > 0 && idig[ilen - 1] == 0) {
+            --ilen;
+        }
+
+        // convert to characters, without leading zeros for the top chunk
+        for (size_t n = chunk_len; n > 0 && (ilen > 0 || a != 0); --n) {
+            mpz_dbl_dig_t c = a % base + '0';
+            a /= base;
+            if (c > '9') {
+                c += base_char - '9' - 1;
+            }
+            *s++ = c;
+        }
+    }
+
+    while ((size_t)(s - str) < width) {
+        *s++ = '0';
+    }
+
+    return s;
+}
+
+#if MICROPY_OPT_MPZ_SUBQUADRATIC
+/* writes the digits of z to str like mpn_as_str, where pw[i] is the base to the
+   power of chunk_len * 2 ** i; if pad is true then z < pw[level] and exactly
+   chunk_len * 2 ** level digits are written
+*/
+static char *mpz_as_str_rec(char *str, const mpz_t *z, unsigned int base, char base_char,
+    size_t chunk_len, mpz_t *pw, size_t level, bool pad) {
+    if (level == 0 || z->len < MPZ_STR_THRESHOLD) {
+        mpz_dig_t *dig = m_new(mpz_dig_t, z->len);
+        memcpy(dig, z->dig, z->len * sizeof(mpz_dig_t));
+        str = mpn_as_str(str, dig, z->len, base, base_char, pad ? chunk_len << level : 0);
+        m_del(mpz_dig_t, dig, z->len);
+        return str;
+    }
+
+    --level;
+    if (!pad && mpz_cmp(z, &pw[level]) < 0) {
+        return mpz_as_str_rec(str, z, base, base_char, chunk_len, pw, level, false);
+    }
+
+    // the low part is padded with zeros, the high part only if z is
+    mpz_t quo, rem;
+    mpz_init_zero(&quo);
+    mpz_init_zero(&rem);
+    mpz_divmod_inpl(&quo, &rem, z, &pw[level]);
+    str = mpz_as_str_rec(str, &rem, base, base_char, chunk_len, pw, level, true);
+    str = mpz_as_str_rec(str, &quo, base, base_char, chunk_len, pw, level, pad);
+    mpz_deinit(&quo);
+    mpz_deinit(&rem);
+    return str;
+}
+
+static char *mpz_as_str_large(char *str, const mpz_t *i, unsigned int base, char base_char) {
+    mpz_t z;
+    mpz_view(&z, i, 0, i->len);
+
+    // compute powers of the base up to about the square root of z
+    size_t chunk_len;
+    mpz_t pw[8 * sizeof(size_t)];
+    size_t num_pw = 1;
+    mpz_init_from_int(&pw[0], mpz_base_chunk(base, &chunk_len));
+    while (2 * pw[num_pw - 1].len <= z.len) {
+        mpz_init_zero(&pw[num_pw]);
+        mpz_mul_inpl(&pw[num_pw], &pw[num_pw - 1], &pw[num_pw - 1]);
+        ++num_pw;
+    }
+
+    str = mpz_as_str_rec(str, &z, base, base_char, chunk_len, pw, num_pw, false);
+
+    while (num_pw > 0) {
+        mpz_deinit(&pw[--num_pw]);
+    }
+    return str;
+}
+#endif
+
 // assumes enough space in str as calculated by mp_int_format_size
 // base must be between 2 and 32 inclusive
 // returns length of string, not including null byte
@@ -1678,48 +2172,31 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
         return s - str;
     }
 
-    // make a copy of mpz digits, so we can do the div/mod calculation
-    mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
-    memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
-
-    // convert
-    char *last_comma = str;
-    bool done;
-    do {
-        mpz_dig_t *d = dig + ilen;
-        mpz_dbl_dig_t a = 0;
-
-        // compute next remainder
-        while (--d >= dig) {
-            a = (a << DIG_SIZE) | *d;
-            *d = a / base;
-            a %= base;
-        }
-
-        // convert to character
-        a += '0';
-        if (a > '9') {
-            a += base_char - '9' - 1;
-        }
-        *s++ = a;
-
-        // check if number is zero
-        done = true;
-        for (d = dig; d < dig + ilen; ++d) {
-            if (*d != 0) {
-                done = false;
-                break;
+    #if MICROPY_OPT_MPZ_SUBQUADRATIC
+    if (ilen >= MPZ_STR_THRESHOLD) {
+        s = mpz_as_str_large(s, i, base, base_char);
+    } else
+    #endif
+    {
+        // make a copy of mpz digits, so we can do the div/mod calculation
+        mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
+        memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
+        s = mpn_as_str(s, dig, ilen, base, base_char, 0);
+        m_del(mpz_dig_t, dig, ilen);
+    }
+
+    // insert a comma between each group of 3 digits, moving the digits up
+    if (comma) {
+        size_t n = s - str;
+        s += (n - 1) / 3;
+        char *d = s;
+        while (n-- > 0) {
+            *--d = str[n];
+            if (n > 0 && n % 3 == 0) {
+                *--d = comma;
             }
         }
-        if (comma && (s - last_comma) == 3) {
-            *s++ = comma;
-            last_comma = s;
-        }
     }
-    while (!done);
-
-    // free the copy of the digits array
-    m_del(mpz_dig_t, dig, ilen);
 
     if (prefix) {
         const char *p = &prefix[strlen(prefix)];
@@ -86,6 +86,22 @@ typedef int8_t mpz_dbl_dig_signed_t;
   #define MPZ_LONG_1 1L
 #endif
 
+// When MICROPY_OPT_MPZ_SUBQUADRATIC is enabled these set the number of digits at
+// which the subquadratic algorithms take over: Karatsuba multiplication when
+// both operands have at least MPZ_KARATSUBA_THRESHOLD digits, recursive
+// division when the divisor and quotient have at least MPZ_DIV_THRESHOLD
+// digits, and divide-and-conquer conversion to and from strings for numbers
+// of at least MPZ_STR_THRESHOLD digits.
+#ifndef MPZ_KARATSUBA_THRESHOLD
+#define MPZ_KARATSUBA_THRESHOLD (32)
+#endif
+#ifndef MPZ_DIV_THRESHOLD
+#define MPZ_DIV_THRESHOLD (64)
+#endif
+#ifndef MPZ_STR_THRESHOLD
+#define MPZ_STR_THRESHOLD (32)
+#endif
+
 // these define the maximum storage needed to hold an int or long long
 #define MPZ_NUM_DIG_FOR_INT ((sizeof(mp_int_t) * 8 + MPZ_DIG_SIZE - 1) / MPZ_DIG_SIZE)
 #define MPZ_NUM_DIG_FOR_LL ((sizeof(long long) * 8 + MPZ_DIG_SIZE - 1) / MPZ_DIG_SIZE)
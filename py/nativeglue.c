@@ -28,6 +28,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <stddef.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "py/binary.h"
 #include "py/runtime.h"
@@ -230,6 +234,104 @@ static bool mp_native_yield_from(mp_obj_t gen, mp_obj_t send_value, mp_obj_t *re
     return false;
 }
 
+// Helpers for the viper pointer methods copy_from, fill, xor_from and sum.
+// Elements are 1 << size_log2 bytes long.  Bulk work is done a machine word (or,
+// with SSE2, 16 bytes) at a time; ptr8 and ptr16 data need not be word aligned.
+
+static void mp_native_ptr_copy(void *dest, const void *src, size_t n, size_t size_log2) {
+    MP_STATIC_ASSERT(offsetof(mp_fun_table_t, ptr_copy) == MP_F_PTR_COPY * sizeof(void *));
+    memmove(dest, src, n << size_log2);
+}
+
+static void mp_native_ptr_fill(void *dest, mp_uint_t val, size_t n, size_t size_log2) {
+    if (size_log2 == 0) {
+        memset(dest, val, n);
+    } else if (size_log2 == 1) {
+        for (uint16_t *d = dest; n; --n) {
+            *d++ = val;
+        }
+    } else {
+        for (uint32_t *d = dest; n; --n) {
+            *d++ = val;
+        }
+    }
+}
+
+static void mp_native_ptr_xor(void *dest, const void *src, size_t n, size_t size_log2) {
+    // the element size doesn't matter for xor so work on bytes
+    byte *d = dest;
+    const byte *s = src;
+    n <<= size_log2;
+    #if defined(__SSE2__)
+    for (; n >= 16; n -= 16, d += 16, s += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)d);
+        __m128i b = _mm_loadu_si128((const __m128i *)s);
+        _mm_storeu_si128((__m128i *)d, _mm_xor_si128(a, b));
+    }
+    #endif
+    for (; n >= sizeof(mp_uint_t); n -= sizeof(mp_uint_t), d += sizeof(mp_uint_t), s += sizeof(mp_uint_t)) {
+        mp_uint_t a, b;
+        memcpy(&a, d, sizeof(a));
+        memcpy(&b, s, sizeof(b));
+        a ^= b;
+        memcpy(d, &a, sizeof(a));
+    }
+    for (; n; --n) {
+        *d++ ^= *s++;
+    }
+}
+
+static mp_int_t mp_native_ptr_sum(const void *src, size_t n, size_t size_log2) {
+    mp_uint_t sum = 0;
+    if (size_log2 == 0) {
+        const byte *s = src;
+        #if defined(__SSE2__)
+        __m128i acc_sad = _mm_setzero_si128();
+        for (; n >= 16; n -= 16, s += 16) {
+            // sum of absolute differences with zero adds up each half into a 64-bit lane
+            acc_sad = _mm_add_epi64(acc_sad, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)s), _mm_setzero_si128()));
+        }
+        uint64_t acc_lanes[2];
+        _mm_storeu_si128((__m128i *)acc_lanes, acc_sad);
+        sum = acc_lanes[0] + acc_lanes[1];
+        #endif
+        // Add bytes a word at a time into 16-bit lanes, each lane gains at most
+        // 2 * 255 per word so 128 words can be accumulated before folding.
+        const mp_uint_t lanes = (mp_uint_t)-1 / 0xffff * 0xff;
+        while (n >= sizeof(mp_uint_t)) {
+            size_t n_words = MIN(n / sizeof(mp_uint_t), 128);
+            n -= n_words * sizeof(mp_uint_t);
+            mp_uint_t acc = 0;
+            for (; n_words; --n_words, s += sizeof(mp_uint_t)) {
+                mp_uint_t w;
+                memcpy(&w, s, sizeof(w));
+                acc += (w & lanes) + ((w >> 8) & lanes);
+            }
+            for (; acc; acc >>= 16) {
+                sum += acc & 0xffff;
+            }
+        }
+        for (; n; --n) {
+            sum += *s++;
+        }
+    } else if (size_log2 == 1) {
+        for (const uint16_t *s = src; n; --n) {
+            sum += *s++;
+        }
+    } else {
+        for (const uint32_t *s = src; n; --n) {
+            sum += *s++;
+        }
+    }
+    return sum;
+}
+
+// Native code stores to closed-over variables through this so that the store
+// gets the GC write barrier, if there is one.
+static void mp_native_cell_set(mp_obj_t cell, mp_obj_t obj) {
+    mp_obj_cell_set(cell, obj);
+}
+
 #if !MICROPY_PY_BUILTINS_FLOAT
 
 static mp_obj_t mp_obj_new_float_from_f(float f) {
@@ -348,6 +450,11 @@ const mp_fun_table_t mp_fun_table = {
     &mp_stream_readinto_obj,
     &mp_stream_unbuffered_readline_obj,
     &mp_stream_write_obj,
+    mp_native_ptr_copy,
+    mp_native_ptr_fill,
+    mp_native_ptr_xor,
+    mp_native_ptr_sum,
+    mp_native_cell_set,
 };
 
 #elif MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
@@ -82,6 +82,12 @@ typedef enum {
     MP_F_SMALL_INT_MODULO,
     MP_F_NATIVE_YIELD_FROM,
     MP_F_SETJMP,
+    // Viper pointer helpers, these follow the dynamic runtime entries in mp_fun_table
+    MP_F_PTR_COPY = 83,
+    MP_F_PTR_FILL,
+    MP_F_PTR_XOR,
+    MP_F_PTR_SUM,
+    MP_F_CELL_SET,
     MP_F_NUMBER_OF,
 } mp_fun_kind_t;
 
@@ -175,6 +181,13 @@ typedef struct _mp_fun_table_t {
     const mp_obj_fun_builtin_var_t *stream_readinto_obj;
     const mp_obj_fun_builtin_var_t *stream_unbuffered_readline_obj;
     const mp_obj_fun_builtin_var_t *stream_write_obj;
+    // The following entries start at index 83 and are used by viper pointer methods.
+    // They are appended here so that the indices of the above entries don't change.
+    void (*ptr_copy)(void *dest, const void *src, size_t n, size_t size_log2);
+    void (*ptr_fill)(void *dest, mp_uint_t val, size_t n, size_t size_log2);
+    void (*ptr_xor)(void *dest, const void *src, size_t n, size_t size_log2);
+    mp_int_t (*ptr_sum)(const void *src, size_t n, size_t size_log2);
+    void (*cell_set)(mp_obj_t cell, mp_obj_t obj);
 } mp_fun_table_t;
 
 #if (MICROPY_EMIT_NATIVE && !MICROPY_DYNAMIC_COMPILER) || MICROPY_ENABLE_DYNRUNTIME
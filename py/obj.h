@@ -120,6 +120,7 @@ extern const struct _mp_obj_float_t mp_const_float_nan_obj;
 #define mp_obj_is_float(o) mp_obj_is_type((o), &mp_type_float)
 mp_float_t mp_obj_float_get(mp_obj_t self_in);
 mp_obj_t mp_obj_new_float(mp_float_t value);
+mp_obj_t mp_obj_float_reuse(mp_obj_t self_in, mp_float_t value);
 #endif
 
 static inline bool mp_obj_is_obj(mp_const_obj_t o) {
@@ -165,6 +166,7 @@ extern const struct _mp_obj_float_t mp_const_float_nan_obj;
 #define mp_obj_is_float(o) mp_obj_is_type((o), &mp_type_float)
 mp_float_t mp_obj_float_get(mp_obj_t self_in);
 mp_obj_t mp_obj_new_float(mp_float_t value);
+mp_obj_t mp_obj_float_reuse(mp_obj_t self_in, mp_float_t value);
 #endif
 
 static inline bool mp_obj_is_obj(mp_const_obj_t o) {
@@ -1058,10 +1060,15 @@ static inline mp_obj_t mp_obj_cell_get(mp_obj_t self_in) {
     return self->obj;
 }
 
+#if MICROPY_GC_INCREMENTAL
+// Includes the write barrier needed by the incremental GC.
+void mp_obj_cell_set(mp_obj_t self_in, mp_obj_t obj);
+#else
 static inline void mp_obj_cell_set(mp_obj_t self_in, mp_obj_t obj) {
     mp_obj_cell_t *self = (mp_obj_cell_t *)MP_OBJ_TO_PTR(self_in);
     self->obj = obj;
 }
+#endif
 
 // int
 // For long int, returns value truncated to mp_int_t
@@ -24,7 +24,8 @@
  * THE SOFTWARE.
  */
 
-#include "py/obj.h"
+#include "py/gc.h"
+#include "py/mpstate.h"
 
 #if MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_DETAILED
 static void cell_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind) {
@@ -57,3 +58,11 @@ mp_obj_t mp_obj_new_cell(mp_obj_t obj) {
     o->obj = obj;
     return MP_OBJ_FROM_PTR(o);
 }
+
+#if MICROPY_GC_INCREMENTAL
+void mp_obj_cell_set(mp_obj_t self_in, mp_obj_t obj) {
+    mp_obj_cell_t *self = MP_OBJ_TO_PTR(self_in);
+    self->obj = obj;
+    GC_WRITE_BARRIER(self);
+}
+#endif
@@ -27,6 +27,7 @@
 #include <unistd.h> // for ssize_t
 
 #include "py/runtime.h"
+#include "py/gc.h"
 
 #if MICROPY_PY_COLLECTIONS_DEQUE
 
@@ -109,6 +110,7 @@ static mp_obj_t mp_obj_deque_append(mp_obj_t self_in, mp_obj_t arg) {
     }
 
     self->items[self->i_put] = arg;
+    GC_WRITE_BARRIER(self->items);
     self->i_put = new_i_put;
 
     if (self->i_get == new_i_put) {
@@ -135,6 +137,7 @@ static mp_obj_t mp_obj_deque_appendleft(mp_obj_t self_in, mp_obj_t arg) {
 
     self->i_get = new_i_get;
     self->items[self->i_get] = arg;
+    GC_WRITE_BARRIER(self->items);
 
     // overwriting first element in deque
     if (self->i_put == new_i_get) {
@@ -218,6 +221,7 @@ static mp_obj_t deque_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     } else {
         // store into deque
         self->items[index_val] = value;
+        GC_WRITE_BARRIER(self->items);
         return mp_const_none;
     }
 }
@@ -613,6 +613,7 @@ void mp_obj_exception_add_traceback(mp_obj_t self_in, qstr file, size_t line, qs
         } else {
             // Allocated the traceback data on the heap
             self->traceback_alloc = TRACEBACK_ENTRY_LEN;
+            GC_WRITE_BARRIER(self->traceback_data);
         }
         self->traceback_len = 0;
     } else if (self->traceback_len + TRACEBACK_ENTRY_LEN > self->traceback_alloc) {
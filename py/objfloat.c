@@ -206,6 +206,15 @@ mp_float_t mp_obj_float_get(mp_obj_t self_in) {
     return self->value;
 }
 
+// Stores a new value in a float object, which the caller must know has no
+// other references (ie it's a temporary), and returns it.
+mp_obj_t mp_obj_float_reuse(mp_obj_t self_in, mp_float_t value) {
+    assert(mp_obj_is_float(self_in));
+    mp_obj_float_t *self = MP_OBJ_TO_PTR(self_in);
+    self->value = value;
+    return self_in;
+}
+
 #endif
 
 static void mp_obj_float_divmod(mp_float_t *x, mp_float_t *y) {
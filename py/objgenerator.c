@@ -34,6 +34,7 @@
 #include "py/objgenerator.h"
 #include "py/objfun.h"
 #include "py/stackctrl.h"
+#include "py/gc.h"
 
 // Instance of GeneratorExit exception - needed by generator.close()
 const mp_obj_exception_t mp_const_GeneratorExit_obj = {{&mp_type_GeneratorExit}, 0, 0, NULL, (mp_obj_tuple_t *)&mp_const_empty_tuple_obj};
@@ -166,6 +167,9 @@ mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_
         mp_raise_ValueError(MP_ERROR_TEXT("generator already executing"));
     }
 
+    // The generator's state is written to while it runs.
+    GC_WRITE_BARRIER(self);
+
     #if MICROPY_PY_GENERATOR_PEND_THROW
     // If exception is pending (set using .pend_throw()), process it now.
     if (self->pend_exc != mp_const_none) {
@@ -338,6 +342,7 @@ static mp_obj_t gen_instance_pend_throw(mp_obj_t self_in, mp_obj_t exc_in) {
     }
     mp_obj_t prev = self->pend_exc;
     self->pend_exc = exc_in;
+    GC_WRITE_BARRIER(self);
     return prev;
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(gen_instance_pend_throw_obj, gen_instance_pend_throw);
@@ -28,8 +28,9 @@
 #include <assert.h>
 
 #include "py/objlist.h"
+#include "py/objstr.h"
 #include "py/runtime.h"
-#include "py/stackctrl.h"
+#include "py/gc.h"
 
 static mp_obj_t mp_obj_new_list_iterator(mp_obj_t list, size_t cur, mp_obj_iter_buf_t *iter_buf);
 static mp_obj_list_t *list_new(size_t n);
@@ -226,6 +227,7 @@ static mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
                 // TODO: apply allocation policy re: alloc_size
             }
             self->len += len_adj;
+            GC_WRITE_BARRIER(self->items);
             return mp_const_none;
         }
         #endif
@@ -247,6 +249,7 @@ mp_obj_t mp_obj_list_append(mp_obj_t self_in, mp_obj_t arg) {
         mp_seq_clear(self->items, self->len + 1, self->alloc, sizeof(*self->items));
     }
     self->items[self->len++] = arg;
+    GC_WRITE_BARRIER(self->items);
     return mp_const_none; // return None, as per CPython
 }
 
@@ -265,6 +268,7 @@ static mp_obj_t list_extend(mp_obj_t self_in, mp_obj_t arg_in) {
 
         memcpy(self->items + self->len, arg->items, sizeof(mp_obj_t) * arg->len);
         self->len += arg->len;
+        GC_WRITE_BARRIER(self->items);
     } else {
         list_extend_from_iter(self_in, arg_in);
     }
@@ -290,39 +294,156 @@ static mp_obj_t list_pop(size_t n_args, const mp_obj_t *args) {
     return ret;
 }
 
-static void mp_quicksort(mp_obj_t *head, mp_obj_t *tail, mp_obj_t key_fn, mp_obj_t binop_less_result) {
-    MP_STACK_CHECK();
-    while (head < tail) {
-        mp_obj_t *h = head - 1;
-        mp_obj_t *t = tail;
-        mp_obj_t v = key_fn == MP_OBJ_NULL ? tail[0] : mp_call_function_1(key_fn, tail[0]); // get pivot using key_fn
-        for (;;) {
-            do {++h;
-            } while (h < t && mp_binary_op(MP_BINARY_OP_LESS, key_fn == MP_OBJ_NULL ? h[0] : mp_call_function_1(key_fn, h[0]), v) == binop_less_result);
-            do {--t;
-            } while (h < t && mp_binary_op(MP_BINARY_OP_LESS, v, key_fn == MP_OBJ_NULL ? t[0] : mp_call_function_1(key_fn, t[0])) == binop_less_result);
-            if (h >= t) {
-                break;
-            }
-            mp_obj_t x = h[0];
-            h[0] = t[0];
-            t[0] = x;
+// list.sort is a stable merge sort.  Runs of already-ordered items are found
+// and extended to LIST_SORT_MIN_RUN items by binary insertion, then merged
+// bottom-up; adjacent runs that are already in order are not merged at all,
+// so sorted and nearly-sorted input takes O(n) comparisons.  If there's no
+// memory for the merge buffer, binary insertion is used for the whole list.
+// Comparisons may raise, so items are only moved once the comparisons for
+// that step are complete, leaving the list a permutation of the original.
+#define LIST_SORT_MIN_RUN (32)
+
+enum {
+    LIST_SORT_GENERIC,
+    LIST_SORT_SMALL_INT,
+    LIST_SORT_STR,
+    LIST_SORT_FLOAT,
+};
+
+typedef struct _list_sort_t {
+    // Elements to sort, each being w words with the sort key first: either
+    // the items themselves (w = 1), or (key, item) pairs (w = 2).
+    mp_obj_t *elems;
+    mp_obj_t *tmp;
+    size_t w;
+    uint8_t kind;
+} list_sort_t;
+
+static inline bool list_sort_lt(const list_sort_t *s, mp_obj_t a, mp_obj_t b) {
+    if (s->kind == LIST_SORT_SMALL_INT) {
+        return MP_OBJ_SMALL_INT_VALUE(a) < MP_OBJ_SMALL_INT_VALUE(b);
+    } else if (s->kind == LIST_SORT_STR) {
+        GET_STR_DATA_LEN(a, a_data, a_len);
+        GET_STR_DATA_LEN(b, b_data, b_len);
+        int cmp = memcmp(a_data, b_data, MIN(a_len, b_len));
+        return cmp < 0 || (cmp == 0 && a_len < b_len);
+    #if MICROPY_PY_BUILTINS_FLOAT
+    } else if (s->kind == LIST_SORT_FLOAT) {
+        return mp_obj_float_get(a) < mp_obj_float_get(b);
+    #endif
+    } else {
+        return mp_binary_op(MP_BINARY_OP_LESS, a, b) == mp_const_true;
+    }
+}
+
+#define KEY(i) (s->elems[(i) * s->w])
+
+static void list_sort_move(const list_sort_t *s, mp_obj_t *dest, const mp_obj_t *src, size_t n) {
+    memmove(dest, src, n * s->w * sizeof(mp_obj_t));
+}
+
+static void list_sort_reverse(list_sort_t *s, size_t lo, size_t hi) {
+    for (size_t a = lo * s->w, b = (hi - 1) * s->w; a < b; a += s->w, b -= s->w) {
+        for (size_t j = 0; j < s->w; ++j) {
+            mp_obj_t x = s->elems[a + j];
+            s->elems[a + j] = s->elems[b + j];
+            s->elems[b + j] = x;
+        }
+    }
+}
+
+// Returns the end of the run starting at lo, reversing it if it's descending.
+static size_t list_sort_count_run(list_sort_t *s, size_t lo, size_t hi) {
+    size_t i = lo + 1;
+    if (i == hi) {
+        return hi;
+    }
+    if (list_sort_lt(s, KEY(i), KEY(i - 1))) {
+        // strictly descending, so that reversing it keeps the sort stable
+        while (++i < hi && list_sort_lt(s, KEY(i), KEY(i - 1))) {
+        }
+        list_sort_reverse(s, lo, i);
+    } else {
+        while (++i < hi && !list_sort_lt(s, KEY(i), KEY(i - 1))) {
         }
-        mp_obj_t x = h[0];
-        h[0] = tail[0];
-        tail[0] = x;
-        // do the smaller recursive call first, to keep stack within O(log(N))
-        if (t - head < tail - h - 1) {
-            mp_quicksort(head, t, key_fn, binop_less_result);
-            head = h + 1;
+    }
+    return i;
+}
+
+// Returns the first position in [lo, hi) whose key is greater than key, or
+// with at_equal the first position whose key is not less than key.
+static size_t list_sort_bisect(list_sort_t *s, mp_obj_t key, size_t lo, size_t hi, bool at_equal) {
+    while (lo < hi) {
+        size_t m = lo + (hi - lo) / 2;
+        if (at_equal ? list_sort_lt(s, KEY(m), key) : !list_sort_lt(s, key, KEY(m))) {
+            lo = m + 1;
         } else {
-            mp_quicksort(h + 1, tail, key_fn, binop_less_result);
-            tail = t;
+            hi = m;
         }
     }
+    return lo;
 }
 
-// TODO Python defines sort to be stable but ours is not
+// Sorts [lo, hi) by binary insertion, given that [lo, start) is sorted.
+static void list_sort_insertion(list_sort_t *s, size_t lo, size_t start, size_t hi) {
+    for (size_t i = start; i < hi; ++i) {
+        size_t pos = list_sort_bisect(s, KEY(i), lo, i, false);
+        if (pos < i) {
+            mp_obj_t elem[2];
+            list_sort_move(s, elem, &KEY(i), 1);
+            list_sort_move(s, &KEY(pos + 1), &KEY(pos), i - pos);
+            list_sort_move(s, &KEY(pos), elem, 1);
+        }
+    }
+}
+
+// Merges the sorted ranges [lo, mid) and [mid, hi).
+static void list_sort_merge(list_sort_t *s, size_t lo, size_t mid, size_t hi) {
+    if (!list_sort_lt(s, KEY(mid), KEY(mid - 1))) {
+        // already in order
+        return;
+    }
+
+    // elements of the left run up to the first element of the right run, and
+    // of the right run from the last element of the left run, are in place
+    lo = list_sort_bisect(s, KEY(mid), lo, mid - 1, false);
+    hi = list_sort_bisect(s, KEY(mid - 1), mid + 1, hi, true);
+
+    // merge into the buffer and then copy back, so that nothing moves if a
+    // comparison raises
+    size_t i = lo;
+    size_t j = mid;
+    mp_obj_t *out = s->tmp;
+    while (i < mid && j < hi) {
+        if (list_sort_lt(s, KEY(j), KEY(i))) {
+            list_sort_move(s, out, &KEY(j++), 1);
+        } else {
+            list_sort_move(s, out, &KEY(i++), 1);
+        }
+        out += s->w;
+    }
+    list_sort_move(s, &KEY(lo + (out - s->tmp) / s->w), &KEY(i), mid - i);
+    list_sort_move(s, &KEY(lo), s->tmp, (out - s->tmp) / s->w);
+}
+
+static void list_sort(list_sort_t *s, size_t len) {
+    if (s->tmp == NULL) {
+        list_sort_insertion(s, 0, list_sort_count_run(s, 0, len), len);
+        return;
+    }
+    for (size_t lo = 0; lo < len; lo += LIST_SORT_MIN_RUN) {
+        size_t hi = MIN(lo + LIST_SORT_MIN_RUN, len);
+        list_sort_insertion(s, lo, list_sort_count_run(s, lo, hi), hi);
+    }
+    for (size_t width = LIST_SORT_MIN_RUN; width < len; width *= 2) {
+        for (size_t lo = 0; lo + width < len; lo += 2 * width) {
+            list_sort_merge(s, lo, lo + width, MIN(lo + 2 * width, len));
+        }
+    }
+}
+
+#undef KEY
+
 mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_key, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
@@ -338,11 +459,65 @@ mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
 
     mp_check_self(mp_obj_is_type(pos_args[0], &mp_type_list));
     mp_obj_list_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    size_t len = self->len;
+
+    if (len > 1) {
+        list_sort_t s;
+        s.w = 1;
+        s.elems = self->items;
+        if (args.key.u_obj != mp_const_none) {
+            // call the key function once for each item
+            s.w = 2;
+            s.elems = m_new(mp_obj_t, 2 * len);
+            for (size_t i = 0; i < len; ++i) {
+                s.elems[2 * i] = mp_call_function_1(args.key.u_obj, self->items[i]);
+                s.elems[2 * i + 1] = self->items[i];
+                if (self->len != len) {
+                    mp_raise_ValueError(MP_ERROR_TEXT("list modified during sort"));
+                }
+            }
+        }
+
+        // use direct comparisons when all the keys are small ints, strings
+        // or floats
+        mp_obj_t first = s.elems[0];
+        s.kind = mp_obj_is_small_int(first) ? LIST_SORT_SMALL_INT
+            : mp_obj_is_str(first) ? LIST_SORT_STR
+            #if MICROPY_PY_BUILTINS_FLOAT
+            : mp_obj_is_float(first) ? LIST_SORT_FLOAT
+            #endif
+            : LIST_SORT_GENERIC;
+        for (size_t i = 1; i < len && s.kind != LIST_SORT_GENERIC; ++i) {
+            mp_obj_t key = s.elems[i * s.w];
+            if (s.kind == LIST_SORT_SMALL_INT ? !mp_obj_is_small_int(key)
+                : s.kind == LIST_SORT_STR ? !mp_obj_is_str(key)
+                : !mp_obj_is_float(key)) {
+                s.kind = LIST_SORT_GENERIC;
+            }
+        }
+
+        // a stable reverse sort is a sort of the reversed items, reversed
+        if (args.reverse.u_bool) {
+            list_sort_reverse(&s, 0, len);
+        }
+        s.tmp = m_new_maybe(mp_obj_t, s.w * len);
+        list_sort(&s, len);
+        if (args.reverse.u_bool) {
+            list_sort_reverse(&s, 0, len);
+        }
+        if (s.tmp != NULL) {
+            m_del(mp_obj_t, s.tmp, s.w * len);
+        }
 
-    if (self->len > 1) {
-        mp_quicksort(self->items, self->items + self->len - 1,
-            args.key.u_obj == mp_const_none ? MP_OBJ_NULL : args.key.u_obj,
-            args.reverse.u_bool ? mp_const_false : mp_const_true);
+        if (s.w == 2) {
+            if (self->len != len) {
+                mp_raise_ValueError(MP_ERROR_TEXT("list modified during sort"));
+            }
+            for (size_t i = 0; i < len; ++i) {
+                self->items[i] = s.elems[2 * i + 1];
+            }
+            m_del(mp_obj_t, s.elems, 2 * len);
+        }
     }
 
     return mp_const_none;
@@ -397,6 +572,7 @@ static mp_obj_t list_insert(mp_obj_t self_in, mp_obj_t idx, mp_obj_t obj) {
         self->items[i] = self->items[i - 1];
     }
     self->items[index] = obj;
+    GC_WRITE_BARRIER(self->items);
 
     return mp_const_none;
 }
@@ -507,6 +683,7 @@ void mp_obj_list_store(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     mp_obj_list_t *self = MP_OBJ_TO_PTR(self_in);
     size_t i = mp_get_index(self->base.type, self->len, index, false);
     self->items[i] = value;
+    GC_WRITE_BARRIER(self->items);
 }
 
 /******************************************************************************/
@@ -43,6 +43,21 @@ static NORETURN void bad_implicit_conversion(mp_obj_t self_in);
 
 static mp_obj_t mp_obj_new_str_type_from_vstr(const mp_obj_type_t *type, vstr_t *vstr);
 
+#if MICROPY_PY_BUILTINS_STR_UNICODE && MICROPY_OPT_STR_UNICODE_INDEX
+// Returns the flag to store alongside the hash of a new str object with the given data.
+static size_t str_ascii_flag(const byte *data, size_t len) {
+    for (const byte *top = data + len; data < top; ++data) {
+        if (UTF8_IS_NONASCII(*data)) {
+            return 0;
+        }
+    }
+    return MP_OBJ_STR_FLAG_ASCII;
+}
+#define STR_ASCII_FLAG(type, data, len) ((type) == &mp_type_str ? str_ascii_flag((data), (len)) : 0)
+#else
+#define STR_ASCII_FLAG(type, data, len) (0)
+#endif
+
 static void str_check_arg_type(const mp_obj_type_t *self_type, const mp_obj_t arg) {
     // String operations generally need the args type to match the object they're called on,
     // e.g. str.find(str), byte.startswith(byte)
@@ -201,7 +216,7 @@ mp_obj_t mp_obj_str_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_
 
                 mp_obj_str_t *o = MP_OBJ_TO_PTR(mp_obj_new_str_copy(type, NULL, str_len));
                 o->data = str_data;
-                o->hash = str_hash;
+                o->hash = str_hash | STR_ASCII_FLAG(type, str_data, str_len);
                 return MP_OBJ_FROM_PTR(o);
             } else {
                 mp_buffer_info_t bufinfo;
@@ -300,10 +315,121 @@ wrong_args:
     mp_raise_TypeError(MP_ERROR_TEXT("wrong number of arguments"));
 }
 
+#if MICROPY_OPT_STR_FIND_TWO_WAY
+
+// Searches shorter than these use the simple search.
+#define TWO_WAY_MIN_HAYSTACK (32)
+#define TWO_WAY_MIN_NEEDLE (3)
+
+// Byte i of s (of length len) in the direction of the search: counting from
+// the start when dir > 0, and from the end otherwise.
+#define TW_BYTE(s, len, i) (dir > 0 ? (s)[i] : (s)[(len) - 1 - (i)])
+
+// Finds the maximal suffix of the needle x, using the normal byte order, or
+// the reverse order when rev_order is true.  Returns the position just before
+// the suffix and sets *period to the period of the suffix.
+static mp_int_t two_way_max_suffix(const byte *x, size_t m, int dir, bool rev_order, size_t *period) {
+    mp_int_t ms = -1;
+    size_t j = 0;
+    size_t k = 1;
+    size_t p = 1;
+    while (j + k < m) {
+        byte a = TW_BYTE(x, m, j + k);
+        byte b = TW_BYTE(x, m, (size_t)(ms + k));
+        if (a == b) {
+            if (k == p) {
+                j += p;
+                k = 1;
+            } else {
+                k += 1;
+            }
+        } else if ((a < b) != rev_order) {
+            j += k;
+            k = 1;
+            p = j - ms;
+        } else {
+            ms = j++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return ms;
+}
+
+// The Two-Way string matching algorithm of Crochemore and Perrin, which takes
+// O(n + m) time and O(1) space.  The needle x is split at a critical position
+// ell; the right part is matched first, then the left part.  When searching
+// forwards, memchr is used to skip to candidates for the first byte of the
+// right part.
+static const byte *find_subbytes_two_way(const byte *y, size_t n, const byte *x, size_t m, int dir) {
+    size_t p, q;
+    mp_int_t i = two_way_max_suffix(x, m, dir, false, &p);
+    mp_int_t j = two_way_max_suffix(x, m, dir, true, &q);
+    mp_int_t ell = i > j ? i : j;
+    size_t per = i > j ? p : q;
+
+    // work out whether the left part of the needle repeats with its period
+    bool periodic = true;
+    for (mp_int_t k = 0; k <= ell; ++k) {
+        if (TW_BYTE(x, m, k) != TW_BYTE(x, m, k + per)) {
+            periodic = false;
+            per = MAX((size_t)ell + 1, m - ell - 1) + 1;
+            break;
+        }
+    }
+
+    // memory is how much of the left part is known to match, when periodic
+    mp_int_t memory = -1;
+    size_t pos = 0;
+    while (pos <= n - m) {
+        mp_int_t k = MAX(ell, memory) + 1;
+        while ((size_t)k < m && TW_BYTE(x, m, k) == TW_BYTE(y, n, pos + k)) {
+            ++k;
+        }
+        if ((size_t)k < m) {
+            if (dir > 0 && k == ell + 1 && memory < 0) {
+                // skip to the next candidate for the first byte of the right part
+                const byte *c = memchr(y + pos + k + 1, x[k], n - pos - k - 1);
+                if (c == NULL) {
+                    break;
+                }
+                pos = c - y - k;
+            } else {
+                pos += k - ell;
+                memory = -1;
+            }
+            continue;
+        }
+        k = ell;
+        while (k > memory && TW_BYTE(x, m, k) == TW_BYTE(y, n, pos + k)) {
+            --k;
+        }
+        if (k <= memory) {
+            return dir > 0 ? y + pos : y + n - m - pos;
+        }
+        pos += per;
+        if (periodic) {
+            memory = m - per - 1;
+        }
+    }
+    return NULL;
+}
+
+#undef TW_BYTE
+
+#endif
+
 // like strstr but with specified length and allows \0 bytes
-// TODO replace with something more efficient/standard
 const byte *find_subbytes(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction) {
     if (hlen >= nlen) {
+        #if MICROPY_OPT_STR_FIND_TWO_WAY
+        if (nlen == 1 && direction > 0) {
+            return memchr(haystack, needle[0], hlen);
+        }
+        if (hlen >= TWO_WAY_MIN_HAYSTACK && nlen >= TWO_WAY_MIN_NEEDLE) {
+            return find_subbytes_two_way(haystack, hlen, needle, nlen, direction);
+        }
+        #endif
         size_t str_index, str_index_end;
         if (direction > 0) {
             str_index = 0;
@@ -450,9 +576,9 @@ mp_obj_t mp_obj_str_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs_i
 
 #if !MICROPY_PY_BUILTINS_STR_UNICODE
 // objstrunicode defines own version
-const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, size_t self_len,
+const byte *str_index_to_ptr(mp_obj_t self_in, const byte *self_data, size_t self_len,
     mp_obj_t index, bool is_slice) {
-    size_t index_val = mp_get_index(type, self_len, index, is_slice);
+    size_t index_val = mp_get_index(mp_obj_get_type(self_in), self_len, index, is_slice);
     return self_data + index_val;
 }
 #endif
@@ -603,14 +729,9 @@ mp_obj_t mp_obj_str_split(size_t n_args, const mp_obj_t *args) {
 
         for (;;) {
             const byte *start = s;
-            for (;;) {
-                if (splits == 0 || s + sep_len > top) {
-                    s = top;
-                    break;
-                } else if (memcmp(s, sep_str, sep_len) == 0) {
-                    break;
-                }
-                s++;
+            s = splits == 0 ? NULL : find_subbytes(s, top - s, (const byte *)sep_str, sep_len, 1);
+            if (s == NULL) {
+                s = top;
             }
             mp_obj_list_append(res, mp_obj_new_str_of_type(self_type, start, s - start));
             if (s >= top) {
@@ -709,16 +830,8 @@ static mp_obj_t str_rsplit(size_t n_args, const mp_obj_t *args) {
         const byte *beg = s;
         const byte *last = s + len;
         for (;;) {
-            s = last - sep_len;
-            for (;;) {
-                if (splits == 0 || s < beg) {
-                    break;
-                } else if (memcmp(s, sep_str, sep_len) == 0) {
-                    break;
-                }
-                s--;
-            }
-            if (s < beg || splits == 0) {
+            s = splits == 0 ? NULL : find_subbytes(beg, last - beg, (const byte *)sep_str, sep_len, -1);
+            if (s == NULL) {
                 res->items[idx] = mp_obj_new_str_of_type(self_type, beg, last - beg);
                 break;
             }
@@ -752,10 +865,10 @@ static mp_obj_t str_finder(size_t n_args, const mp_obj_t *args, int direction, b
     const byte *start = haystack;
     const byte *end = haystack + haystack_len;
     if (n_args >= 3 && args[2] != mp_const_none) {
-        start = str_index_to_ptr(self_type, haystack, haystack_len, args[2], true);
+        start = str_index_to_ptr(args[0], haystack, haystack_len, args[2], true);
     }
     if (n_args >= 4 && args[3] != mp_const_none) {
-        end = str_index_to_ptr(self_type, haystack, haystack_len, args[3], true);
+        end = str_index_to_ptr(args[0], haystack, haystack_len, args[3], true);
     }
 
     if (end < start) {
@@ -775,7 +888,7 @@ static mp_obj_t str_finder(size_t n_args, const mp_obj_t *args, int direction, b
         // found
         #if MICROPY_PY_BUILTINS_STR_UNICODE
         if (self_type == &mp_type_str) {
-            return MP_OBJ_NEW_SMALL_INT(utf8_ptr_to_index(haystack, p));
+            return MP_OBJ_NEW_SMALL_INT(str_ptr_to_index(args[0], haystack, haystack_len, p));
         }
         #endif
         return MP_OBJ_NEW_SMALL_INT(p - haystack);
@@ -804,13 +917,12 @@ MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(str_rindex_obj, 2, 4, str_rindex);
 
 // TODO: (Much) more variety in args
 static mp_obj_t str_startswith(size_t n_args, const mp_obj_t *args) {
-    const mp_obj_type_t *self_type = mp_obj_get_type(args[0]);
     GET_STR_DATA_LEN(args[0], str, str_len);
     size_t prefix_len;
     const char *prefix = mp_obj_str_get_data(args[1], &prefix_len);
     const byte *start = str;
     if (n_args > 2) {
-        start = str_index_to_ptr(self_type, str, str_len, args[2], true);
+        start = str_index_to_ptr(args[0], str, str_len, args[2], true);
     }
     if (prefix_len + (start - str) > str_len) {
         return mp_const_false;
@@ -1772,10 +1884,10 @@ static mp_obj_t str_count(size_t n_args, const mp_obj_t *args) {
     const byte *start = haystack;
     const byte *end = haystack + haystack_len;
     if (n_args >= 3 && args[2] != mp_const_none) {
-        start = str_index_to_ptr(self_type, haystack, haystack_len, args[2], true);
+        start = str_index_to_ptr(args[0], haystack, haystack_len, args[2], true);
     }
     if (n_args >= 4 && args[3] != mp_const_none) {
-        end = str_index_to_ptr(self_type, haystack, haystack_len, args[3], true);
+        end = str_index_to_ptr(args[0], haystack, haystack_len, args[3], true);
     }
 
     // if needle_len is zero then we count each gap between characters as an occurrence
@@ -1783,17 +1895,15 @@ static mp_obj_t str_count(size_t n_args, const mp_obj_t *args) {
         return MP_OBJ_NEW_SMALL_INT(utf8_charlen(start, end - start) + 1);
     }
 
-    bool is_str = self_type == &mp_type_str;
-
-    // count the occurrences
+    // count the non-overlapping occurrences; for str, a match of a valid
+    // needle can only start at the start of a character
     mp_int_t num_occurrences = 0;
-    for (const byte *haystack_ptr = start; haystack_ptr + needle_len <= end;) {
-        if (memcmp(haystack_ptr, needle, needle_len) == 0) {
-            num_occurrences++;
-            haystack_ptr += needle_len;
-        } else {
-            haystack_ptr = is_str ? utf8_next_char(haystack_ptr) : haystack_ptr + 1;
+    for (const byte *haystack_ptr = start; haystack_ptr + needle_len <= end; haystack_ptr += needle_len) {
+        haystack_ptr = find_subbytes(haystack_ptr, end - haystack_ptr, needle, needle_len, 1);
+        if (haystack_ptr == NULL) {
+            break;
         }
+        num_occurrences++;
     }
 
     return MP_OBJ_NEW_SMALL_INT(num_occurrences);
@@ -2063,7 +2173,7 @@ mp_int_t mp_obj_str_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_u
 void mp_obj_str_set_data(mp_obj_str_t *str, const byte *data, size_t len) {
     str->data = data;
     str->len = len;
-    str->hash = qstr_compute_hash(data, len);
+    str->hash = qstr_compute_hash(data, len) | STR_ASCII_FLAG(str->base.type, data, len);
 }
 
 // This locals table is used for the following types: str, bytes, bytearray, array.array.
@@ -2208,7 +2318,7 @@ mp_obj_t mp_obj_new_str_copy(const mp_obj_type_t *type, const byte *data, size_t
     mp_obj_str_t *o = mp_obj_malloc(mp_obj_str_t, type);
     o->len = len;
     if (data) {
-        o->hash = qstr_compute_hash(data, len);
+        o->hash = qstr_compute_hash(data, len) | STR_ASCII_FLAG(type, data, len);
         byte *p = m_new(byte, len + 1);
         o->data = p;
         memcpy(p, data, len * sizeof(byte));
@@ -2267,7 +2377,7 @@ static mp_obj_t mp_obj_new_str_type_from_vstr(const mp_obj_type_t *type, vstr_t
     #endif
     mp_obj_str_t *o = mp_obj_malloc(mp_obj_str_t, type);
     o->len = vstr->len;
-    o->hash = qstr_compute_hash(data, vstr->len);
+    o->hash = qstr_compute_hash(data, vstr->len) | STR_ASCII_FLAG(type, data, vstr->len);
     o->data = data;
     return MP_OBJ_FROM_PTR(o);
 }
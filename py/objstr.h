@@ -46,6 +46,20 @@ typedef struct _mp_obj_str_t {
 
 #define MP_DEFINE_STR_OBJ(obj_name, str) mp_obj_str_t obj_name = {{&mp_type_str}, 0, sizeof(str) - 1, (const byte *)str}
 
+#if MICROPY_PY_BUILTINS_STR_UNICODE && MICROPY_OPT_STR_UNICODE_INDEX
+// A string hash never uses more than the low 16 bits of the hash entry (see
+// qstr_compute_hash), so the bit above them is used to record that a str object
+// created at runtime holds only ASCII characters, and so can be indexed by byte.
+// Statically defined str objects don't have this bit set.
+#if MICROPY_QSTR_BYTES_IN_HASH > 2
+#error MICROPY_OPT_STR_UNICODE_INDEX requires MICROPY_QSTR_BYTES_IN_HASH <= 2
+#endif
+#define MP_OBJ_STR_HASH_MASK (0xffff)
+#define MP_OBJ_STR_FLAG_ASCII (0x10000)
+#else
+#define MP_OBJ_STR_HASH_MASK ((size_t)-1)
+#endif
+
 // use this macro to extract the string hash
 // warning: the hash can be 0, meaning invalid, and must then be explicitly computed from the data
 #define GET_STR_HASH(str_obj_in, str_hash) \
@@ -53,7 +67,7 @@ typedef struct _mp_obj_str_t {
     if (mp_obj_is_qstr(str_obj_in)) { \
         str_hash = qstr_hash(MP_OBJ_QSTR_VALUE(str_obj_in)); \
     } else { \
-        str_hash = ((mp_obj_str_t *)MP_OBJ_TO_PTR(str_obj_in))->hash; \
+        str_hash = ((mp_obj_str_t *)MP_OBJ_TO_PTR(str_obj_in))->hash & MP_OBJ_STR_HASH_MASK; \
     }
 
 // use this macro to extract the string length
@@ -96,8 +110,11 @@ mp_int_t mp_obj_str_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_u
 
 void mp_obj_str_set_data(mp_obj_str_t *str, const byte *data, size_t len);
 
-const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, size_t self_len,
+const byte *str_index_to_ptr(mp_obj_t self_in, const byte *self_data, size_t self_len,
     mp_obj_t index, bool is_slice);
+#if MICROPY_PY_BUILTINS_STR_UNICODE
+size_t str_ptr_to_index(mp_obj_t self_in, const byte *self_data, size_t self_len, const byte *ptr);
+#endif
 const byte *find_subbytes(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction);
 
 #define MP_DEFINE_BYTES_OBJ(obj_name, target, len) mp_obj_str_t obj_name = {{&mp_type_bytes}, 0, (len), (const byte *)(target)}
@@ -28,6 +28,7 @@
 #include <string.h>
 #include <assert.h>
 
+#include "py/unicode.h"
 #include "py/objstr.h"
 #include "py/objlist.h"
 #include "py/runtime.h"
@@ -36,6 +37,78 @@
 
 static mp_obj_t mp_obj_new_str_iterator(mp_obj_t str, mp_obj_iter_buf_t *iter_buf);
 
+#if MICROPY_OPT_STR_UNICODE_INDEX
+
+// A str object with non-ASCII data at least STR_INDEX_MIN_LEN bytes long gets an
+// index holding the byte offset of every STR_INDEX_STRIDE'th character, so that
+// converting between a character index and a pointer only needs a short scan.
+#define STR_INDEX_MIN_LEN (128)
+#define STR_INDEX_STRIDE (32)
+
+static inline bool str_is_ascii(mp_obj_t self_in) {
+    return !mp_obj_is_qstr(self_in)
+           && (((mp_obj_str_t *)MP_OBJ_TO_PTR(self_in))->hash & MP_OBJ_STR_FLAG_ASCII);
+}
+
+#if !MICROPY_PY_THREAD || MICROPY_PY_THREAD_GIL
+
+// The indices of the most recently used strings are cached, most recent first.
+// Each index is an array holding the str object, its number of characters and
+// then the byte offsets.  The reference to the str object keeps it alive while
+// its index is cached, so its address can't be reused by a different string.
+#define STR_INDEX_CACHE_SIZE MP_ARRAY_SIZE(MP_STATE_VM(str_index_cache))
+
+// Returns the index for the given str object, building it if needed, or NULL if
+// the string is too short to need one or there's no memory for it.
+static const size_t *str_get_index(mp_obj_t self_in, const byte *self_data, size_t self_len) {
+    if (self_len < STR_INDEX_MIN_LEN || mp_obj_is_qstr(self_in)) {
+        return NULL;
+    }
+    size_t **cache = MP_STATE_VM(str_index_cache);
+    for (size_t i = 0; i < STR_INDEX_CACHE_SIZE; ++i) {
+        const size_t *index = cache[i];
+        if (index != NULL && index[0] == (uintptr_t)MP_OBJ_TO_PTR(self_in)) {
+            return index;
+        }
+    }
+
+    size_t n_chars = utf8_charlen(self_data, self_len);
+    size_t *index = m_new_maybe(size_t, 2 + (n_chars + STR_INDEX_STRIDE - 1) / STR_INDEX_STRIDE);
+    if (index == NULL) {
+        return NULL;
+    }
+    index[0] = (uintptr_t)MP_OBJ_TO_PTR(self_in);
+    index[1] = n_chars;
+    for (size_t i = 0, n = 0; i < self_len; ++i) {
+        if (!UTF8_IS_CONT(self_data[i])) {
+            if (n % STR_INDEX_STRIDE == 0) {
+                index[2 + n / STR_INDEX_STRIDE] = i;
+            }
+            ++n;
+        }
+    }
+    memmove(&cache[1], &cache[0], (STR_INDEX_CACHE_SIZE - 1) * sizeof(*cache));
+    cache[0] = index;
+    return index;
+}
+
+MP_REGISTER_ROOT_POINTER(size_t *str_index_cache[4]);
+
+#else
+
+// Without the GIL threads could update the cache at the same time, so there is
+// no cache and non-ASCII strings are always scanned.
+static inline const size_t *str_get_index(mp_obj_t self_in, const byte *self_data, size_t self_len) {
+    (void)self_in;
+    (void)self_data;
+    (void)self_len;
+    return NULL;
+}
+
+#endif
+
+#endif
+
 /******************************************************************************/
 /* str                                                                        */
 
@@ -103,8 +176,17 @@ static mp_obj_t uni_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
     switch (op) {
         case MP_UNARY_OP_BOOL:
             return mp_obj_new_bool(str_len != 0);
-        case MP_UNARY_OP_LEN:
+        case MP_UNARY_OP_LEN: {
+            #if MICROPY_OPT_STR_UNICODE_INDEX
+            const size_t *index;
+            if (str_is_ascii(self_in)) {
+                return MP_OBJ_NEW_SMALL_INT(str_len);
+            } else if ((index = str_get_index(self_in, str_data, str_len)) != NULL) {
+                return MP_OBJ_NEW_SMALL_INT(index[1]);
+            }
+            #endif
             return MP_OBJ_NEW_SMALL_INT(utf8_charlen(str_data, str_len));
+        }
         default:
             return MP_OBJ_NULL; // op not supported
     }
@@ -112,10 +194,11 @@ static mp_obj_t uni_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
 
 // Convert an index into a pointer to its lead byte. Out of bounds indexing will raise IndexError or
 // be capped to the first/last character of the string, depending on is_slice.
-const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, size_t self_len,
+const byte *str_index_to_ptr(mp_obj_t self_in, const byte *self_data, size_t self_len,
     mp_obj_t index, bool is_slice) {
     // All str functions also handle bytes objects, and they call str_index_to_ptr(),
     // so it must handle bytes.
+    const mp_obj_type_t *type = mp_obj_get_type(self_in);
     if (type == &mp_type_bytes
         #if MICROPY_PY_BUILTINS_BYTEARRAY
         || type == &mp_type_bytearray
@@ -136,6 +219,34 @@ const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, s
         mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("string indices must be integers, not %s"), mp_obj_get_type_str(index));
     }
     const byte *s, *top = self_data + self_len;
+
+    #if MICROPY_OPT_STR_UNICODE_INDEX
+    // If the number of characters is known then bounds checking is simple, and
+    // the pointer can be found directly (for ASCII data) or from the index.
+    const size_t *str_index = NULL;
+    if (str_is_ascii(self_in)
+        || (str_index = str_get_index(self_in, self_data, self_len)) != NULL) {
+        size_t n_chars = str_index == NULL ? self_len : str_index[1];
+        if (i < 0) {
+            i += n_chars;
+        }
+        if (i < 0 || (size_t)i >= n_chars) {
+            if (is_slice) {
+                return i < 0 ? self_data : top;
+            }
+            mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("string index out of range"));
+        }
+        if (str_index == NULL) {
+            return self_data + i;
+        }
+        s = self_data + str_index[2 + i / STR_INDEX_STRIDE];
+        for (i %= STR_INDEX_STRIDE; i > 0; --i) {
+            s = utf8_next_char(s);
+        }
+        return s;
+    }
+    #endif
+
     if (i < 0) {
         // Negative indexing is performed by counting from the end of the string.
         for (s = top - 1; i; --s) {
@@ -178,6 +289,34 @@ const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, s
     return s;
 }
 
+// Convert a pointer to the lead byte of a character into the index of that character.
+size_t str_ptr_to_index(mp_obj_t self_in, const byte *self_data, size_t self_len, const byte *ptr) {
+    #if MICROPY_OPT_STR_UNICODE_INDEX
+    const size_t *str_index;
+    if (str_is_ascii(self_in)) {
+        return ptr - self_data;
+    } else if ((str_index = str_get_index(self_in, self_data, self_len)) != NULL) {
+        // Binary search for the last indexed character at or before ptr.
+        size_t offset = ptr - self_data;
+        size_t lo = 0;
+        size_t hi = (str_index[1] + STR_INDEX_STRIDE - 1) / STR_INDEX_STRIDE;
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2;
+            if (str_index[2 + mid] <= offset) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo * STR_INDEX_STRIDE + utf8_ptr_to_index(self_data + str_index[2 + lo], ptr);
+    }
+    #else
+    (void)self_in;
+    (void)self_len;
+    #endif
+    return utf8_ptr_to_index(self_data, ptr);
+}
+
 static mp_obj_t str_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     const mp_obj_type_t *type = mp_obj_get_type(self_in);
     assert(type == &mp_type_str);
@@ -198,14 +337,14 @@ static mp_obj_t str_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
 
             const byte *pstart, *pstop;
             if (ostart != mp_const_none) {
-                pstart = str_index_to_ptr(type, self_data, self_len, ostart, true);
+                pstart = str_index_to_ptr(self_in, self_data, self_len, ostart, true);
             } else {
                 pstart = self_data;
             }
             if (ostop != mp_const_none) {
                 // pstop will point just after the stop character. This depends on
                 // the \0 at the end of the string.
-                pstop = str_index_to_ptr(type, self_data, self_len, ostop, true);
+                pstop = str_index_to_ptr(self_in, self_data, self_len, ostop, true);
             } else {
                 pstop = self_data + self_len;
             }
@@ -215,7 +354,7 @@ static mp_obj_t str_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
             return mp_obj_new_str_of_type(type, (const byte *)pstart, pstop - pstart);
         }
         #endif
-        const byte *s = str_index_to_ptr(type, self_data, self_len, index, false);
+        const byte *s = str_index_to_ptr(self_in, self_data, self_len, index, false);
         int len = 1;
         if (UTF8_IS_NONASCII(*s)) {
             // Count the number of 1 bits (after the first)
@@ -235,6 +235,40 @@ static void mp_obj_class_lookup(struct class_lookup_data *lookup, const mp_obj_t
     }
 }
 
+#if MICROPY_OPT_INLINE_CACHE
+// Finds the class that defines attr for instances of type, for the VM's inline
+// caches.  Only classes where this gives the same result as mp_obj_class_lookup
+// are handled: those with no special accessors, whose bases form a single chain
+// of user-defined classes.  Returns the locals map of the defining class and
+// sets *index to the position of attr in it, or returns NULL.
+mp_map_t *mp_obj_class_lookup_for_cache(const mp_obj_type_t *type, qstr attr, size_t *index) {
+    if (type->flags & MP_TYPE_FLAG_HAS_SPECIAL_ACCESSORS) {
+        return NULL;
+    }
+    for (;;) {
+        if (!mp_obj_is_instance_type(type)) {
+            // a native base class, including object
+            return NULL;
+        }
+        mp_map_t *locals_map = &MP_OBJ_TYPE_GET_SLOT(type, locals_dict)->map;
+        mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL) {
+            *index = elem - locals_map->table;
+            return locals_map;
+        }
+        if (!MP_OBJ_TYPE_HAS_SLOT(type, parent)) {
+            return NULL;
+        }
+        const mp_obj_base_t *parent = MP_OBJ_TYPE_GET_SLOT(type, parent);
+        if (parent->type != &mp_type_type) {
+            // multiple inheritance
+            return NULL;
+        }
+        type = (const mp_obj_type_t *)parent;
+    }
+}
+#endif
+
 static void instance_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     mp_obj_instance_t *self = MP_OBJ_TO_PTR(self_in);
     qstr meth = (kind == PRINT_STR) ? MP_QSTR___str__ : MP_QSTR___repr__;
@@ -1073,6 +1107,10 @@ static void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
                 // delete attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
                 if (elem != NULL) {
+                    #if MICROPY_OPT_INLINE_CACHE
+                    // a base class attribute may no longer be shadowed
+                    MP_STATE_VM(inline_cache_epoch) += 1;
+                    #endif
                     dest[0] = MP_OBJ_NULL; // indicate success
                 }
             } else {
@@ -1091,6 +1129,12 @@ static void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
 
                 // store attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+                #if MICROPY_OPT_INLINE_CACHE
+                if (elem->value == MP_OBJ_NULL) {
+                    // a new attribute may shadow one in a base class
+                    MP_STATE_VM(inline_cache_epoch) += 1;
+                }
+                #endif
                 elem->value = dest[1];
                 dest[0] = MP_OBJ_NULL; // indicate success
             }
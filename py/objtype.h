@@ -52,4 +52,9 @@ mp_obj_t mp_obj_instance_call(mp_obj_t self_in, size_t n_args, size_t n_kw, cons
 // this needs to be exposed for mp_getiter
 mp_obj_t mp_obj_instance_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf);
 
+#if MICROPY_OPT_INLINE_CACHE
+// this is used by the VM's inline caches
+mp_map_t *mp_obj_class_lookup_for_cache(const mp_obj_type_t *type, qstr attr, size_t *index);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_OBJTYPE_H
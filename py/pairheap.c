@@ -25,6 +25,8 @@
  */
 
 #include "py/pairheap.h"
+#include "py/runtime.h"
+#include "py/gc.h"
 
 // The mp_pairheap_t.next pointer can take one of the following values:
 //   - NULL: the node is the top of the heap
@@ -43,6 +45,8 @@ mp_pairheap_t *mp_pairheap_meld(mp_pairheap_lt_t lt, mp_pairheap_t *heap1, mp_pa
     if (heap2 == NULL) {
         return heap1;
     }
+    GC_WRITE_BARRIER(heap1);
+    GC_WRITE_BARRIER(heap2);
     if (lt(heap1, heap2)) {
         if (heap1->child == NULL) {
             heap1->child = heap2;
@@ -105,6 +109,7 @@ mp_pairheap_t *mp_pairheap_delete(mp_pairheap_lt_t lt, mp_pairheap_t *heap, mp_p
         parent = parent->next;
     }
     parent = NEXT_GET_RIGHTMOST_PARENT(parent->next);
+    GC_WRITE_BARRIER(parent);
 
     // Replace node with pairing of its children
     mp_pairheap_t *next;
@@ -128,6 +133,7 @@ mp_pairheap_t *mp_pairheap_delete(mp_pairheap_lt_t lt, mp_pairheap_t *heap, mp_p
         while (node != n->next) {
             n = n->next;
         }
+        GC_WRITE_BARRIER(n);
         mp_pairheap_t *child = node->child;
         next = node->next;
         node->child = NULL;
@@ -139,6 +145,7 @@ mp_pairheap_t *mp_pairheap_delete(mp_pairheap_lt_t lt, mp_pairheap_t *heap, mp_p
             n->next = node;
         }
     }
+    GC_WRITE_BARRIER(node);
     node->next = next;
     if (NEXT_IS_RIGHTMOST_PARENT(next)) {
         parent->child_last = node;
@@ -710,8 +710,128 @@ static bool fold_logical_constants(parser_t *parser, uint8_t rule_id, size_t *nu
     return false;
 }
 
+#if MICROPY_COMP_CONST_FOLDING_EXTENDED
+
+// Limit on the length of a str, bytes or tuple created by folding, so that an
+// expression like "x" * 100000 is not turned into a huge constant.
+#define FOLD_MAX_SEQ_LEN (256)
+
+// Get an operand for folding: an int, float (if enabled), str, bytes or tuple constant.
+static bool fold_get_operand_maybe(mp_parse_node_t pn, mp_obj_t *o) {
+    if (mp_parse_node_get_int_maybe(pn, o)) {
+        return true;
+    } else if (MP_PARSE_NODE_IS_LEAF(pn) && MP_PARSE_NODE_LEAF_KIND(pn) == MP_PARSE_NODE_STRING) {
+        *o = MP_OBJ_NEW_QSTR(MP_PARSE_NODE_LEAF_ARG(pn));
+        return true;
+    } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, RULE_const_object)) {
+        *o = mp_parse_node_extract_const_object((mp_parse_node_struct_t *)pn);
+        return (MICROPY_COMP_CONST_FOLDING_FLOAT && mp_obj_is_float(*o))
+               || mp_obj_is_str(*o)
+               || mp_obj_is_type(*o, &mp_type_bytes)
+               || mp_obj_is_type(*o, &mp_type_tuple);
+    } else {
+        return false;
+    }
+}
+
+static bool fold_is_number(mp_obj_t o) {
+    return mp_obj_is_int(o) || mp_obj_is_float(o);
+}
+
+// Fold a binary operation where at least one operand is not an int.  Only
+// arithmetic and comparisons between numbers, concatenation and repetition of
+// sequences, and comparisons between str or bytes are folded.  Anything that
+// raises (eg division by zero) or produces another type (eg a complex number)
+// is left to be evaluated at runtime.
+static bool fold_binary_op_obj(mp_binary_op_t op, mp_obj_t lhs, mp_obj_t rhs, mp_obj_t *res) {
+    bool is_compare = MP_BINARY_OP_LESS <= op && op <= MP_BINARY_OP_NOT_EQUAL;
+    if (fold_is_number(lhs) && fold_is_number(rhs)) {
+        if (op == MP_BINARY_OP_MAT_MULTIPLY
+            || (!MICROPY_COMP_CONST_FOLDING_FLOAT && op == MP_BINARY_OP_TRUE_DIVIDE)) {
+            return false;
+        }
+    } else if (is_compare) {
+        if (!(mp_obj_get_type(lhs) == mp_obj_get_type(rhs) && mp_obj_is_str_or_bytes(lhs))) {
+            return false;
+        }
+    } else if (op == MP_BINARY_OP_ADD) {
+        if (mp_obj_get_type(lhs) != mp_obj_get_type(rhs)
+            || mp_obj_get_int(mp_obj_len(lhs)) + mp_obj_get_int(mp_obj_len(rhs)) > FOLD_MAX_SEQ_LEN) {
+            return false;
+        }
+    } else if (op == MP_BINARY_OP_MULTIPLY) {
+        if (mp_obj_is_int(lhs)) {
+            mp_obj_t tmp = lhs;
+            lhs = rhs;
+            rhs = tmp;
+        }
+        if (!mp_obj_is_small_int(rhs) || fold_is_number(lhs)) {
+            return false;
+        }
+        mp_int_t n = MP_OBJ_SMALL_INT_VALUE(rhs);
+        if (n > 0 && mp_obj_get_int(mp_obj_len(lhs)) > FOLD_MAX_SEQ_LEN / n) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        *res = mp_binary_op(op, lhs, rhs);
+        nlr_pop();
+    } else {
+        return false;
+    }
+
+    // Only accept results that can be stored as constants.
+    return is_compare || fold_is_number(*res) || mp_obj_get_type(*res) == mp_obj_get_type(lhs);
+}
+
+// Fold a chain of comparisons like 1 < X <= 3 to True or False.
+static bool fold_comparison(parser_t *parser, size_t num_args) {
+    bool value = true;
+    mp_obj_t lhs;
+    if (!fold_get_operand_maybe(peek_result(parser, num_args - 1), &lhs)) {
+        return false;
+    }
+    for (ssize_t i = num_args - 2; i >= 1; i -= 2) {
+        mp_parse_node_t pn_op = peek_result(parser, i);
+        mp_obj_t rhs;
+        if (!MP_PARSE_NODE_IS_TOKEN(pn_op)
+            || MP_PARSE_NODE_LEAF_ARG(pn_op) < MP_TOKEN_OP_LESS
+            || MP_PARSE_NODE_LEAF_ARG(pn_op) > MP_TOKEN_OP_NOT_EQUAL
+            || !fold_get_operand_maybe(peek_result(parser, i - 1), &rhs)) {
+            return false;
+        }
+        mp_binary_op_t op = MP_BINARY_OP_LESS + (MP_PARSE_NODE_LEAF_ARG(pn_op) - MP_TOKEN_OP_LESS);
+        mp_obj_t res;
+        if (!fold_binary_op_obj(op, lhs, rhs, &res)) {
+            return false;
+        }
+        // keep checking the remaining operands so the whole chain is constant
+        value = value && res == mp_const_true;
+        lhs = rhs;
+    }
+
+    for (size_t i = num_args; i > 0; i--) {
+        pop_result(parser);
+    }
+    push_result_node(parser, mp_parse_node_new_leaf(MP_PARSE_NODE_TOKEN, value ? MP_TOKEN_KW_TRUE : MP_TOKEN_KW_FALSE));
+    return true;
+}
+
+#define fold_get_operand fold_get_operand_maybe
+
+#else
+
+#define fold_get_operand mp_parse_node_get_int_maybe
+
+#endif
+
 static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
-    // this code does folding of arbitrary integer expressions, eg 1 + 2 * 3 + 4
+    // this code does folding of arbitrary constant expressions, eg 1 + 2 * 3 + 4
+    // or "a" + "b"; by default only integers are folded
     // it does not do partial folding, eg 1 + 2 + x -> 3 + x
 
     mp_obj_t arg0;
@@ -721,7 +841,7 @@ static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
         || rule_id == RULE_power) {
         // folding for binary ops: | ^ & **
         mp_parse_node_t pn = peek_result(parser, num_args - 1);
-        if (!mp_parse_node_get_int_maybe(pn, &arg0)) {
+        if (!fold_get_operand(pn, &arg0)) {
             return false;
         }
         mp_binary_op_t op;
@@ -737,9 +857,17 @@ static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
         for (ssize_t i = num_args - 2; i >= 0; --i) {
             pn = peek_result(parser, i);
             mp_obj_t arg1;
-            if (!mp_parse_node_get_int_maybe(pn, &arg1)) {
+            if (!fold_get_operand(pn, &arg1)) {
                 return false;
             }
+            #if MICROPY_COMP_CONST_FOLDING_EXTENDED
+            if (!mp_obj_is_int(arg0) || !mp_obj_is_int(arg1)) {
+                if (!fold_binary_op_obj(op, arg0, arg1, &arg0)) {
+                    return false;
+                }
+                continue;
+            }
+            #endif
             if (op == MP_BINARY_OP_POWER && mp_obj_int_sign(arg1) < 0) {
                 // ** can't have negative rhs
                 return false;
@@ -751,21 +879,30 @@ static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
                || rule_id == RULE_term) {
         // folding for binary ops: << >> + - * @ / % //
         mp_parse_node_t pn = peek_result(parser, num_args - 1);
-        if (!mp_parse_node_get_int_maybe(pn, &arg0)) {
+        if (!fold_get_operand(pn, &arg0)) {
             return false;
         }
         for (ssize_t i = num_args - 2; i >= 1; i -= 2) {
             pn = peek_result(parser, i - 1);
             mp_obj_t arg1;
-            if (!mp_parse_node_get_int_maybe(pn, &arg1)) {
+            if (!fold_get_operand(pn, &arg1)) {
                 return false;
             }
             mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(peek_result(parser, i));
+            mp_binary_op_t op = MP_BINARY_OP_LSHIFT + (tok - MP_TOKEN_OP_DBL_LESS);
+            #if MICROPY_COMP_CONST_FOLDING_EXTENDED
+            if (!mp_obj_is_int(arg0) || !mp_obj_is_int(arg1) || tok == MP_TOKEN_OP_SLASH) {
+                // true division of ints gives a float, so is handled here too
+                if (!fold_binary_op_obj(op, arg0, arg1, &arg0)) {
+                    return false;
+                }
+                continue;
+            }
+            #endif
             if (tok == MP_TOKEN_OP_AT || tok == MP_TOKEN_OP_SLASH) {
                 // Can't fold @ or /
                 return false;
             }
-            mp_binary_op_t op = MP_BINARY_OP_LSHIFT + (tok - MP_TOKEN_OP_DBL_LESS);
             int rhs_sign = mp_obj_int_sign(arg1);
             if (op <= MP_BINARY_OP_RSHIFT) {
                 // << and >> can't have negative rhs
@@ -783,12 +920,15 @@ static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
     } else if (rule_id == RULE_factor_2) {
         // folding for unary ops: + - ~
         mp_parse_node_t pn = peek_result(parser, 0);
-        if (!mp_parse_node_get_int_maybe(pn, &arg0)) {
+        if (!fold_get_operand(pn, &arg0)) {
             return false;
         }
         mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(peek_result(parser, 1));
         mp_unary_op_t op;
-        if (tok == MP_TOKEN_OP_TILDE) {
+        if (!mp_obj_is_int(arg0) && (tok == MP_TOKEN_OP_TILDE || !mp_obj_is_float(arg0))) {
+            // only + and - on floats can be folded
+            return false;
+        } else if (tok == MP_TOKEN_OP_TILDE) {
             op = MP_UNARY_OP_INVERT;
         } else {
             assert(tok == MP_TOKEN_OP_PLUS || tok == MP_TOKEN_OP_MINUS); // should be
@@ -796,6 +936,11 @@ static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
         }
         arg0 = mp_unary_op(op, arg0);
 
+    #if MICROPY_COMP_CONST_FOLDING_EXTENDED
+    } else if (rule_id == RULE_comparison) {
+        return fold_comparison(parser, num_args);
+    #endif
+
     #if MICROPY_COMP_CONST
     } else if (rule_id == RULE_expr_stmt) {
         mp_parse_node_t pn1 = peek_result(parser, 0);
@@ -886,6 +1031,17 @@ static bool fold_constants(parser_t *parser, uint8_t rule_id, size_t num_args) {
     for (size_t i = num_args; i > 0; i--) {
         pop_result(parser);
     }
+    #if MICROPY_COMP_CONST_FOLDING_EXTENDED
+    if (mp_obj_is_str(arg0)) {
+        // make a str leaf the same way the lexer would for a literal
+        GET_STR_DATA_LEN(arg0, str, len);
+        qstr qst = len <= MICROPY_ALLOC_PARSE_INTERN_STRING_LEN ? qstr_from_strn((const char *)str, len) : qstr_find_strn((const char *)str, len);
+        if (qst != MP_QSTRnull) {
+            push_result_node(parser, mp_parse_node_new_leaf(MP_PARSE_NODE_STRING, qst));
+            return true;
+        }
+    }
+    #endif
     push_result_node(parser, make_node_const_object_optimised(parser, 0, arg0));
 
     return true;
@@ -325,8 +325,10 @@ static mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
         // Assign bytecode to raw code object
         mp_emit_glue_assign_bytecode(rc, fun_data,
             children,
-            #if MICROPY_PERSISTENT_CODE_SAVE
+            #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_OPT_INLINE_CACHE
             fun_data_len,
+            #endif
+            #if MICROPY_PERSISTENT_CODE_SAVE
             n_children,
             #endif
             scope_flags);
@@ -403,8 +405,12 @@ void mp_raw_code_load(mp_reader_t *reader, mp_compiled_module_t *cm) {
     byte arch = MPY_FEATURE_DECODE_ARCH(header[2]);
     if (header[0] != 'M'
         || header[1] != MPY_VERSION
-        || (arch != MP_NATIVE_ARCH_NONE && MPY_FEATURE_DECODE_SUB_VERSION(header[2]) != MPY_SUB_VERSION)
-        || header[3] > MP_SMALL_INT_BITS) {
+        || (arch != MP_NATIVE_ARCH_NONE && MPY_FEATURE_DECODE_SUB_VERSION(header[2], header[3]) != MPY_SUB_VERSION)
+        || MPY_FEATURE_DECODE_SMALL_INT_BITS(header[3]) > MP_SMALL_INT_BITS
+        #if !MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+        || (header[3] & MPY_FEATURE_SUPERINSTRUCTIONS)
+        #endif
+        ) {
         mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
     }
     if (MPY_FEATURE_DECODE_ARCH(header[2]) != MP_NATIVE_ARCH_NONE) {
@@ -438,6 +444,7 @@ void mp_raw_code_load(mp_reader_t *reader, mp_compiled_module_t *cm) {
 
     #if MICROPY_PERSISTENT_CODE_SAVE
     cm->has_native = MPY_FEATURE_DECODE_ARCH(header[2]) != MP_NATIVE_ARCH_NONE;
+    cm->has_superinstructions = (header[3] & MPY_FEATURE_SUPERINSTRUCTIONS) != 0;
     cm->n_qstr = n_qstr;
     cm->n_obj = n_obj;
     #endif
@@ -600,16 +607,19 @@ void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print) {
     //  byte  'M'
     //  byte  version
     //  byte  native arch (and sub-version if native)
-    //  byte  number of bits in a small int
+    //  byte  number of bits in a small int (and superinstructions flag, and
+    //        high bit of sub-version if native)
     byte header[4] = {
         'M',
         MPY_VERSION,
         cm->has_native ? MPY_FEATURE_ENCODE_SUB_VERSION(MPY_SUB_VERSION) | MPY_FEATURE_ENCODE_ARCH(MPY_FEATURE_ARCH_DYNAMIC) : 0,
         #if MICROPY_DYNAMIC_COMPILER
-        mp_dynamic_compiler.small_int_bits,
+        mp_dynamic_compiler.small_int_bits
         #else
-        MP_SMALL_INT_BITS,
+        MP_SMALL_INT_BITS
         #endif
+        | (cm->has_superinstructions ? MPY_FEATURE_SUPERINSTRUCTIONS : 0)
+        | (cm->has_native ? MPY_FEATURE_ENCODE_SUB_VERSION_HI(MPY_SUB_VERSION) : 0),
     };
     mp_print_bytes(print, header, sizeof(header));
 
@@ -32,21 +32,33 @@
 
 // The current version of .mpy files. A bytecode-only .mpy file can be loaded
 // as long as MPY_VERSION matches, but a native .mpy (i.e. one with an arch
-// set) must also match MPY_SUB_VERSION. This allows 3 additional updates to
+// set) must also match MPY_SUB_VERSION. This allows 7 additional updates to
 // the native ABI per bytecode revision.
 #define MPY_VERSION 6
-#define MPY_SUB_VERSION 3
+#define MPY_SUB_VERSION 5
 
 // Macros to encode/decode sub-version to/from the feature byte. This replaces
 // the bits previously used to encode the flags (map caching and unicode)
-// which are no longer used starting at .mpy version 6.
-#define MPY_FEATURE_ENCODE_SUB_VERSION(version) (version)
-#define MPY_FEATURE_DECODE_SUB_VERSION(feat) ((feat) & 3)
+// which are no longer used starting at .mpy version 6.  Bit 2 of the
+// sub-version is stored in the small-int-bits byte, see below.
+#define MPY_FEATURE_ENCODE_SUB_VERSION(version) ((version) & 3)
+#define MPY_FEATURE_DECODE_SUB_VERSION(feat, bits) (((feat) & 3) | ((bits) >> 4 & 4))
 
 // Macros to encode/decode native architecture to/from the feature byte
 #define MPY_FEATURE_ENCODE_ARCH(arch) ((arch) << 2)
 #define MPY_FEATURE_DECODE_ARCH(feat) ((feat) >> 2)
 
+// Flag stored in the small-int-bits byte of the header when the bytecode may
+// contain fused superinstructions (see MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS).
+// Using the top bit means older VMs reject such files as incompatible.
+#define MPY_FEATURE_SUPERINSTRUCTIONS (0x80)
+
+// Bit 2 of the sub-version of a native .mpy is stored in bit 6 of the
+// small-int-bits byte.  Older VMs then see more than 63 small int bits and
+// reject such files as incompatible.
+#define MPY_FEATURE_ENCODE_SUB_VERSION_HI(version) (((version) & 4) << 4)
+#define MPY_FEATURE_DECODE_SMALL_INT_BITS(feat) ((feat) & 0x3f)
+
 // Define the host architecture
 #if MICROPY_EMIT_X86
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_X86)
@@ -71,6 +83,8 @@
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_XTENSA)
 #elif MICROPY_EMIT_XTENSAWIN
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_XTENSAWIN)
+#elif MICROPY_EMIT_ARM64
+    #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_ARM64)
 #else
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_NONE)
 #endif
@@ -79,9 +93,11 @@
 #define MPY_FEATURE_ARCH_TEST(x) ((x) == MPY_FEATURE_ARCH)
 #endif
 
-// 16-bit little-endian integer with the second and third bytes of supported .mpy files
+// Little-endian integer with the second and third bytes of supported .mpy
+// files, and the flags that native .mpy files have in their fourth byte
 #define MPY_FILE_HEADER_INT (MPY_VERSION \
-    | (MPY_FEATURE_ENCODE_SUB_VERSION(MPY_SUB_VERSION) | MPY_FEATURE_ENCODE_ARCH(MPY_FEATURE_ARCH)) << 8)
+    | (MPY_FEATURE_ENCODE_SUB_VERSION(MPY_SUB_VERSION) | MPY_FEATURE_ENCODE_ARCH(MPY_FEATURE_ARCH)) << 8 \
+    | MPY_FEATURE_ENCODE_SUB_VERSION_HI(MPY_SUB_VERSION) << 16)
 
 enum {
     MP_NATIVE_ARCH_NONE = 0,
@@ -95,6 +111,7 @@ enum {
     MP_NATIVE_ARCH_ARMV7EMDP,
     MP_NATIVE_ARCH_XTENSA,
     MP_NATIVE_ARCH_XTENSAWIN,
+    MP_NATIVE_ARCH_ARM64,
 };
 
 enum {
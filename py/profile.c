@@ -591,6 +591,18 @@ static const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->arg = unum;
             break;
 
+        #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+        case MP_BC_INPLACE_ADD_FAST:
+            instruction->qstr_opname = MP_QSTR_INPLACE_ADD_FAST;
+            instruction->arg = *ip++;
+            break;
+
+        case MP_BC_INPLACE_SUBTRACT_FAST:
+            instruction->qstr_opname = MP_QSTR_INPLACE_SUBTRACT_FAST;
+            instruction->arg = *ip++;
+            break;
+        #endif
+
         case MP_BC_STORE_DEREF:
             DECODE_UINT;
             instruction->qstr_opname = MP_QSTR_STORE_DEREF;
@@ -686,6 +698,15 @@ static const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->arg = unum;
             break;
 
+        #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+        case MP_BC_POP_JUMP_IF_COMPARE:
+            DECODE_SLABEL;
+            instruction->qstr_opname = MP_QSTR_POP_JUMP_IF_COMPARE;
+            instruction->arg = unum;
+            instruction->argobj = MP_OBJ_NEW_SMALL_INT(*ip++);
+            break;
+        #endif
+
         case MP_BC_JUMP_IF_TRUE_OR_POP:
             DECODE_SLABEL;
             instruction->qstr_opname = MP_QSTR_JUMP_IF_TRUE_OR_POP;
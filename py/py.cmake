@@ -8,6 +8,7 @@ list(APPEND MICROPY_INC_CORE "${MICROPY_DIR}")
 set(MICROPY_SOURCE_PY
     ${MICROPY_PY_DIR}/argcheck.c
     ${MICROPY_PY_DIR}/asmarm.c
+    ${MICROPY_PY_DIR}/asmarm64.c
     ${MICROPY_PY_DIR}/asmbase.c
     ${MICROPY_PY_DIR}/asmthumb.c
     ${MICROPY_PY_DIR}/asmx64.c
@@ -25,6 +26,7 @@ set(MICROPY_SOURCE_PY
     ${MICROPY_PY_DIR}/emitinlinethumb.c
     ${MICROPY_PY_DIR}/emitinlinextensa.c
     ${MICROPY_PY_DIR}/emitnarm.c
+    ${MICROPY_PY_DIR}/emitnarm64.c
     ${MICROPY_PY_DIR}/emitnthumb.c
     ${MICROPY_PY_DIR}/emitnx64.c
     ${MICROPY_PY_DIR}/emitnx86.c
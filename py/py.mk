@@ -109,6 +109,8 @@ PY_CORE_O_BASENAME = $(addprefix py/,\
 	emitinlinethumb.o \
 	asmarm.o \
 	emitnarm.o \
+	asmarm64.o \
+	emitnarm64.o \
 	asmxtensa.o \
 	emitnxtensa.o \
 	emitinlinextensa.o \
@@ -181,6 +181,9 @@ extern const qstr_pool_t MICROPY_QSTR_EXTRA_POOL;
 void qstr_init(void) {
     MP_STATE_VM(last_pool) = (qstr_pool_t *)&CONST_POOL; // we won't modify the const_pool since it has no allocated room left
     MP_STATE_VM(qstr_last_chunk) = NULL;
+    #if MICROPY_QSTR_HASH_INDEX
+    MP_STATE_VM(qstr_index) = NULL;
+    #endif
 
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_VM(qstr_mutex));
@@ -199,6 +202,87 @@ static const qstr_pool_t *find_qstr(qstr *q) {
     return pool;
 }
 
+#if MICROPY_QSTR_HASH_INDEX
+
+// Initial number of slots in the hash index, must be a power of 2.
+#define QSTR_INDEX_ALLOC_INIT (64)
+
+// The hash stored in the pools may be only 8 or 16 bits wide, which is too
+// narrow to spread a large table, so the index uses the full-width djb2 hash.
+static size_t qstr_index_hash(const byte *data, size_t len) {
+    size_t hash = 5381;
+    for (const byte *top = data + len; data < top; data++) {
+        hash = ((hash << 5) + hash) ^ (*data);
+    }
+    return hash ^ (hash >> 16);
+}
+
+static qstr qstr_index_lookup(const char *str, size_t str_len) {
+    const qstr_index_t *index = MP_STATE_VM(qstr_index);
+    if (index == NULL) {
+        return MP_QSTRnull;
+    }
+    size_t mask = index->alloc - 1;
+    for (size_t i = qstr_index_hash((const byte *)str, str_len) & mask;; i = (i + 1) & mask) {
+        qstr q = index->slots[i];
+        if (q == MP_QSTRnull) {
+            // found an empty slot, so the string is not in the dynamic pools
+            return MP_QSTRnull;
+        }
+        qstr at = q;
+        const qstr_pool_t *pool = find_qstr(&at);
+        if (pool->lengths[at] == str_len && memcmp(pool->qstrs[at], str, str_len) == 0) {
+            return q;
+        }
+    }
+}
+
+static void qstr_index_insert(qstr_index_t *index, qstr q, const char *str, size_t len) {
+    size_t i = qstr_index_hash((const byte *)str, len) & (index->alloc - 1);
+    while (index->slots[i] != MP_QSTRnull) {
+        i = (i + 1) & (index->alloc - 1);
+    }
+    index->slots[i] = q;
+    index->used++;
+}
+
+// Make sure there is room in the index for one more entry, keeping the load
+// factor at or below 1/2 so that probe sequences stay short.
+// qstr_mutex must be taken while in this function
+static void qstr_index_reserve(void) {
+    qstr_index_t *index = MP_STATE_VM(qstr_index);
+    if (index != NULL && 2 * (index->used + 1) <= index->alloc) {
+        return;
+    }
+    size_t new_alloc = index == NULL ? QSTR_INDEX_ALLOC_INIT : index->alloc * 2;
+    qstr_index_t *new_index = m_new_obj_var_maybe(qstr_index_t, slots, qstr, new_alloc);
+    if (new_index == NULL) {
+        QSTR_EXIT();
+        m_malloc_fail(sizeof(qstr_index_t) + new_alloc * sizeof(qstr));
+    }
+    new_index->alloc = new_alloc;
+    new_index->used = 0;
+    memset(new_index->slots, 0, new_alloc * sizeof(qstr));
+    if (index != NULL) {
+        for (size_t i = 0; i < index->alloc; i++) {
+            qstr q = index->slots[i];
+            if (q != MP_QSTRnull) {
+                size_t len;
+                const byte *data = qstr_data(q, &len);
+                qstr_index_insert(new_index, q, (const char *)data, len);
+            }
+        }
+        // Without the GIL another thread may still be probing the old table,
+        // so leave it for the GC to reclaim once it is unreachable.
+        #if !(MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL)
+        m_del_var(qstr_index_t, slots, qstr, index->alloc, index);
+        #endif
+    }
+    MP_STATE_VM(qstr_index) = new_index;
+}
+
+#endif // MICROPY_QSTR_HASH_INDEX
+
 // qstr_mutex must be taken while in this function
 static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
     #if MICROPY_QSTR_BYTES_IN_HASH
@@ -208,6 +292,11 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
     DEBUG_printf("QSTR: add len=%d data=%.*s\n", len, len, q_ptr);
     #endif
 
+    #if MICROPY_QSTR_HASH_INDEX
+    // grow the index first so a failed allocation leaves the pools untouched
+    qstr_index_reserve();
+    #endif
+
     // make sure we have room in the pool for a new qstr
     if (MP_STATE_VM(last_pool)->len >= MP_STATE_VM(last_pool)->alloc) {
         size_t new_alloc = MP_STATE_VM(last_pool)->alloc * 2;
@@ -255,8 +344,14 @@ static qstr qstr_add(mp_uint_t len, const char *q_ptr) {
     MP_STATE_VM(last_pool)->qstrs[at] = q_ptr;
     MP_STATE_VM(last_pool)->len++;
 
+    qstr q = MP_STATE_VM(last_pool)->total_prev_len + at;
+
+    #if MICROPY_QSTR_HASH_INDEX
+    qstr_index_insert(MP_STATE_VM(qstr_index), q, q_ptr, len);
+    #endif
+
     // return id for the newly-added qstr
-    return MP_STATE_VM(last_pool)->total_prev_len + at;
+    return q;
 }
 
 qstr qstr_find_strn(const char *str, size_t str_len) {
@@ -270,8 +365,19 @@ qstr qstr_find_strn(const char *str, size_t str_len) {
     size_t str_hash = qstr_compute_hash((const byte *)str, str_len);
     #endif
 
+    #if MICROPY_QSTR_HASH_INDEX
+    // the dynamic pools are covered by the index, so only the ROM pools need searching
+    qstr q = qstr_index_lookup(str, str_len);
+    if (q != MP_QSTRnull) {
+        return q;
+    }
+    const qstr_pool_t *first_pool = &CONST_POOL;
+    #else
+    const qstr_pool_t *first_pool = MP_STATE_VM(last_pool);
+    #endif
+
     // search pools for the data
-    for (const qstr_pool_t *pool = MP_STATE_VM(last_pool); pool != NULL; pool = pool->prev) {
+    for (const qstr_pool_t *pool = first_pool; pool != NULL; pool = pool->prev) {
         size_t low = 0;
         size_t high = pool->len - 1;
 
@@ -419,6 +525,11 @@ void qstr_pool_info(size_t *n_pool, size_t *n_qstr, size_t *n_str_data_bytes, si
         #endif
     }
     *n_total_bytes += *n_str_data_bytes;
+    #if MICROPY_QSTR_HASH_INDEX
+    if (MP_STATE_VM(qstr_index) != NULL) {
+        *n_total_bytes += sizeof(qstr_index_t) + MP_STATE_VM(qstr_index)->alloc * sizeof(qstr);
+    }
+    #endif
     QSTR_EXIT();
 }
 
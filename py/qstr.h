@@ -91,6 +91,16 @@ typedef struct _qstr_pool_t {
     const char *qstrs[];
 } qstr_pool_t;
 
+#if MICROPY_QSTR_HASH_INDEX
+// Open-addressed hash table mapping to the qstrs held in the dynamic pools.
+// Each slot holds a qstr id, or MP_QSTRnull if the slot is empty.
+typedef struct _qstr_index_t {
+    size_t alloc; // always a power of 2
+    size_t used;
+    qstr slots[];
+} qstr_index_t;
+#endif
+
 #define QSTR_TOTAL() (MP_STATE_VM(last_pool)->total_prev_len + MP_STATE_VM(last_pool)->len)
 
 void qstr_init(void);
@@ -123,6 +123,10 @@ void mp_init(void) {
     MP_STATE_VM(track_reloc_code_list) = MP_OBJ_NULL;
     #endif
 
+    #if MICROPY_PY_BUILTINS_STR_UNICODE && MICROPY_OPT_STR_UNICODE_INDEX && (!MICROPY_PY_THREAD || MICROPY_PY_THREAD_GIL)
+    memset(MP_STATE_VM(str_index_cache), 0, sizeof(MP_STATE_VM(str_index_cache)));
+    #endif
+
     #if MICROPY_PY_OS_DUPTERM
     for (size_t i = 0; i < MICROPY_PY_OS_DUPTERM; ++i) {
         MP_STATE_VM(dupterm_objs[i]) = MP_OBJ_NULL;
@@ -160,6 +164,9 @@ void mp_init(void) {
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
+    #endif
+
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_PY_MICROPYTHON_HEAP_PROFILE
     MP_STATE_THREAD(current_code_state) = NULL;
     #endif
 
@@ -220,32 +227,191 @@ mp_obj_t MICROPY_WRAP_MP_LOAD_NAME(mp_load_name)(qstr qst) {
     return mp_load_global(qst);
 }
 
+static mp_obj_t mp_load_builtin(qstr qst) {
+    mp_map_elem_t *elem;
+    #if MICROPY_CAN_OVERRIDE_BUILTINS
+    if (MP_STATE_VM(mp_module_builtins_override_dict) != NULL) {
+        // lookup in additional dynamic table of builtins first
+        elem = mp_map_lookup(&MP_STATE_VM(mp_module_builtins_override_dict)->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+        if (elem != NULL) {
+            return elem->value;
+        }
+    }
+    #endif
+    elem = mp_map_lookup((mp_map_t *)&mp_module_builtins_globals.map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+    if (elem == NULL) {
+        #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+        mp_raise_msg(&mp_type_NameError, MP_ERROR_TEXT("name not defined"));
+        #else
+        mp_raise_msg_varg(&mp_type_NameError, MP_ERROR_TEXT("name '%q' isn't defined"), qst);
+        #endif
+    }
+    return elem->value;
+}
+
 mp_obj_t MICROPY_WRAP_MP_LOAD_GLOBAL(mp_load_global)(qstr qst) {
     // logic: search globals, builtins
     DEBUG_OP_printf("load global %s\n", qstr_str(qst));
     mp_map_elem_t *elem = mp_map_lookup(&mp_globals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
     if (elem == NULL) {
+        return mp_load_builtin(qst);
+    }
+    return elem->value;
+}
+
+#if MICROPY_OPT_INLINE_CACHE
+
+// An instruction's entry stops being replaced after this many misses, for
+// instructions that see many different types.
+#define INLINE_CACHE_MAX_FILLS (16)
+
+static void inline_cache_fill(mp_inline_cache_t *cache, const mp_inline_cache_entry_t **slot, size_t offset,
+    const mp_obj_type_t *type, mp_map_t *map, size_t index) {
+    if (index > 0xffff) {
+        return;
+    }
+    mp_inline_cache_entry_t *e = m_new_maybe(mp_inline_cache_entry_t, 1);
+    if (e == NULL) {
+        return;
+    }
+    e->type = type;
+    e->map = map;
+    e->epoch = MP_STATE_VM(inline_cache_epoch);
+    e->offset = offset;
+    e->index = index;
+    e->fills = *slot == NULL ? 0 : (*slot)->fills + 1;
+    // publish the entry only once it's complete
+    GC_WRITE_BARRIER(cache);
+    *slot = e;
+}
+
+// Looks up the name in the cached position of the given map.
+static inline mp_map_elem_t *inline_cache_get(const mp_inline_cache_entry_t *e, mp_map_t *map, qstr qst) {
+    if (e->index < map->alloc) {
+        mp_map_elem_t *elem = &map->table[e->index];
+        if (elem->key == MP_OBJ_NEW_QSTR(qst)) {
+            return elem;
+        }
+    }
+    return NULL;
+}
+
+// The caller passes in the current globals, which the VM already has at hand.
+mp_obj_t mp_load_global_cached(qstr qst, mp_obj_dict_t *globals, mp_inline_cache_t *cache, size_t offset) {
+    mp_map_t *map = &globals->map;
+    const mp_inline_cache_entry_t **slot = mp_inline_cache_slot(cache, offset);
+    const mp_inline_cache_entry_t *e = slot == NULL ? NULL : *slot;
+    mp_map_elem_t *elem;
+    if (e != NULL && e->map == NULL && (elem = inline_cache_get(e, map, qst)) != NULL) {
+        return elem->value;
+    }
+    elem = mp_map_lookup(map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+    bool can_fill = slot != NULL && (e == NULL || e->fills < INLINE_CACHE_MAX_FILLS);
+    if (elem == NULL) {
+        // a builtin; the globals lookup above must still be done each time
+        // to know the name hasn't since been defined as a global
+        mp_map_t *builtins_map = (mp_map_t *)&mp_module_builtins_globals.map;
         #if MICROPY_CAN_OVERRIDE_BUILTINS
         if (MP_STATE_VM(mp_module_builtins_override_dict) != NULL) {
-            // lookup in additional dynamic table of builtins first
-            elem = mp_map_lookup(&MP_STATE_VM(mp_module_builtins_override_dict)->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
-            if (elem != NULL) {
-                return elem->value;
-            }
+            return mp_load_builtin(qst);
         }
         #endif
-        elem = mp_map_lookup((mp_map_t *)&mp_module_builtins_globals.map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+        if (e != NULL && e->map == builtins_map && (elem = inline_cache_get(e, builtins_map, qst)) != NULL) {
+            return elem->value;
+        }
+        elem = mp_map_lookup(builtins_map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
         if (elem == NULL) {
-            #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-            mp_raise_msg(&mp_type_NameError, MP_ERROR_TEXT("name not defined"));
-            #else
-            mp_raise_msg_varg(&mp_type_NameError, MP_ERROR_TEXT("name '%q' isn't defined"), qst);
-            #endif
+            return mp_load_builtin(qst);
+        }
+        if (can_fill) {
+            inline_cache_fill(cache, slot, offset, NULL, builtins_map, elem - builtins_map->table);
         }
+        return elem->value;
+    }
+    if (can_fill) {
+        inline_cache_fill(cache, slot, offset, NULL, NULL, elem - map->table);
     }
     return elem->value;
 }
 
+void mp_load_method_cached(mp_obj_t base, qstr attr, mp_obj_t *dest, mp_inline_cache_t *cache, size_t offset) {
+    const mp_obj_type_t *type = mp_obj_get_type(base);
+    if (type != &mp_type_module && !mp_obj_is_instance_type(type)) {
+        // only attributes of modules and instances of user classes are cached
+        mp_load_method(base, attr, dest);
+        return;
+    }
+    const mp_inline_cache_entry_t **slot = mp_inline_cache_slot(cache, offset);
+    const mp_inline_cache_entry_t *e = slot == NULL ? NULL : *slot;
+
+    if (e != NULL && e->type == type) {
+        mp_map_t *map;
+        if (type == &mp_type_module) {
+            map = &((mp_obj_module_t *)MP_OBJ_TO_PTR(base))->globals->map;
+        } else {
+            mp_obj_instance_t *self = MP_OBJ_TO_PTR(base);
+            if (e->map == NULL) {
+                map = &self->members;
+            } else if (e->epoch == MP_STATE_VM(inline_cache_epoch)
+                       && mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP) == NULL) {
+                map = e->map;
+            } else {
+                map = NULL;
+            }
+        }
+        mp_map_elem_t *elem;
+        if (map != NULL && (elem = inline_cache_get(e, map, attr)) != NULL) {
+            dest[0] = elem->value;
+            dest[1] = MP_OBJ_NULL;
+            if (e->map != NULL) {
+                // a class attribute, which may be a method that binds self
+                mp_convert_member_lookup(base, type, elem->value, dest);
+            }
+            return;
+        }
+    }
+
+    mp_load_method(base, attr, dest);
+
+    // remember where the attribute was found; mp_load_method_maybe handles
+    // these names specially
+    if (slot == NULL || (e != NULL && e->fills >= INLINE_CACHE_MAX_FILLS)
+        || attr == MP_QSTR___class__ || attr == MP_QSTR___next__) {
+        return;
+    }
+    mp_map_elem_t *elem;
+    if (type == &mp_type_module) {
+        mp_map_t *map = &((mp_obj_module_t *)MP_OBJ_TO_PTR(base))->globals->map;
+        if ((elem = mp_map_lookup(map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP)) != NULL) {
+            inline_cache_fill(cache, slot, offset, type, NULL, elem - map->table);
+        }
+    } else {
+        mp_map_t *map = &((mp_obj_instance_t *)MP_OBJ_TO_PTR(base))->members;
+        size_t index;
+        if ((elem = mp_map_lookup(map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP)) != NULL) {
+            inline_cache_fill(cache, slot, offset, type, NULL, elem - map->table);
+        #if MICROPY_CPYTHON_COMPAT
+        } else if (attr == MP_QSTR___dict__) {
+            // instances handle this before looking in their class
+        #endif
+        } else if ((map = mp_obj_class_lookup_for_cache(type, attr, &index)) != NULL) {
+            inline_cache_fill(cache, slot, offset, type, map, index);
+        }
+    }
+}
+
+mp_obj_t mp_load_attr_cached(mp_obj_t base, qstr attr, mp_inline_cache_t *cache, size_t offset) {
+    mp_obj_t dest[2];
+    mp_load_method_cached(base, attr, dest, cache, offset);
+    if (dest[1] == MP_OBJ_NULL) {
+        return dest[0];
+    } else {
+        return mp_obj_new_bound_meth(dest[0], dest[1]);
+    }
+}
+
+#endif
+
 mp_obj_t mp_load_build_class(void) {
     DEBUG_OP_printf("load_build_class\n");
     #if MICROPY_CAN_OVERRIDE_BUILTINS
@@ -169,6 +169,11 @@ static inline void mp_thread_init_state(mp_state_thread_t *ts, size_t stack_size
     ts->nlr_jump_callback_top = NULL;
     ts->mp_pending_exception = MP_OBJ_NULL;
 
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    // No bytecode is running yet
+    ts->current_code_state = NULL;
+    #endif
+
     // If locals/globals are not given, inherit from main thread
     if (locals == NULL) {
         locals = mp_state_ctx.thread.dict_locals;
@@ -183,6 +188,10 @@ static inline void mp_thread_init_state(mp_state_thread_t *ts, size_t stack_size
 
 mp_obj_t mp_load_name(qstr qst);
 mp_obj_t mp_load_global(qstr qst);
+#if MICROPY_OPT_INLINE_CACHE
+struct _mp_inline_cache_t;
+mp_obj_t mp_load_global_cached(qstr qst, mp_obj_dict_t *globals, struct _mp_inline_cache_t *cache, size_t offset);
+#endif
 mp_obj_t mp_load_build_class(void);
 void mp_store_name(qstr qst, mp_obj_t obj);
 void mp_store_global(qstr qst, mp_obj_t obj);
@@ -228,6 +237,12 @@ void mp_load_method_maybe(mp_obj_t base, qstr attr, mp_obj_t *dest);
 void mp_load_method_protected(mp_obj_t obj, qstr attr, mp_obj_t *dest, bool catch_all_exc);
 void mp_load_super_method(qstr attr, mp_obj_t *dest);
 void mp_store_attr(mp_obj_t base, qstr attr, mp_obj_t val);
+#if MICROPY_OPT_INLINE_CACHE
+// Variants of mp_load_attr and mp_load_method that use the inline cache of
+// the bytecode instruction at the given offset.
+mp_obj_t mp_load_attr_cached(mp_obj_t base, qstr attr, struct _mp_inline_cache_t *cache, size_t offset);
+void mp_load_method_cached(mp_obj_t base, qstr attr, mp_obj_t *dest, struct _mp_inline_cache_t *cache, size_t offset);
+#endif
 
 mp_obj_t mp_getiter(mp_obj_t o, mp_obj_iter_buf_t *iter_buf);
 mp_obj_t mp_iternext_allow_raise(mp_obj_t o); // may return MP_OBJ_STOP_ITERATION instead of raising StopIteration()
@@ -258,6 +258,15 @@ const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start,
             mp_printf(print, "STORE_FAST_N " UINT_FMT, unum);
             break;
 
+        #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+        case MP_BC_INPLACE_ADD_FAST:
+        case MP_BC_INPLACE_SUBTRACT_FAST:
+            mp_printf(print, "%s %d %d", ip[-1] == MP_BC_INPLACE_ADD_FAST ? "INPLACE_ADD_FAST" : "INPLACE_SUBTRACT_FAST",
+                *ip >> 4, *ip & 0xf);
+            ip += 1;
+            break;
+        #endif
+
         case MP_BC_STORE_DEREF:
             DECODE_UINT;
             mp_printf(print, "STORE_DEREF " UINT_FMT, unum);
@@ -337,6 +346,15 @@ const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start,
             mp_printf(print, "POP_JUMP_IF_FALSE " UINT_FMT, (mp_uint_t)(ip + unum - ip_start));
             break;
 
+        #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+        case MP_BC_POP_JUMP_IF_COMPARE:
+            DECODE_SLABEL;
+            mp_printf(print, "POP_JUMP_IF_COMPARE " UINT_FMT " %s %s", (mp_uint_t)(ip + unum - ip_start),
+                qstr_str(mp_binary_op_method_name[*ip & 0x7f]), *ip & 0x80 ? "true" : "false");
+            ip += 1;
+            break;
+        #endif
+
         case MP_BC_JUMP_IF_TRUE_OR_POP:
             DECODE_ULABEL;
             mp_printf(print, "JUMP_IF_TRUE_OR_POP " UINT_FMT, (mp_uint_t)(ip + unum - ip_start));
@@ -527,6 +545,14 @@ const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start,
             break;
 
         default:
+            #if MICROPY_OPT_QUICKEN_BINARY_OP
+            if (ip[-1] >= MP_BC_BINARY_OP_QUICK_MULTI && ip[-1] < MP_BC_BINARY_OP_QUICK_MULTI + MP_BC_BINARY_OP_QUICK_MULTI_NUM) {
+                // a BINARY_OP that was specialised at runtime
+                mp_uint_t op = mp_bc_binary_op_quick_generic[ip[-1] - MP_BC_BINARY_OP_QUICK_MULTI];
+                mp_printf(print, "BINARY_OP " UINT_FMT " %s (quick)", op, qstr_str(mp_binary_op_method_name[op]));
+                break;
+            }
+            #endif
             if (ip[-1] < MP_BC_LOAD_CONST_SMALL_INT_MULTI + 64) {
                 mp_printf(print, "LOAD_CONST_SMALL_INT " INT_FMT, (mp_int_t)ip[-1] - MP_BC_LOAD_CONST_SMALL_INT_MULTI - 16);
             } else if (ip[-1] < MP_BC_LOAD_FAST_MULTI + 16) {
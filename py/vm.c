@@ -32,9 +32,12 @@
 #include "py/emitglue.h"
 #include "py/objtype.h"
 #include "py/objfun.h"
+#include "py/objstr.h"
+#include "py/smallint.h"
 #include "py/runtime.h"
 #include "py/bc0.h"
 #include "py/profile.h"
+#include "py/gc.h"
 
 // *FORMAT-OFF*
 
@@ -100,6 +103,50 @@
 
 #endif
 
+#if MICROPY_OPT_INLINE_CACHE
+// Remembers where the current instruction starts, to find its inline cache
+// entry.  Must come before the instruction's argument is decoded.
+#define DECODE_INLINE_CACHE const byte *ic_ip = ip
+#define INLINE_CACHE (code_state->fun_bc->inline_cache)
+#define INLINE_CACHE_OFFSET ((size_t)(ic_ip - code_state->fun_bc->bytecode))
+#else
+#define DECODE_INLINE_CACHE
+#endif
+
+#if MICROPY_OPT_QUICKEN_BINARY_OP
+// Performs a generic BINARY_OP, also rewriting the opcode at ip[-1] into the
+// variant specialised for the types of its operands if the bytecode is in RAM.
+#define BINARY_OP_GENERIC(op, lhs, rhs) \
+    ((MP_BC_BINARY_OP_QUICKEN_OPS >> (op) & 1) && code_state->fun_bc->bytecode_is_writable \
+    ? mp_bc_binary_op_quicken((byte *)&ip[-1], op, lhs, rhs) : mp_binary_op(op, lhs, rhs))
+#else
+#define BINARY_OP_GENERIC(op, lhs, rhs) mp_binary_op(op, lhs, rhs)
+#endif
+
+#if MICROPY_OPT_REUSE_FLOAT_TEMPS
+// A float made by a quickened float op is only referenced from the value stack.
+// If the next instruction is a BINARY_OP then it is consumed there, so can hold
+// the result of that op instead of allocating a new float.  The same holds if
+// there's one instruction in between that only pushes a local or a constant.
+// Any other BINARY_OP must forget the float, in case it escapes and reaches the
+// same BINARY_OP later by a jump.
+#define FLOAT_TEMP_CLEAR() (float_temp = MP_OBJ_NULL)
+
+// Returns true if the instruction at ip only pushes a value, and ends at end.
+static inline bool vm_is_push_only(const byte *ip, const byte *end) {
+    if (ip + 1 == end) {
+        return (MP_BC_LOAD_CONST_SMALL_INT_MULTI <= *ip && *ip < MP_BC_LOAD_CONST_SMALL_INT_MULTI + MP_BC_LOAD_CONST_SMALL_INT_MULTI_NUM)
+               || (MP_BC_LOAD_FAST_MULTI <= *ip && *ip < MP_BC_LOAD_FAST_MULTI + MP_BC_LOAD_FAST_MULTI_NUM);
+    } else if (ip + 2 == end) {
+        // these have a one-byte argument
+        return (*ip == MP_BC_LOAD_CONST_OBJ || *ip == MP_BC_LOAD_FAST_N) && !(ip[1] & 0x80);
+    }
+    return false;
+}
+#else
+#define FLOAT_TEMP_CLEAR()
+#endif
+
 #define DECODE_PTR \
     DECODE_UINT; \
     void *ptr = (void *)(uintptr_t)code_state->fun_bc->child_table[unum]
@@ -187,6 +234,19 @@
     } \
 } while(0)
 
+#elif MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+
+// Keep track of the running bytecode function for the heap profiler.
+#define FRAME_SETUP() do { \
+    MP_STATE_THREAD(current_code_state) = code_state; \
+} while (0)
+#define FRAME_ENTER()
+#define FRAME_LEAVE() do { \
+    MP_STATE_THREAD(current_code_state) = prev_code_state; \
+} while (0)
+#define FRAME_UPDATE()
+#define TRACE_TICK(current_ip, current_sp, is_exception)
+
 #else // MICROPY_PY_SYS_SETTRACE
 #define FRAME_SETUP()
 #define FRAME_ENTER()
@@ -250,6 +310,10 @@ mp_vm_return_kind_t MICROPY_WRAP_MP_EXECUTE_BYTECODE(mp_execute_bytecode)(mp_cod
     // loop and the exception handler, leading to very obscure bugs.
     #define RAISE(o) do { nlr_pop(); nlr.ret_val = MP_OBJ_TO_PTR(o); goto exception_handler; } while (0)
 
+#if !MICROPY_PY_SYS_SETTRACE && MICROPY_PY_MICROPYTHON_HEAP_PROFILE
+    struct _mp_code_state_t *prev_code_state = MP_STATE_THREAD(current_code_state);
+#endif
+
 #if MICROPY_STACKLESS
 run_code_state: ;
 #endif
@@ -290,6 +354,11 @@ outer_dispatch_loop:
             const qstr_short_t *qstr_table = code_state->fun_bc->context->constants.qstr_table;
             #endif
             mp_obj_t obj_shared;
+            #if MICROPY_OPT_REUSE_FLOAT_TEMPS
+            // The last float made by a quickened float op, and the ip just after it.
+            mp_obj_t float_temp = MP_OBJ_NULL;
+            const byte *float_temp_ip = NULL;
+            #endif
             MICROPY_VM_HOOK_INIT
 
             // If we have exception to inject, now that we finish setting up
@@ -387,7 +456,14 @@ dispatch_loop:
 
                 ENTRY(MP_BC_LOAD_GLOBAL): {
                     MARK_EXC_IP_SELECTIVE();
+                    DECODE_INLINE_CACHE;
                     DECODE_QSTR;
+                    #if MICROPY_OPT_INLINE_CACHE
+                    if (INLINE_CACHE != NULL) {
+                        PUSH(mp_load_global_cached(qst, code_state->fun_bc->context->module.globals, INLINE_CACHE, INLINE_CACHE_OFFSET));
+                        DISPATCH();
+                    }
+                    #endif
                     PUSH(mp_load_global(qst));
                     DISPATCH();
                 }
@@ -395,6 +471,7 @@ dispatch_loop:
                 ENTRY(MP_BC_LOAD_ATTR): {
                     FRAME_UPDATE();
                     MARK_EXC_IP_SELECTIVE();
+                    DECODE_INLINE_CACHE;
                     DECODE_QSTR;
                     mp_obj_t top = TOP();
                     mp_obj_t obj;
@@ -412,6 +489,11 @@ dispatch_loop:
                         obj = elem->value;
                     } else
                     #endif
+                    #if MICROPY_OPT_INLINE_CACHE
+                    if (INLINE_CACHE != NULL) {
+                        obj = mp_load_attr_cached(top, qst, INLINE_CACHE, INLINE_CACHE_OFFSET);
+                    } else
+                    #endif
                     {
                         obj = mp_load_attr(top, qst);
                     }
@@ -421,7 +503,15 @@ dispatch_loop:
 
                 ENTRY(MP_BC_LOAD_METHOD): {
                     MARK_EXC_IP_SELECTIVE();
+                    DECODE_INLINE_CACHE;
                     DECODE_QSTR;
+                    #if MICROPY_OPT_INLINE_CACHE
+                    if (INLINE_CACHE != NULL) {
+                        mp_load_method_cached(*sp, qst, sp, INLINE_CACHE, INLINE_CACHE_OFFSET);
+                        sp += 1;
+                        DISPATCH();
+                    }
+                    #endif
                     mp_load_method(*sp, qst, sp);
                     sp += 1;
                     DISPATCH();
@@ -453,6 +543,31 @@ dispatch_loop:
                     DISPATCH();
                 }
 
+                #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+                ENTRY(MP_BC_INPLACE_ADD_FAST):
+                ENTRY(MP_BC_INPLACE_SUBTRACT_FAST): {
+                    MARK_EXC_IP_SELECTIVE();
+                    FLOAT_TEMP_CLEAR();
+                    byte op = ip[-1];
+                    mp_obj_t *local = &fastn[-(*ip >> 4)];
+                    mp_int_t rhs_val = *ip++ & 0xf;
+                    if (*local == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    if (mp_obj_is_small_int(*local)) {
+                        mp_int_t val = MP_OBJ_SMALL_INT_VALUE(*local);
+                        val = op == MP_BC_INPLACE_ADD_FAST ? val + rhs_val : val - rhs_val;
+                        if (MP_SMALL_INT_FITS(val)) {
+                            *local = MP_OBJ_NEW_SMALL_INT(val);
+                            DISPATCH();
+                        }
+                    }
+                    *local = mp_binary_op(op == MP_BC_INPLACE_ADD_FAST ? MP_BINARY_OP_INPLACE_ADD : MP_BINARY_OP_INPLACE_SUBTRACT,
+                        *local, MP_OBJ_NEW_SMALL_INT(rhs_val));
+                    DISPATCH();
+                }
+                #endif
+
                 ENTRY(MP_BC_STORE_DEREF): {
                     DECODE_UINT;
                     mp_obj_cell_set(fastn[-unum], POP());
@@ -575,6 +690,49 @@ dispatch_loop:
                     DISPATCH_WITH_PEND_EXC_CHECK();
                 }
 
+                #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+                ENTRY(MP_BC_POP_JUMP_IF_COMPARE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    FLOAT_TEMP_CLEAR();
+                    DECODE_SLABEL;
+                    const byte *dest_ip = ip + slab;
+                    byte op = *ip++;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = POP();
+                    bool res;
+                    if (mp_obj_is_small_int(lhs) && mp_obj_is_small_int(rhs)) {
+                        mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+                        mp_int_t rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs);
+                        switch (op & 0x7f) {
+                            case MP_BINARY_OP_LESS:
+                                res = lhs_val < rhs_val;
+                                break;
+                            case MP_BINARY_OP_MORE:
+                                res = lhs_val > rhs_val;
+                                break;
+                            case MP_BINARY_OP_EQUAL:
+                                res = lhs_val == rhs_val;
+                                break;
+                            case MP_BINARY_OP_LESS_EQUAL:
+                                res = lhs_val <= rhs_val;
+                                break;
+                            case MP_BINARY_OP_MORE_EQUAL:
+                                res = lhs_val >= rhs_val;
+                                break;
+                            default:
+                                res = lhs_val != rhs_val;
+                                break;
+                        }
+                    } else {
+                        res = mp_obj_is_true(mp_binary_op(op & 0x7f, lhs, rhs));
+                    }
+                    if (res == (op >> 7)) {
+                        ip = dest_ip;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+                #endif
+
                 ENTRY(MP_BC_JUMP_IF_TRUE_OR_POP): {
                     DECODE_ULABEL;
                     if (mp_obj_is_true(TOP())) {
@@ -1250,6 +1408,162 @@ yield:
                     mp_import_all(POP());
                     DISPATCH();
 
+                #if MICROPY_OPT_QUICKEN_BINARY_OP
+                ENTRY(MP_BC_BINARY_OP_INT_ADD):
+                ENTRY(MP_BC_BINARY_OP_INT_INPLACE_ADD):
+                ENTRY(MP_BC_BINARY_OP_INT_SUBTRACT):
+                ENTRY(MP_BC_BINARY_OP_INT_MULTIPLY):
+                ENTRY(MP_BC_BINARY_OP_INT_LESS):
+                ENTRY(MP_BC_BINARY_OP_INT_MORE):
+                ENTRY(MP_BC_BINARY_OP_INT_EQUAL): {
+                    mp_obj_t rhs = TOP();
+                    mp_obj_t lhs = sp[-1];
+                    if (!mp_obj_is_small_int(lhs) || !mp_obj_is_small_int(rhs)) {
+                        goto binary_op_deoptimise;
+                    }
+                    mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+                    mp_int_t rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs);
+                    mp_obj_t res;
+                    switch (ip[-1]) {
+                        case MP_BC_BINARY_OP_INT_ADD:
+                        case MP_BC_BINARY_OP_INT_INPLACE_ADD:
+                            lhs_val += rhs_val;
+                            break;
+                        case MP_BC_BINARY_OP_INT_SUBTRACT:
+                            lhs_val -= rhs_val;
+                            break;
+                        case MP_BC_BINARY_OP_INT_MULTIPLY:
+                            if (mp_small_int_mul_overflow(lhs_val, rhs_val)) {
+                                goto binary_op_quick_fallback;
+                            }
+                            lhs_val *= rhs_val;
+                            break;
+                        case MP_BC_BINARY_OP_INT_LESS:
+                            res = mp_obj_new_bool(lhs_val < rhs_val);
+                            goto binary_op_quick_result;
+                        case MP_BC_BINARY_OP_INT_MORE:
+                            res = mp_obj_new_bool(lhs_val > rhs_val);
+                            goto binary_op_quick_result;
+                        default:
+                            res = mp_obj_new_bool(lhs_val == rhs_val);
+                            goto binary_op_quick_result;
+                    }
+                    if (!MP_SMALL_INT_FITS(lhs_val)) {
+                        goto binary_op_quick_fallback;
+                    }
+                    res = MP_OBJ_NEW_SMALL_INT(lhs_val);
+                binary_op_quick_result:
+                    sp--;
+                    SET_TOP(res);
+                    DISPATCH();
+                }
+
+                #if MICROPY_PY_BUILTINS_FLOAT
+                ENTRY(MP_BC_BINARY_OP_FLOAT_ADD):
+                ENTRY(MP_BC_BINARY_OP_FLOAT_SUBTRACT):
+                ENTRY(MP_BC_BINARY_OP_FLOAT_MULTIPLY):
+                ENTRY(MP_BC_BINARY_OP_FLOAT_TRUE_DIVIDE):
+                ENTRY(MP_BC_BINARY_OP_FLOAT_LESS):
+                ENTRY(MP_BC_BINARY_OP_FLOAT_MORE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_obj_t rhs = TOP();
+                    mp_obj_t lhs = sp[-1];
+                    // each operand must be a float or a small int, but not both small ints
+                    mp_float_t lhs_val, rhs_val;
+                    if (mp_obj_is_float(lhs)) {
+                        lhs_val = mp_obj_float_get(lhs);
+                        if (mp_obj_is_float(rhs)) {
+                            rhs_val = mp_obj_float_get(rhs);
+                        } else if (mp_obj_is_small_int(rhs)) {
+                            rhs_val = (mp_float_t)MP_OBJ_SMALL_INT_VALUE(rhs);
+                        } else {
+                            goto binary_op_deoptimise;
+                        }
+                    } else if (mp_obj_is_small_int(lhs) && mp_obj_is_float(rhs)) {
+                        lhs_val = (mp_float_t)MP_OBJ_SMALL_INT_VALUE(lhs);
+                        rhs_val = mp_obj_float_get(rhs);
+                    } else {
+                        goto binary_op_deoptimise;
+                    }
+                    mp_float_t res_val;
+                    switch (ip[-1]) {
+                        case MP_BC_BINARY_OP_FLOAT_ADD:
+                            res_val = lhs_val + rhs_val;
+                            break;
+                        case MP_BC_BINARY_OP_FLOAT_SUBTRACT:
+                            res_val = lhs_val - rhs_val;
+                            break;
+                        case MP_BC_BINARY_OP_FLOAT_MULTIPLY:
+                            res_val = lhs_val * rhs_val;
+                            break;
+                        case MP_BC_BINARY_OP_FLOAT_TRUE_DIVIDE:
+                            if (rhs_val == 0) {
+                                // let the generic op raise ZeroDivisionError
+                                goto binary_op_quick_fallback;
+                            }
+                            res_val = lhs_val / rhs_val;
+                            break;
+                        default:
+                            FLOAT_TEMP_CLEAR();
+                            sp--;
+                            SET_TOP(mp_obj_new_bool(ip[-1] == MP_BC_BINARY_OP_FLOAT_LESS ? lhs_val < rhs_val : lhs_val > rhs_val));
+                            DISPATCH();
+                    }
+                    mp_obj_t res;
+                    #if MICROPY_OPT_REUSE_FLOAT_TEMPS
+                    if (rhs == float_temp && float_temp_ip == ip - 1) {
+                        res = mp_obj_float_reuse(rhs, res_val);
+                    } else if (lhs == float_temp && vm_is_push_only(float_temp_ip, ip - 1)) {
+                        res = mp_obj_float_reuse(lhs, res_val);
+                    } else
+                    #endif
+                    {
+                        res = mp_obj_new_float(res_val);
+                    }
+                    #if MICROPY_OPT_REUSE_FLOAT_TEMPS
+                    float_temp = res;
+                    float_temp_ip = ip;
+                    #endif
+                    sp--;
+                    SET_TOP(res);
+                    DISPATCH();
+                }
+                #endif
+
+                ENTRY(MP_BC_BINARY_OP_STR_ADD): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_obj_t rhs = TOP();
+                    mp_obj_t lhs = sp[-1];
+                    if (!mp_obj_is_str(lhs) || !mp_obj_is_str(rhs)) {
+                        goto binary_op_deoptimise;
+                    }
+                    sp--;
+                    SET_TOP(mp_obj_str_binary_op(MP_BINARY_OP_ADD, lhs, rhs));
+                    DISPATCH();
+                }
+
+                binary_op_deoptimise:
+                    // The operands aren't of the types this opcode was specialised
+                    // for, so put back the generic opcode, which may specialise it
+                    // again for these operands the next time it runs.
+                    *(byte *)&ip[-1] = MP_BC_BINARY_OP_MULTI + mp_bc_binary_op_quick_generic[ip[-1] - MP_BC_BINARY_OP_QUICK_MULTI];
+                    goto binary_op_quick_fallback;
+
+                binary_op_quick_fallback: {
+                    // Either deoptimised, or the operands have the expected types but
+                    // the result needs the generic op (eg it overflows a small int).
+                    MARK_EXC_IP_SELECTIVE();
+                    FLOAT_TEMP_CLEAR();
+                    mp_binary_op_t op = ip[-1] < MP_BC_BINARY_OP_MULTI
+                        ? mp_bc_binary_op_quick_generic[ip[-1] - MP_BC_BINARY_OP_QUICK_MULTI]
+                        : (mp_binary_op_t)(ip[-1] - MP_BC_BINARY_OP_MULTI);
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = TOP();
+                    SET_TOP(mp_binary_op(op, lhs, rhs));
+                    DISPATCH();
+                }
+                #endif
+
                 #if MICROPY_OPT_COMPUTED_GOTO
                 ENTRY(MP_BC_LOAD_CONST_SMALL_INT_MULTI):
                     PUSH(MP_OBJ_NEW_SMALL_INT((mp_int_t)ip[-1] - MP_BC_LOAD_CONST_SMALL_INT_MULTI - MP_BC_LOAD_CONST_SMALL_INT_MULTI_EXCESS));
@@ -1270,9 +1584,10 @@ yield:
 
                 ENTRY(MP_BC_BINARY_OP_MULTI): {
                     MARK_EXC_IP_SELECTIVE();
+                    FLOAT_TEMP_CLEAR();
                     mp_obj_t rhs = POP();
                     mp_obj_t lhs = TOP();
-                    SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                    SET_TOP(BINARY_OP_GENERIC(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                     DISPATCH();
                 }
 
@@ -1293,9 +1608,10 @@ yield:
                         SET_TOP(mp_unary_op(ip[-1] - MP_BC_UNARY_OP_MULTI, TOP()));
                         DISPATCH();
                     } else if (ip[-1] < MP_BC_BINARY_OP_MULTI + MP_BC_BINARY_OP_MULTI_NUM) {
+                        FLOAT_TEMP_CLEAR();
                         mp_obj_t rhs = POP();
                         mp_obj_t lhs = TOP();
-                        SET_TOP(mp_binary_op(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
+                        SET_TOP(BINARY_OP_GENERIC(ip[-1] - MP_BC_BINARY_OP_MULTI, lhs, rhs));
                         DISPATCH();
                     } else
                 #endif // MICROPY_OPT_COMPUTED_GOTO
@@ -1344,6 +1660,14 @@ pending_exception_check:
                     mp_handle_pending(true);
                 }
 
+                #if MICROPY_GC_INCREMENTAL
+                // Do a bounded amount of incremental GC work if a cycle is in progress.
+                if (MP_STATE_MEM(gc_inc_poll)) {
+                    MARK_EXC_IP_SELECTIVE();
+                    gc_step_poll();
+                }
+                #endif
+
                 #if MICROPY_PY_THREAD_GIL
                 #if MICROPY_PY_THREAD_GIL_VM_DIVISOR
                 // Don't bounce the GIL too frequently (default every 32 branches).
@@ -1414,23 +1738,8 @@ unwind_loop:
             if (nlr.ret_val != &mp_const_GeneratorExit_obj
                 && *code_state->ip != MP_BC_END_FINALLY
                 && *code_state->ip != MP_BC_RAISE_LAST) {
-                const byte *ip = code_state->fun_bc->bytecode;
-                MP_BC_PRELUDE_SIG_DECODE(ip);
-                MP_BC_PRELUDE_SIZE_DECODE(ip);
-                const byte *line_info_top = ip + n_info;
-                const byte *bytecode_start = ip + n_info + n_cell;
-                size_t bc = code_state->ip - bytecode_start;
-                qstr block_name = mp_decode_uint_value(ip);
-                for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
-                    ip = mp_decode_uint_skip(ip);
-                }
-                #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
-                block_name = code_state->fun_bc->context->constants.qstr_table[block_name];
-                qstr source_file = code_state->fun_bc->context->constants.qstr_table[0];
-                #else
-                qstr source_file = code_state->fun_bc->context->constants.source_file;
-                #endif
-                size_t source_line = mp_bytecode_get_source_line(ip, line_info_top, bc);
+                qstr source_file, block_name;
+                size_t source_line = mp_bytecode_get_source_info(code_state->fun_bc, code_state->ip, &source_file, &block_name);
                 mp_obj_exception_add_traceback(MP_OBJ_FROM_PTR(nlr.ret_val), source_file, source_line, block_name);
             }
 
@@ -55,6 +55,10 @@ static const void *const entry_table[256] = {
     [MP_BC_LOAD_SUBSCR] = &&entry_MP_BC_LOAD_SUBSCR,
     [MP_BC_STORE_FAST_N] = &&entry_MP_BC_STORE_FAST_N,
     [MP_BC_STORE_DEREF] = &&entry_MP_BC_STORE_DEREF,
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    [MP_BC_INPLACE_ADD_FAST] = &&entry_MP_BC_INPLACE_ADD_FAST,
+    [MP_BC_INPLACE_SUBTRACT_FAST] = &&entry_MP_BC_INPLACE_SUBTRACT_FAST,
+    #endif
     [MP_BC_STORE_NAME] = &&entry_MP_BC_STORE_NAME,
     [MP_BC_STORE_GLOBAL] = &&entry_MP_BC_STORE_GLOBAL,
     [MP_BC_STORE_ATTR] = &&entry_MP_BC_STORE_ATTR,
@@ -71,6 +75,9 @@ static const void *const entry_table[256] = {
     [MP_BC_JUMP] = &&entry_MP_BC_JUMP,
     [MP_BC_POP_JUMP_IF_TRUE] = &&entry_MP_BC_POP_JUMP_IF_TRUE,
     [MP_BC_POP_JUMP_IF_FALSE] = &&entry_MP_BC_POP_JUMP_IF_FALSE,
+    #if MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS
+    [MP_BC_POP_JUMP_IF_COMPARE] = &&entry_MP_BC_POP_JUMP_IF_COMPARE,
+    #endif
     [MP_BC_JUMP_IF_TRUE_OR_POP] = &&entry_MP_BC_JUMP_IF_TRUE_OR_POP,
     [MP_BC_JUMP_IF_FALSE_OR_POP] = &&entry_MP_BC_JUMP_IF_FALSE_OR_POP,
     [MP_BC_SETUP_WITH] = &&entry_MP_BC_SETUP_WITH,
@@ -113,6 +120,24 @@ static const void *const entry_table[256] = {
     [MP_BC_IMPORT_NAME] = &&entry_MP_BC_IMPORT_NAME,
     [MP_BC_IMPORT_FROM] = &&entry_MP_BC_IMPORT_FROM,
     [MP_BC_IMPORT_STAR] = &&entry_MP_BC_IMPORT_STAR,
+    #if MICROPY_OPT_QUICKEN_BINARY_OP
+    [MP_BC_BINARY_OP_INT_ADD] = &&entry_MP_BC_BINARY_OP_INT_ADD,
+    [MP_BC_BINARY_OP_INT_INPLACE_ADD] = &&entry_MP_BC_BINARY_OP_INT_INPLACE_ADD,
+    [MP_BC_BINARY_OP_INT_SUBTRACT] = &&entry_MP_BC_BINARY_OP_INT_SUBTRACT,
+    [MP_BC_BINARY_OP_INT_MULTIPLY] = &&entry_MP_BC_BINARY_OP_INT_MULTIPLY,
+    [MP_BC_BINARY_OP_INT_LESS] = &&entry_MP_BC_BINARY_OP_INT_LESS,
+    [MP_BC_BINARY_OP_INT_MORE] = &&entry_MP_BC_BINARY_OP_INT_MORE,
+    [MP_BC_BINARY_OP_INT_EQUAL] = &&entry_MP_BC_BINARY_OP_INT_EQUAL,
+    #if MICROPY_PY_BUILTINS_FLOAT
+    [MP_BC_BINARY_OP_FLOAT_ADD] = &&entry_MP_BC_BINARY_OP_FLOAT_ADD,
+    [MP_BC_BINARY_OP_FLOAT_SUBTRACT] = &&entry_MP_BC_BINARY_OP_FLOAT_SUBTRACT,
+    [MP_BC_BINARY_OP_FLOAT_MULTIPLY] = &&entry_MP_BC_BINARY_OP_FLOAT_MULTIPLY,
+    [MP_BC_BINARY_OP_FLOAT_TRUE_DIVIDE] = &&entry_MP_BC_BINARY_OP_FLOAT_TRUE_DIVIDE,
+    [MP_BC_BINARY_OP_FLOAT_LESS] = &&entry_MP_BC_BINARY_OP_FLOAT_LESS,
+    [MP_BC_BINARY_OP_FLOAT_MORE] = &&entry_MP_BC_BINARY_OP_FLOAT_MORE,
+    #endif
+    [MP_BC_BINARY_OP_STR_ADD] = &&entry_MP_BC_BINARY_OP_STR_ADD,
+    #endif
     [MP_BC_LOAD_CONST_SMALL_INT_MULTI ... MP_BC_LOAD_CONST_SMALL_INT_MULTI + MP_BC_LOAD_CONST_SMALL_INT_MULTI_NUM - 1] = &&entry_MP_BC_LOAD_CONST_SMALL_INT_MULTI,
     [MP_BC_LOAD_FAST_MULTI ... MP_BC_LOAD_FAST_MULTI + MP_BC_LOAD_FAST_MULTI_NUM - 1] = &&entry_MP_BC_LOAD_FAST_MULTI,
     [MP_BC_STORE_FAST_MULTI ... MP_BC_STORE_FAST_MULTI + MP_BC_STORE_FAST_MULTI_NUM - 1] = &&entry_MP_BC_STORE_FAST_MULTI,
@@ -0,0 +1,127 @@
+# test that repeated attribute lookups see changes to instances, classes and globals
+
+
+class A:
+    x = 1
+
+    def f(self):
+        return "A.f"
+
+
+class B(A):
+    pass
+
+
+def get(o):
+    return o.x, o.f()
+
+
+a = A()
+b = B()
+for i in range(3):
+    print(get(a), get(b))
+
+# change a class attribute in place
+A.x = 2
+print(get(a), get(b))
+
+# shadow the base class attribute and method in the subclass
+B.x = 3
+B.f = lambda self: "B.f"
+print(get(a), get(b))
+
+# shadow the method in an instance
+b.f = lambda: "b.f"
+print(get(a), get(b))
+del b.f
+print(get(a), get(b))
+
+# remove the shadowing attributes again
+del B.x
+del B.f
+print(get(a), get(b))
+
+# instance attributes, with members in different orders
+class C:
+    def __init__(self, first):
+        if first:
+            self.p = 1
+            self.q = 2
+        else:
+            self.q = 3
+            self.p = 4
+
+
+for o in [C(True), C(False), C(True), C(False)]:
+    print(o.p, o.q)
+
+
+# one lookup site seeing many types
+class D:
+    x = "D"
+
+
+class E:
+    def __init__(self):
+        self.x = "E"
+
+
+for o in [a, b, D(), E(), a, D(), E()]:
+    print(o.x)
+
+# a method replaced by a static method and a class method
+class F:
+    def g(self):
+        return "method"
+
+
+def call_g(o):
+    return o.g()
+
+
+f = F()
+print(call_g(f))
+F.g = staticmethod(lambda: "static")
+print(call_g(f))
+F.g = classmethod(lambda cls: cls.__name__)
+print(call_g(f))
+
+# globals that are changed, deleted and shadow builtins
+g = 1
+
+
+def get_g():
+    return g
+
+
+print(get_g())
+g = 2
+print(get_g())
+del g
+try:
+    get_g()
+except NameError:
+    print("NameError")
+g = 3
+print(get_g())
+
+
+def get_len():
+    return len("abc")
+
+
+print(get_len())
+len = lambda x: "shadowed"
+print(get_len())
+del len
+print(get_len())
+
+# module attributes
+import sys
+
+
+def get_maxsize(m):
+    return m.maxsize
+
+
+print(get_maxsize(sys) == get_maxsize(sys) == sys.maxsize)
@@ -0,0 +1,58 @@
+# test arithmetic and string conversion of ints with thousands of digits,
+# large enough to use the subquadratic algorithms when they are enabled
+
+
+def make_int(nbits, seed):
+    x = seed
+    n = 0
+    for _ in range(nbits // 30 + 1):
+        x = (x * 1103515245 + 12345) & 0x7FFFFFFF
+        n = (n << 30) | (x & 0x3FFFFFFF)
+    return n >> (30 * (nbits // 30 + 1) - nbits)
+
+
+def check(n):
+    # print a short summary of a large number
+    print(n % 1000000007, n & 0xFFFFFFFF, len(hex(n)))
+
+
+nums = []
+for nbits in (1000, 3000, 9000, 20000):
+    nums.append(make_int(nbits, nbits))
+    nums.append((1 << nbits) - 1)
+    nums.append(1 << nbits)
+
+# multiplication, balanced and unbalanced, and squaring
+for a in nums:
+    for b in nums:
+        check(a * b)
+    check(a * a)
+    check(-a * a)
+
+# division against multiplication
+for a in nums:
+    for b in nums:
+        for n in (a * b + b // 2, a * b - 1, a * b + b - 1):
+            q, r = divmod(n, b)
+            print(q == a or q == a - 1, q * b + r == n, 0 <= r < b)
+            q, r = divmod(-n, b)
+            print(q * b + r == -n, 0 <= -r or r == 0)
+
+# conversion to and from strings in different bases
+for a in nums[:6]:
+    for v in (a, -a):
+        s = str(v)
+        print(len(s), s[:10], s[-10:], int(s) == v)
+        s = hex(v)
+        print(len(s), s[:10], s[-10:], int(s, 16) == v)
+        s = oct(v)
+        print(len(s), s[-10:], int(s, 8) == v)
+        s = bin(v)
+        print(len(s), s[-10:], int(s, 2) == v)
+        print(int(str(v) + "0") == v * 10)
+        print(int(hex(v) + "f", 16) == v * 16 + (15 if v > 0 else -15))
+
+# grouping of digits
+for n in (10**2999, 10**3000 - 1, 10**3001 + 12345, -(10**3002) + 1):
+    s = "{:,}".format(n)
+    print(len(s), s[:12], s[-12:])
@@ -0,0 +1,82 @@
+# test that list.sort is stable and calls the key function once per item
+
+# stability with a key, with and without reverse
+l = [(i % 3, i) for i in range(40)]
+print(sorted(l, key=lambda x: x[0]))
+print(sorted(l, key=lambda x: x[0], reverse=True))
+
+# stability of items that compare equal but are distinct
+class A:
+    def __init__(self, k, n):
+        self.k = k
+        self.n = n
+
+    def __lt__(self, other):
+        return self.k < other.k
+
+    def __repr__(self):
+        return "%d:%d" % (self.k, self.n)
+
+
+l = [A(i * 7 % 5, i) for i in range(50)]
+l.sort()
+print(l)
+l.sort(reverse=True)
+print(l)
+
+# the key function is called exactly once for each item
+calls = 0
+
+
+def key(x):
+    global calls
+    calls += 1
+    return -x
+
+
+l = list(range(100))
+l.sort(key=key)
+print(calls, l[0], l[-1])
+
+# already-sorted, reversed and nearly-sorted input, longer than a run
+l = list(range(100))
+l.sort()
+print(l == list(range(100)))
+l.sort(reverse=True)
+print(l == list(range(99, -1, -1)))
+l.sort()
+print(l == list(range(100)))
+l.append(50)
+l.sort()
+print(l[49:53], len(l))
+
+# strings, including ones that aren't interned
+l = ["b" * (i % 4) + str(i % 7) for i in range(60)]
+print(sorted(l))
+print(sorted(l, reverse=True) == sorted(l)[::-1])
+
+# mixed types fall back to generic comparisons
+print(sorted([3, 1.5, 2, -1, 0.5, True]))
+
+# the list is left unchanged if the key function raises
+l = [3, 2, 1]
+
+
+def bad_key(x):
+    if x == 1:
+        raise ValueError
+    return x
+
+
+try:
+    l.sort(key=bad_key)
+except ValueError:
+    print("ValueError")
+print(l)
+
+# the list must not be changed by the key function
+l = [3, 2, 1]
+try:
+    l.sort(key=lambda x: l.append(x) or x)
+except ValueError:
+    print("ValueError")
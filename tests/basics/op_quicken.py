@@ -0,0 +1,98 @@
+# test binary ops whose operand types change at the same call site, so that
+# any runtime specialisation of the op must fall back to the generic op
+
+
+def add(a, b):
+    return a + b
+
+
+def iadd(a, b):
+    a += b
+    return a
+
+
+def sub(a, b):
+    return a - b
+
+
+def isub(a, b):
+    a -= b
+    return a
+
+
+def mul(a, b):
+    return a * b
+
+
+def div(a, b):
+    return a / b
+
+
+def cmp(a, b):
+    return a < b, a > b, a == b, a != b
+
+
+# the same site sees small ints, floats, strings and other types
+for args in (
+    (1, 2),
+    (1, 2),
+    (1.5, 2),
+    (2, 1.5),
+    (1.5, 2.5),
+    ("ab", "cd"),
+    ("ab", "cd"),
+    (b"ab", b"cd"),
+    ([1], [2]),
+    ((1,), (2,)),
+    (1, 2),
+    (1.5, 2.5),
+):
+    print(add(*args), iadd(*args))
+
+for args in ((5, 3), (5, 3), (5.5, 3), (5, 0.5), (5, 3), ({1, 2}, {2}), (5.5, 3)):
+    print(sub(*args), isub(*args))
+
+for args in ((3, 4), (3, 4), (1.5, 4), (3, 4), ("ab", 3), (3, [1]), (3, 4)):
+    print(mul(*args))
+
+for args in ((1, 2), (1, 2), (1.5, 2), (3, 1), ("a", "b"), ((1,), (0,)), (1.0, 1)):
+    print(cmp(*args))
+
+# in-place add on a list after the site has seen ints must mutate the list
+l = [1]
+iadd(1, 2)
+iadd(1, 2)
+r = iadd(l, [2])
+print(r is l, l)
+
+# small int results that overflow into big ints
+x = 1 << 29
+for i in range(4):
+    print(add(x, x), sub(-x, x), mul(x, x), mul(-x, 4))
+    x *= 2
+
+# float division by zero
+for args in ((1.5, 2), (1.5, 0), (1, 0.0), (1.5, 2)):
+    try:
+        print(div(*args))
+    except ZeroDivisionError:
+        print("ZeroDivisionError")
+
+# user types at a site that has seen floats
+class A:
+    def __add__(self, other):
+        return "A+"
+
+    def __radd__(self, other):
+        return "+A"
+
+
+print(add(1.5, 2.5), add(A(), 1.5), add(1.5, A()), add(1.5, 2.5))
+
+# a loop that mixes types each iteration
+acc = 0
+for v in (1, 2.5, 3, 4.5, 5):
+    acc = acc + v
+    acc += v
+    acc = acc * 2
+print(acc)
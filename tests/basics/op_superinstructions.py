@@ -0,0 +1,139 @@
+# test sequences that may be fused into superinstructions by the compiler:
+# in-place add/subtract of a small constant to a local, and compare-and-jump
+
+
+def inplace_int(n):
+    a = 0
+    b = 100
+    for _ in range(n):
+        a += 1
+        b -= 15
+    return a, b
+
+
+print(inplace_int(10))
+
+
+def inplace_overflow():
+    # crossing the small-int boundary must fall back to a big int
+    a = 1 << 40
+    for _ in range(3):
+        a += 15
+        a -= 1
+        a = a * a
+    b = -(1 << 30)
+    b -= 1
+    b -= 15
+    c = (1 << 30) - 1
+    c += 1
+    c += 15
+    return a, b, c
+
+
+print(inplace_overflow())
+
+
+def inplace_other(x):
+    x += 1
+    x -= 2
+    return x
+
+
+print(inplace_other(1.5))
+print(inplace_other(True))
+
+
+class A:
+    def __init__(self):
+        self.log = []
+
+    def __iadd__(self, other):
+        self.log.append(("iadd", other))
+        return self
+
+    def __isub__(self, other):
+        self.log.append(("isub", other))
+        return self
+
+
+print(inplace_other(A()).log)
+
+
+def inplace_type_error(x):
+    x += 1
+
+
+try:
+    inplace_type_error("str")
+except TypeError:
+    print("TypeError")
+
+
+def many_locals():
+    # locals and constants beyond the range of the fused forms
+    l0 = l1 = l2 = l3 = l4 = l5 = l6 = l7 = l8 = l9 = l10 = l11 = l12 = l13 = l14 = l15 = 0
+    l16 = 0
+    l15 += 15
+    l15 += 16
+    l16 += 1
+    l16 -= 16
+    return l0, l15, l16
+
+
+print(many_locals())
+
+
+def compare(a, b):
+    r = []
+    if a < b:
+        r.append("<")
+    if a <= b:
+        r.append("<=")
+    if a > b:
+        r.append(">")
+    if a >= b:
+        r.append(">=")
+    if a == b:
+        r.append("==")
+    if a != b:
+        r.append("!=")
+    if not a < b:
+        r.append("!<")
+    if not a == b:
+        r.append("!==")
+    return r
+
+
+for a, b in (
+    (1, 2),
+    (2, 2),
+    (3, 2),
+    (-1, -(1 << 40)),
+    (1 << 40, 1 << 40),
+    (1.5, 2),
+    (2, 2.0),
+    ("a", "b"),
+    ("b", "b"),
+    ((1, 2), (1, 3)),
+):
+    print(a, b, compare(a, b))
+
+try:
+    compare(1, "a")
+except TypeError:
+    print("TypeError")
+
+
+def count_down(n):
+    c = 0
+    while n > 0:
+        n -= 3
+        c += 1
+    while n != 10:
+        n += 1
+    return c, n
+
+
+print(count_down(20))
+print(count_down(-5))
+print(count_down(31))
@@ -0,0 +1,13 @@
+# test in-place add of a small constant to an unbound local, which may be
+# fused into a superinstruction by the compiler
+
+
+def inplace_unbound():
+    a += 1
+    a = 0
+
+
+try:
+    inplace_unbound()
+except NameError:
+    print("NameError")
@@ -0,0 +1,65 @@
+# tests str/bytes/tuple constant folding and dead-branch elimination in compiler
+
+print("abc" + "def")
+print("ab" * 3)
+print(3 * "ab")
+print("ab" * 0, "ab" * -1)
+print("a" + "b" * 2 + "c")
+print(len("x" * 1000))
+print(b"ab" + b"cd")
+print(b"ab" * 3)
+print((1, 2) + (3,))
+print((1, "a") * 2)
+print(() * 5)
+
+# comparisons
+print(1 < 2, 2 < 1, 1 < 2 < 3, 1 < 3 < 2, 1 == 1 != 2)
+print("a" < "b", "a" == "a", "b" <= "a", b"a" != b"b")
+
+# mismatched types must be left until runtime
+try:
+    "a" + 1
+except TypeError:
+    print("TypeError")
+try:
+    "a" + b"a"
+except TypeError:
+    print("TypeError")
+try:
+    "a" * 1.5
+except TypeError:
+    print("TypeError")
+try:
+    "a" < 1
+except TypeError:
+    print("TypeError")
+try:
+    (1,) < "a"
+except TypeError:
+    print("TypeError")
+
+
+# dead branches
+def f(x):
+    if 1 > 2:
+        print("unreachable")
+    elif "a" == "a":
+        print("elif")
+    else:
+        print("unreachable")
+    while 2 < 1:
+        print("unreachable")
+    assert 1 < 2
+    y = "yes" if 1 < 2 else "no"
+    z = "yes" if 1 > 2 else "no"
+    return (x if 1 == 1 else -x), y, z
+
+
+print(f(5))
+
+
+def g():
+    return 1 if "a" > "b" else 2
+
+
+print(g())
@@ -0,0 +1,22 @@
+# test substring search with haystacks long enough to use the fast algorithm
+
+# periodic and non-periodic needles, found and not found
+hay = ("ab" * 20 + "c") * 10 + "abcabd" + "x" * 40
+for needle in ("abababc", "ababababx", "abcabd", "cab", "abd" + "x" * 10, "aab", "xxxxy", "ab" * 21):
+    print(needle, hay.find(needle), hay.rfind(needle), needle in hay, hay.count(needle))
+
+# needles near the start and end, and overlapping matches
+hay = "aaa" + "b" * 50 + "aaa"
+for needle in ("aaa", "aab", "baa", "aaab", "baaa", "bbb"):
+    print(needle, hay.find(needle), hay.rfind(needle), hay.count(needle))
+print(hay.find("aaa", 1), hay.rfind("aaa", 0, 55), hay.find("bbb", 52), hay.rfind("bbb", 0, 5))
+
+# split, rsplit and replace with a multi-character separator
+hay = "one--two--three" * 5
+print(hay.split("--"))
+print(hay.rsplit("--", 3))
+print(hay.replace("--", "+"))
+
+# bytes and bytearray
+hay = b"xyz" * 20 + b"needle" + b"xyz" * 20
+print(hay.find(b"needle"), hay.rfind(b"xyzxyz"), b"zxyn" in hay, bytearray(b"nee") in bytearray(hay))
@@ -54,12 +54,14 @@ b = _SMALLINT and _STR
 if b == _STR:
     print("Kept")
 
-# The compiler is also unable to optimise these expressions, even though the arguments are const,
-# so these also contain JUMP_IF
+# This comparison of const strs is folded, so no JUMP_IF is needed
 
 if (_EMPTY_TUPLE or _STR) == _STR:
     print("Kept")
 
+# The compiler is unable to optimise these expressions, even though the arguments are const,
+# so these still contain JUMP_IF
+
 if (_EMPTY_TUPLE and _STR) == _STR:
     print("Not Eliminated")
 
@@ -0,0 +1,85 @@
+try:
+    # Check if deflate is available.
+    import deflate
+    import io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# Check if compression levels are enabled.
+try:
+    deflate.DeflateIO(io.BytesIO(), deflate.RAW, 8, False, 1)
+except (AttributeError, ValueError):
+    print("SKIP")
+    raise SystemExit
+
+
+def compress(data, format=deflate.RAW, wbits=8, level=6, chunk=None):
+    b = io.BytesIO()
+    with deflate.DeflateIO(b, format, wbits, False, level) as g:
+        if chunk is None:
+            g.write(data)
+        else:
+            for i in range(0, len(data), chunk):
+                g.write(data[i : i + chunk])
+    return b.getvalue()
+
+
+def decompress(data, format=deflate.RAW, wbits=8):
+    with deflate.DeflateIO(io.BytesIO(data), format, wbits) as g:
+        return g.read()
+
+
+# Invalid values for level.
+for level in (-1, 10):
+    try:
+        compress(b"micropython", level=level)
+    except ValueError:
+        print("ValueError")
+
+# Short inputs.
+for data in (b"a", b"ab", b"abc", b"abcabc", b"micropython" * 10):
+    for level in (1, 6, 9):
+        print(level, decompress(compress(data, level=level)) == data)
+
+# Make some data that looks like a log file.
+lines = []
+lfsr = 1 << 15 | 1
+for i in range(400):
+    bit = (lfsr ^ (lfsr >> 1) ^ (lfsr >> 3) ^ (lfsr >> 12)) & 1
+    lfsr = (lfsr >> 1) | (bit << 15)
+    lines.append(
+        "%04d %s sensor%d value=%d\n" % (i, ("INFO", "WARN", "ERROR")[lfsr % 3], lfsr % 7, lfsr)
+    )
+log = "".join(lines).encode()
+
+# Fill buf with a predictable pseudorandom sequence, which does not compress.
+buf = bytearray(2048)
+for i in range(len(buf)):
+    bit = (lfsr ^ (lfsr >> 1) ^ (lfsr >> 3) ^ (lfsr >> 12)) & 1
+    lfsr = (lfsr >> 1) | (bit << 15)
+    buf[i] = lfsr & 0xFF
+
+# Round trip with all levels, in one write and in small chunks which split
+# matches across writes.
+for level in range(1, 10):
+    for wbits in (5, 8, 12):
+        results = []
+        for data in (log, buf, bytes(3000)):
+            for chunk in (None, 7):
+                results.append(decompress(compress(data, wbits=wbits, level=level, chunk=chunk), wbits=wbits) == data)
+        print(level, wbits, results)
+
+# Levels 1-9 should compress better than level 0, and higher levels should
+# not be worse than level 1.
+len0 = len(compress(log, wbits=10, level=0))
+len1 = len(compress(log, wbits=10, level=1))
+len9 = len(compress(log, wbits=10, level=9))
+print(len1 < len0, len9 <= len1)
+
+# Incompressible data should hardly grow.
+print(len(compress(buf, level=6)) < len(buf) + 16)
+
+# Check the zlib and gzip formats.
+for format in (deflate.ZLIB, deflate.GZIP):
+    print(decompress(compress(log, format, 15, 9), format, 15) == log)
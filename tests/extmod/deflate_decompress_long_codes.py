@@ -0,0 +1,90 @@
+# Test deflate decompression of Huffman codes longer than 9 bits, and that
+# the source stream is left just after the compressed data.
+
+try:
+    import deflate, io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+# Symbol frequencies follow the Fibonacci sequence, which gives Huffman codes
+# of up to 13 bits.
+def make_data():
+    data = bytearray()
+    a, b = 1, 1
+    for i in range(13):
+        data.extend(bytes((65 + i,)) * a)
+        a, b = b, a + b
+    x = 1
+    for i in range(len(data) - 1, 0, -1):
+        x = (x * 1103515245 + 12345) & 0x7FFFFFFF
+        j = x % (i + 1)
+        data[i], data[j] = data[j], data[i]
+    return bytes(data)
+
+
+data = make_data()
+
+# The above data compressed by CPython's zlib with Z_HUFFMAN_ONLY, as a raw
+# stream with a single dynamic block.
+data_raw = (
+    b"\x05\xc1\x81\x01\xc30\x0c\xc3\xb0\xdb\xb6\xb5\x89-\x91\xff\xbf3`\xf6!7"
+    b"\x84q\xb6q;\xa2R\xb7\x13\xdb\xee^\x86k)/7E\xe9\xc21\x01\x06\\[j\x95E"
+    b"\xf2#-\xad5\xcde\xed<9\xc1\xd4\xae\x83kP\xbf*\x95\x14\xa5JU#\xb5\xe2&"
+    b"\xa9\x0b*EY\x8b\xe8\xabh+m\xf9\xf8\x00\x12\xe8\x05\x05\xb4Z\x81$\x04"
+    b"\xe8\xa5$\x82\x8c(\x1ac\x89\n\xa8\x88\x15K\xb1aW\xcej]\x15E5:E\xb1]"
+    b"\xb9\xa8q\x8bk\xbb\xd2\xd7\xd8\x8c]\xa8U\xabAEOk\xea\xd8\x96\xa8\x08"
+    b"\xab\xa2*\xd6\xd3\xaa5TX]\xaa\xe8\xad\xaa\xf4XQ\x161\xa2\x8e\x8a\"&#"
+    b"\x82*U;6u*\xa2\xaa\xc9U\xaf\x16\t\x89\xb9^T\x7f}\x19\xabVq\x8f\xb8F"
+    b"\xf1\xa8\xc1\x9dM\xbb\x00\xcc\x02\xd4A\x11\x10\xdf4\x7f"
+)
+
+# The same, preceded by a stored block of 5 bytes.
+data_stored = b"\x00\x05\x00\xfa\xffhello" + data_raw
+
+# The same block made non-final, followed by an empty stored block and a fixed
+# Huffman block of b"hello", whose tree must not keep any of the long codes.
+data_fixed = (
+    bytes((data_raw[0] & 0xFE,)) + data_raw[1:] + b"\x00\x00\x00\xff\xff\xcbH\xcd\xc9\xc9\x07\x00"
+)
+
+try:
+
+    class Stream(io.IOBase):
+        def __init__(self, buf):
+            self.buf = buf
+            self.pos = 0
+
+        def readinto(self, buf):
+            n = min(len(buf), len(self.buf) - self.pos)
+            buf[:n] = self.buf[self.pos : self.pos + n]
+            self.pos += n
+            return n
+
+        def read(self):
+            return self.buf[self.pos :]
+
+    streams = (io.BytesIO, Stream)
+except AttributeError:
+    streams = (io.BytesIO,)
+
+for stream in streams:
+    for expected, compressed in (
+        (data, data_raw),
+        (b"hello" + data, data_stored),
+        (data + b"hello", data_fixed),
+    ):
+        for chunk in (None, 1, 100):
+            src = stream(compressed + b"tail")
+            with deflate.DeflateIO(src, deflate.RAW, 15) as g:
+                if chunk is None:
+                    out = g.read()
+                else:
+                    out = b""
+                    while True:
+                        part = g.read(chunk)
+                        if not part:
+                            break
+                        out += part
+            print(len(out), out == expected, src.read())
@@ -9,3 +9,9 @@ print(json.load(StringIO("null")))
 print(json.load(StringIO('"abc\\u0064e"')))
 print(json.load(StringIO("[false, true, 1, -2]")))
 print(json.load(StringIO('{"a":true}')))
+
+# documents longer than the chunks read from the stream, with escapes and
+# numbers at many different offsets
+l = [["x" * i + '\n"é', i, i / 4] for i in range(0, 9000, 97)]
+print(json.load(StringIO(json.dumps(l))) == l)
+print(json.loads(json.dumps(l)) == l)
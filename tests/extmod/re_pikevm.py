@@ -0,0 +1,46 @@
+# Test patterns which are matched with the Pike VM rather than by backtracking.
+
+try:
+    import re
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+def print_groups(m, n):
+    if m is None:
+        print(m)
+    else:
+        print([m.group(i) for i in range(n + 1)])
+
+
+# These take exponential time to fail when backtracking.
+print(re.match("(a+)+b", "a" * 1000))
+print(re.match("(a|aa)*c", "a" * 1000))
+print(re.search("(x+x+)+y", "x" * 1000))
+print(re.match("(\\w+\\s?)*$", "a log line with a trailing bad char" * 10 + "!"))
+print_groups(re.search("(a+)+b", "x" + "a" * 20 + "b"), 1)
+
+# Captures follow the same preferences as backtracking.
+print_groups(re.match("(a|ab)(c|bcd)(d*)", "abcd"), 3)
+print_groups(re.match("(a|ab)*?(b*)", "abab"), 2)
+print_groups(re.match("(a|b)*c", "abbac"), 1)
+print_groups(re.match("((a)|b)+", "ab"), 2)
+print_groups(re.search("(a|b)+$", "cabc ab"), 1)
+
+# Loops whose body can match empty.
+print_groups(re.match("()*", "x"), 0)
+print_groups(re.match("(a?)*b", "aab"), 0)
+print_groups(re.match("(a*)+", "aa"), 0)
+print_groups(re.match("(|a)*b", "ab"), 0)
+
+# Search, with and without a literal first character.
+print_groups(re.search("b(a|c)*d", "abcbcacd"), 1)
+print_groups(re.search("(b)(a|c)*d", "bbbacd"), 2)
+print_groups(re.search("bc", "ababab"), 0)
+print_groups(re.search("^b", "ab"), 0)
+print_groups(re.search("a$", "aaa"), 0)
+print(re.compile("x(?:a|b)*y").split("1xaby2xy3xz"))
+print(re.sub("x(a|b)*y", "-", "1xaby2xy3xz"))
+print(re.sub("a", "-", "banana"))
+print(re.sub("^a", "-", "aaa"))
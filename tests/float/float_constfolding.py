@@ -0,0 +1,45 @@
+# tests float constant folding in parser
+
+print(1.5 + 2)
+print(2 - 0.5)
+print(1.5 * 4)
+print(1 / 4)
+print(7 / 2)
+print(7.5 // 2)
+print(-7.5 // 2)
+print(7.5 % 2)
+print(-7.5 % 2)
+print(2.0**10)
+print(2**-1)
+print(4**0.5)
+print(-2.5)
+print(+2.5)
+print(-(-2.5))
+print(1.5 * 2 + 3 / 4 - 0.25)
+print(1 < 1.5, 2.0 == 2, 2.5 >= 3)
+
+# operations that raise must be left until runtime
+try:
+    1 / 0
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    1.5 // 0
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    1.5 % 0.0
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+try:
+    ~1.5
+except TypeError:
+    print("TypeError")
+try:
+    1.5 << 2
+except TypeError:
+    print("TypeError")
+try:
+    1.5 | 2
+except TypeError:
+    print("TypeError")
@@ -0,0 +1,82 @@
+# test that floats that are results of arithmetic are not changed by later
+# arithmetic, when the VM reuses temporary floats for results
+
+
+def sum_sq(x, y, z):
+    return x * x + y * y + z * z
+
+
+def keep(x, y):
+    a = x * y
+    b = a + 1.5
+    c = a * y
+    return a, b, c
+
+
+def walrus(x, y):
+    r = (t := x * y) + 1.5
+    return t, r
+
+
+def chained(x, y, z, w):
+    return x < y * z < w, y * z
+
+
+def in_list(x, y):
+    l = [x * y, x * y + 1.0]
+    l.append(l[0] * 2.0)
+    return l
+
+
+def jump(c, a, b, e):
+    # the BINARY_OP after the "and" is reached from the multiply and by a jump
+    return e + (c and a * b)
+
+
+def lhs_after_load(x, y):
+    u = x * y
+    return x * y - 2.5, x * y / 2, u
+
+
+for i in range(3):
+    print(sum_sq(1.5, 2.5, 3.5))
+    print(keep(1.5, 2.0))
+    print(walrus(1.5, 2.0))
+    print(chained(1.0, 1.5, 2.0, 4.0))
+    print(in_list(1.5, 3.0))
+    print(lhs_after_load(1.5, 3.0))
+
+# the "and" short-circuits and passes a float from a variable to the add
+v = 2.5
+for c in (1.0, 0.0, 1.0, v, 0.0):
+    print(jump(c, 1.5, 2.0, 0.25), c, v)
+
+# a result that escapes must not be changed by the next operation
+results = []
+for i in range(4):
+    x = i * 0.5
+    y = x * 3.0
+    results.append(y)
+    z = y + 1.0
+    results.append(z)
+print(results)
+
+# generators keep their value stack across yields
+def gen(x):
+    for i in range(3):
+        yield x * 2.0 + (yield x * 3.0)
+
+
+g = gen(1.5)
+print(next(g), g.send(1.0), next(g), g.send(2.0))
+
+# exceptions between producing and using a temporary
+def div(x, y):
+    try:
+        return x * 2.0 / y
+    except ZeroDivisionError:
+        return x * 2.0 + 1.0
+
+
+for y in (2.0, 0.0, 4.0, 0.0):
+    print(div(1.5, y))
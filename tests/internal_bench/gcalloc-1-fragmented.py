@@ -0,0 +1,20 @@
+import bench
+import gc
+
+
+def test(num):
+    # Fragment the heap with small live objects, then time multi-block allocations.
+    live = []
+    for i in range(num // 2000):
+        tmp = (i, i)
+        live.append([i])
+    tmp = None
+    gc.collect()
+    bufs = []
+    for i in range(num // 4000):
+        bufs.append(bytearray(200))
+        if len(bufs) > 50:
+            bufs.pop(0)
+
+
+bench.run(test)
@@ -0,0 +1,12 @@
+import bench
+import gc
+
+
+def test(num):
+    # Fill a good part of the heap with small live objects, then time collections.
+    live = [[i] for i in range(num // 1000)]
+    for i in range(num // 100000):
+        gc.collect()
+
+
+bench.run(test)
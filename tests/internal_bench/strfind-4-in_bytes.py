@@ -0,0 +1,17 @@
+# Substring search in a 100k haystack with a long needle that nearly matches
+# at every position but never occurs, the worst case for a simple search
+import bench
+
+hay = ("a" * 499 + "b") * 200
+needle = "a" * 99 + "c"
+bhay = hay.encode()
+bahay = bytearray(bhay)
+bneedle = needle.encode()
+
+
+def test(num):
+    for i in range(num // 200000):
+        bneedle in bhay
+
+
+bench.run(test)
@@ -18,7 +18,7 @@ test_syntax("A = const(1); A = const(2)")
 
 # these operations are not supported within const
 test_syntax("A = const(1 @ 2)")
-test_syntax("A = const(1 / 2)")
+test_syntax("A = const(1 / 0)")
 test_syntax("A = const(1 ** -2)")
 test_syntax("A = const(1 << -2)")
 test_syntax("A = const(1 >> -2)")
@@ -0,0 +1,75 @@
+# test incremental garbage collection with gc.step()
+
+import gc
+
+try:
+    gc.step
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def make_closure(n):
+    def f():
+        return n
+
+    return f
+
+
+def gen(n):
+    acc = []
+    for i in range(n):
+        acc.append([i])
+        yield len(acc)
+
+
+# Build up structures, mutating them while incremental collection runs.
+d = {}
+lst = []
+s = set()
+fs = []
+g = gen(1000)
+for i in range(500):
+    gc.step(50)
+    d[i] = [i, str(i)]
+    lst.append({"k": i})
+    s.add(str(i) * 2)
+    if i % 10 == 0:
+        fs.append(make_closure([i]))
+    next(g)
+    if i % 50 == 0:
+        # drop references to let the collector free something
+        d = {k: v for k, v in d.items() if k % 2 == 0}
+
+ok = True
+for k, v in d.items():
+    if v[0] != k or v[1] != str(k):
+        ok = False
+for i, x in enumerate(lst):
+    if x["k"] != i:
+        ok = False
+for i, f in enumerate(fs):
+    if f()[0] != i * 10:
+        ok = False
+if len(s) != 500 or next(g) != 501:
+    ok = False
+print(ok)
+
+# Run cycles to completion.
+while not gc.step(10000):
+    pass
+print(gc.step(0) in (True, False))
+
+# Let allocations drive the collector.
+print(gc.incremental())
+gc.incremental(True)
+print(gc.incremental())
+keep = []
+for i in range(2000):
+    keep.append((i, [i] * 3))
+    if len(keep) > 100:
+        keep = keep[50:]
+print(all(t[1] == [t[0]] * 3 for t in keep))
+gc.incremental(False)
+print(gc.incremental())
+gc.collect()
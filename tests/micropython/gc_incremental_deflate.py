@@ -0,0 +1,87 @@
+# test C code that lazily allocates state and stores it without a write barrier
+# (DeflateIO creates its read and write state on first use) during gc.step()
+
+import gc
+import io
+
+try:
+    gc.step
+    import deflate
+except (AttributeError, ImportError):
+    print("SKIP")
+    raise SystemExit
+
+# zlib.compress(b"0123456789abcdef" * 256, 9)
+data = b"0123456789abcdef" * 256
+compressed = b"x\xda\xed\xc7\xd9\x15\xc0\x10\x00\x00\xb0\x95\x94\xba\xc6A\xd9\x7f\x84\xee\xe1%\x7f\tOLo.\xb5\xf51\xd7\xb7Opwwwwww\xf7\xeb\xfe\x03h\xd2b="
+
+# The stream goes in holder[1] and a long chain in holder[0].  Marking holder
+# scans the stream first, then the chain takes many steps to mark (a chain
+# rather than a wide list, so the mark stack doesn't overflow and force a full
+# rescan).  The stream's state is allocated during those steps.
+chain = None
+for i in range(2000):
+    chain = [chain]
+holder = [chain, None]
+chain = None
+
+
+def finish_cycle():
+    while not gc.step():
+        pass
+    # overwrite any memory that was wrongly freed by filling up the heap
+    junk = []
+    try:
+        while True:
+            junk.append(bytearray(b"\xff" * 8))
+    except MemoryError:
+        pass
+    # a stale reference to junk may be left on the C stack, so empty it
+    junk.clear()
+
+
+# These start a cycle, use the stream so it allocates its state, and return
+# before the cycle finishes so that the C stack doesn't refer to the stream.
+def start_read(n_steps):
+    holder[1] = deflate.DeflateIO(io.BytesIO(compressed), deflate.ZLIB)
+    for _ in range(n_steps):
+        gc.step(0)
+    return holder[1].read(100)
+
+
+def start_write(n_steps):
+    buf = io.BytesIO()
+    holder[1] = deflate.DeflateIO(buf, deflate.ZLIB)
+    for _ in range(n_steps):
+        gc.step(0)
+    holder[1].write(data[:100])
+    return buf
+
+
+def test_read(n_steps):
+    out = start_read(n_steps)
+    finish_cycle()
+    try:
+        return out + holder[1].read() == data
+    except OSError:
+        return False
+
+
+def test_write(n_steps):
+    buf = start_write(n_steps)
+    finish_cycle()
+    try:
+        holder[1].write(data[100:])
+        holder[1].close()
+    except OSError:
+        return False
+    return deflate.DeflateIO(io.BytesIO(buf.getvalue()), deflate.ZLIB).read() == data
+
+
+finish_cycle()
+print(all([test_read(n) for n in range(8)]))
+if hasattr(deflate.DeflateIO, "write"):
+    ok = all([test_write(n) for n in range(8)])
+else:
+    ok = True
+print(ok)
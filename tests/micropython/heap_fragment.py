@@ -0,0 +1,33 @@
+# Test allocating, growing and freeing objects of mixed sizes in a fragmented heap.
+
+import gc
+
+seed = 1
+
+
+def rand(n):
+    global seed
+    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+    return seed % n
+
+
+sizes = (1, 5, 17, 40, 100, 300, 1000)
+live = []
+for i in range(3000):
+    r = rand(10)
+    if r < 5 and len(live) < 40:
+        # allocate a new object
+        live.append(bytearray(bytes([i & 0xFF]) * sizes[rand(len(sizes))]))
+    elif r < 9 and live:
+        # drop a random object
+        live[rand(len(live))] = live[-1]
+        live.pop()
+    elif live:
+        # grow a random object in place or by moving it
+        b = live[rand(len(live))]
+        b.extend(bytes([b[0]]) * (1 + rand(200)))
+    if i % 500 == 0:
+        gc.collect()
+
+# check that no object was corrupted by an overlapping allocation
+print(all(b == bytes([b[0]]) * len(b) for b in live))
@@ -0,0 +1,46 @@
+# test micropython.heap_profile()
+
+import micropython
+
+try:
+    micropython.heap_profile
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def make_lists(n):
+    for i in range(n):
+        [i, i]
+
+
+# sample every allocation
+micropython.heap_profile(1)
+make_lists(100)
+micropython.heap_profile(0)
+
+sites = micropython.heap_profile()
+print(type(sites))
+found = False
+for file, func, line, count, nbytes in sites:
+    if func == "make_lists":
+        found = True
+        print(line, count >= 100, nbytes >= 100 * 8)
+print(found)
+
+# sampling stopped, so the table doesn't change
+make_lists(10)
+print(micropython.heap_profile() == sites)
+
+# sample every 10th allocation, starting with a clear table
+micropython.heap_profile(10)
+make_lists(100)
+micropython.heap_profile(0)
+for file, func, line, count, nbytes in micropython.heap_profile():
+    if func == "make_lists":
+        print(line, 10 <= count <= 20)
+
+try:
+    micropython.heap_profile(-1)
+except ValueError:
+    print("ValueError")
@@ -9,7 +9,8 @@ except (ImportError, AttributeError):
     print("SKIP")
     raise SystemExit
 
-mpy_arch = sys.implementation._mpy >> 8
+mpy_arch = sys.implementation._mpy >> 8 & 0xFF
+mpy_flags = sys.implementation._mpy >> 16  # high bit of sub-version
 if mpy_arch >> 2 == 0:
     # This system does not support .mpy files containing native code
     print("SKIP")
@@ -51,11 +52,11 @@ class UserFS:
 
 
 # these are the test .mpy files
-valid_header = bytes([77, 6, mpy_arch, 31])
+valid_header = bytes([77, 6, mpy_arch, 31 | mpy_flags])
 # fmt: off
 user_files = {
     # bad architecture (mpy_arch needed for sub-version)
-    '/mod0.mpy': bytes([77, 6, 0xfc | mpy_arch, 31]),
+    '/mod0.mpy': bytes([77, 6, 0xfc | mpy_arch, 31 | mpy_flags]),
 
     # test loading of viper and asm
     '/mod1.mpy': valid_header + (
@@ -0,0 +1,51 @@
+# test that native code storing to a closed-over variable keeps the stored
+# object alive while an incremental garbage collection is marking
+
+import gc
+
+try:
+    gc.step
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def make_cell():
+    x = None
+
+    @micropython.native
+    def store(i):
+        nonlocal x
+        x = [i, str(i)] * 20
+
+    def load():
+        return x
+
+    return store, load
+
+
+# A long chain of live objects so that marking takes many steps, with the
+# cells at its head so they are scanned early in each cycle.
+chain = None
+for i in range(20000):
+    chain = (i, chain)
+data = (chain, [make_cell() for _ in range(20)])
+chain = None
+
+# Store new objects early in each collection cycle, into cells that the
+# collector has already scanned, then check they survive the cycle.
+ok = True
+for n in range(3):
+    cells = data[1]
+    i = 0
+    while not gc.step(0):
+        if i < 40:
+            cells[i % len(cells)][0](n * 100 + i)
+        i += 1
+    # reuse any memory the cycle freed
+    junk = [[j, j] for j in range(2000)]
+    for k, (store, load) in enumerate(cells):
+        v = load()
+        if v[0] != n * 100 + 20 + k or v[1] != str(n * 100 + 20 + k):
+            ok = False
+print(ok)
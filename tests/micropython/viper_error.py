@@ -88,3 +88,11 @@ test("@micropython.viper\ndef f(): print(ptr(1))")
 
 # cast of a casting identifier not implemented
 test("@micropython.viper\ndef f(): int(int)")
+
+# unknown pointer method, or pointer method with wrong arguments
+test("@micropython.viper\ndef f(x:ptr8): x.foo()")
+test("@micropython.viper\ndef f(x:ptr8): x.fill(1)")
+test("@micropython.viper\ndef f(x:ptr8): x.sum(n=1)")
+test("@micropython.viper\ndef f(x:ptr8, y:object): x.copy_from(y, 1)")
+test("@micropython.viper\ndef f(x:ptr8, y:ptr8): x.fill(y, 1)")
+test("@micropython.viper\ndef f(x:ptr8, y:ptr8): x.sum(y)")
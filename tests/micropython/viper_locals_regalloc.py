@@ -0,0 +1,127 @@
+# test viper functions with more locals than registers, and locals whose
+# live ranges allow them to share a register
+
+
+@micropython.viper
+def many(a: int, b: int, c: int, d: int) -> int:
+    s = 0
+    t = 1
+    u = 2
+    v = 3
+    w = 4
+    for i in range(10):
+        s += a * i
+        t += b
+        u ^= c + i
+        v += d - i
+        w += s & 7
+    return s + t + u + v + w
+
+print(many(1, 2, 3, 4))
+
+@micropython.viper
+def seq(n: int) -> int:
+    x = 0
+    i = 0
+    while i < n:
+        x += i
+        i += 1
+    y = x
+    j = 0
+    while j < n:
+        y += j * 2
+        j += 1
+    z = y
+    k = 0
+    while k < n:
+        z -= k
+        k += 1
+    return x + y + z
+
+print(seq(10))
+
+@micropython.viper
+def nested(n: int) -> int:
+    tot = 0
+    for i in range(n):
+        a = i * 3
+        for j in range(n):
+            tot += a + j
+        b = tot & 0xff
+        tot += b
+    return tot
+
+print(nested(7))
+
+@micropython.viper
+def bufsum(buf) -> int:
+    p = ptr8(buf)
+    n = int(len(buf))
+    s = 0
+    i = 0
+    while i < n:
+        s += p[i]
+        i += 1
+    return s
+
+print(bufsum(bytearray(range(100))))
+
+@micropython.viper
+def objs(l):
+    acc = []
+    for x in l:
+        y = x
+        acc.append(y)
+    z = 0
+    for q in range(3):
+        z += q
+    acc.append(z)
+    return acc
+
+print(objs([1, 2, 3]))
+
+@micropython.viper
+def swap(a: int, b: int) -> int:
+    for i in range(3):
+        a, b = b, a + b
+    return a * 100 + b
+
+print(swap(1, 2))
+
+@micropython.viper
+def args5(a: int, b: int, c: int, d: int):
+    return (a, b, c, d)
+
+print(args5(1, 2, 3, 4))
+
+@micropython.viper
+def callme(f, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += int(f(i))
+    return s
+
+print(callme(lambda x: x * x, 5))
+
+@micropython.viper
+def cond_def(n: int) -> int:
+    r = 0
+    for i in range(n):
+        if i & 1:
+            t = i * 2
+            r += t
+        else:
+            t2 = i + 100
+            r -= t2
+    return r
+
+print(cond_def(9))
+
+@micropython.viper
+def walrus(n: int) -> int:
+    s = 0
+    for i in range(n):
+        s = s + (t := i * 2) + t
+    return s
+
+print(walrus(5))
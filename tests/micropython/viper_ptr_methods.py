@@ -0,0 +1,110 @@
+# test viper pointer methods copy_from, fill, xor_from and sum
+
+
+@micropython.viper
+def copy(dest: ptr8, src: ptr8, n: int):
+    dest.copy_from(src, n)
+
+
+@micropython.viper
+def copy16(dest: ptr16, src: ptr16, n: int):
+    dest.copy_from(src, n)
+
+
+@micropython.viper
+def copy_offset(buf: ptr8, n: int):
+    # overlapping copy within the same buffer
+    dest = ptr8(uint(buf) + 1)
+    dest.copy_from(buf, n)
+
+
+@micropython.viper
+def fill8(dest: ptr8, val: int, n: int):
+    dest.fill(val, n)
+
+
+@micropython.viper
+def fill16(dest: ptr16, val: int, n: int):
+    dest.fill(val, n)
+
+
+@micropython.viper
+def fill32(dest: ptr32, val: int, n: int):
+    dest.fill(val, n)
+
+
+@micropython.viper
+def xor8(dest: ptr8, src: ptr8, n: int):
+    dest.xor_from(src, n)
+
+
+@micropython.viper
+def xor32(dest: ptr32, src: ptr32, n: int):
+    dest.xor_from(src, n)
+
+
+@micropython.viper
+def sum8(src: ptr8, n: int) -> int:
+    return src.sum(n)
+
+
+@micropython.viper
+def sum16(src: ptr16, n: int) -> int:
+    return src.sum(n)
+
+
+@micropython.viper
+def sum32(src: ptr32, n: int) -> int:
+    return src.sum(n)
+
+
+@micropython.viper
+def sum_rows(buf: ptr8, rows: int, cols: int) -> int:
+    total = 0
+    for i in range(rows):
+        row = ptr8(uint(buf) + i * cols)
+        total += row.sum(cols)
+    return total
+
+
+# copy
+b = bytearray(8)
+copy(b, b"abcdefgh", 5)
+print(b)
+b = bytearray(8)
+copy16(b, b"abcdefgh", 3)
+print(b)
+b = bytearray(b"abcdefgh")
+copy_offset(b, 6)
+print(b)
+
+# fill
+for n in (0, 1, 7, 8, 9, 33):
+    b = bytearray(n + 1)
+    fill8(b, 0x1A5, n)
+    print(n, b == bytearray([0xA5] * n + [0]))
+b = bytearray(10)
+fill16(b, 0x1234, 4)
+print(b)
+b = bytearray(12)
+fill32(b, 0x12345678, 2)
+print(b)
+
+# xor
+for n in (0, 1, 7, 8, 15, 16, 17, 100):
+    a = bytearray(i * 7 & 0xFF for i in range(n + 1))
+    x = bytearray(i * 13 + 5 & 0xFF for i in range(n + 1))
+    xor8(a, x, n)
+    print(n, a == bytearray([(i * 7 ^ (i * 13 + 5)) & 0xFF for i in range(n)] + [n * 7 & 0xFF]))
+a = bytearray(b"\xff" * 12)
+xor32(a, b"\x0f" * 12, 2)
+print(a)
+
+# sum, including lengths around the vector and word block sizes
+for n in (0, 1, 7, 8, 15, 16, 17, 100, 1023, 1024, 1025, 5000):
+    a = bytearray((i * 37 + 11) & 0xFF for i in range(n + 3))
+    print(n, sum8(a, n) == sum(a[:n]))
+print(sum8(bytearray(b"\xff" * 4000), 4000))
+print(sum16(b"\x01\x00\x02\x00\xff\xff", 3))
+print(sum32(b"\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00", 3))
+print(sum_rows(bytes(range(12)), 3, 4))
@@ -0,0 +1,36 @@
+# This tests allocation speed of multi-block objects when the start of the heap
+# is fragmented into holes that are too small for them.
+
+import gc
+
+
+def fragment(nobj):
+    objs = [None] * nobj
+    for i in range(nobj):
+        objs[i] = [None, None]
+    for i in range(0, nobj, 2):
+        objs[i] = None
+    gc.collect()
+    return objs
+
+
+def test(nalloc):
+    bufs = [None] * nalloc
+    for i in range(nalloc):
+        bufs[i] = bytearray(100)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (100, 50): (800, 20),
+    (1000, 1000): (8000, 200),
+    (5000, 1000): (16000, 500),
+}
+
+
+def bm_setup(params):
+    nobj, nalloc = params
+    objs = fragment(nobj)
+    return lambda: test(nalloc), lambda: (nalloc // 10, len(objs))
@@ -0,0 +1,42 @@
+# This tests qstr_find_strn() speed when many qstrs have been interned at runtime,
+# which exercises the lookup of qstrs in the dynamically allocated pools.
+
+
+class A:
+    pass
+
+
+def test(names, nloop):
+    a = A()
+    n = 0
+    for _ in range(nloop):
+        for name in names:
+            # Looking up the attribute interns the name on first use, then finds it.
+            if getattr(a, name, None) is None:
+                n += 1
+    return n
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (100, 4),
+    (1000, 10): (1000, 4),
+    (5000, 10): (10000, 4),
+}
+
+
+def bm_setup(params):
+    nnames, nloop = params
+    names = ["dyn_attr_name_%d" % i for i in range(nnames)]
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(names, nloop)
+
+    def result():
+        return nnames * nloop, state
+
+    return run, result
@@ -0,0 +1,67 @@
+# This tests big integer arithmetic on numbers with thousands of digits:
+# multiplication, division, modular exponentiation and conversion to and
+# from decimal strings.
+
+try:
+    1 << 1000
+except OverflowError:
+    print("SKIP")
+    raise SystemExit
+
+
+def make_int(ndig, seed):
+    x = seed
+    n = 0
+    for _ in range(ndig // 9):
+        x = (x * 1103515245 + 12345) & 0x7FFFFFFF
+        n = n * 1000000000 + x % 1000000000
+    return n
+
+
+def test(ndig, niter):
+    a = make_int(ndig, 1)
+    b = make_int(ndig // 2, 2)
+    m = make_int(600, 3) | 1
+    e = make_int(600, 4)
+    check = 0
+    for _ in range(niter):
+        # Multiplication of large and unbalanced operands, and squaring.
+        p = a * a
+        check ^= p % 1000000007
+        p = a * b
+        check ^= p % 1000000007
+        # Division of a large number by a smaller one.
+        q, r = divmod(p, b + 1)
+        check ^= q & 0xFFFF ^ r % 65521
+        # Modular exponentiation with a 2000-bit modulus.
+        check ^= pow(3, e, m) % 1000000007
+        # Conversion to and from a decimal string (CPython limits this to
+        # 4300 digits by default).
+        s = str(a % 10**4000)
+        check ^= len(s) ^ int(s) % 1000000007
+    return check
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 25): (2000, 1),
+    (100, 100): (4000, 1),
+    (1000, 1000): (8000, 2),
+    (5000, 1000): (20000, 2),
+}
+
+
+def bm_setup(params):
+    ndig, niter = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(ndig, niter)
+
+    def result():
+        return ndig * niter, state
+
+    return run, result
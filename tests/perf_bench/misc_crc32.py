@@ -0,0 +1,65 @@
+# This tests the throughput of binascii.crc32 on buffers of various sizes
+# and alignments, including chaining the CRC across pieces of a buffer.
+
+try:
+    import binascii
+
+    binascii.crc32
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def make_data(n):
+    x = 12345
+    data = bytearray(n)
+    for i in range(n):
+        x = (x * 1103515245 + 12345) & 0x7FFFFFFF
+        data[i] = x >> 16 & 0xFF
+    return bytes(data)
+
+
+def test(data, niter):
+    m = memoryview(data)
+    n = len(data)
+    crcs = []
+    for _ in range(niter):
+        crcs = [binascii.crc32(data)]
+        # Unaligned start and length.
+        crcs.append(binascii.crc32(m[3 : n - 5]))
+        # Chained over pieces of varying size.
+        crc = 0
+        i = 0
+        step = 1
+        while i < n:
+            crc = binascii.crc32(m[i : i + step], crc)
+            i += step
+            step = step * 2 + 1
+        crcs.append(crc)
+    return crcs
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 25): (10,),
+    (100, 100): (40,),
+    (1000, 1000): (400,),
+    (5000, 1000): (2000,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    data = make_data(16384)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(data, niter)
+
+    def result():
+        return len(data) * 3 * niter, state
+
+    return run, result
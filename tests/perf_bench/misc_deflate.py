@@ -0,0 +1,81 @@
+# This tests compression throughput and ratio of the deflate module, on a
+# corpus that looks like a log file, at several compression levels.
+
+import io
+
+try:
+    import deflate
+
+    deflate.DeflateIO(io.BytesIO(), deflate.RAW, 8, False, 1)
+except (ImportError, AttributeError, ValueError):
+    print("SKIP")
+    raise SystemExit
+
+
+def make_corpus(nlines):
+    levels = ("INFO", "INFO", "INFO", "WARN", "ERROR", "DEBUG")
+    events = ("connected", "reading sensor", "retry", "timeout waiting for reply", "sent")
+    lines = []
+    x = 12345
+    for i in range(nlines):
+        x = (x * 1103515245 + 12345) & 0x7FFFFFFF
+        lines.append(
+            "2024-03-%02d %02d:%02d:%02d.%03d %s [node%d] %s id=%d value=%d\n"
+            % (
+                i // 5000 + 1,
+                i // 600 % 24,
+                i // 10 % 60,
+                i % 60,
+                x % 1000,
+                levels[x % len(levels)],
+                x % 5,
+                events[x >> 8 & 3 if x >> 8 & 7 < 4 else 4],
+                i,
+                x >> 16,
+            )
+        )
+    return "".join(lines).encode()
+
+
+# Level and wbits of each compression to run, level 0 being the default.
+CONFIGS = ((0, 8), (1, 12), (6, 12), (9, 12))
+
+
+def test(corpus, niter):
+    sizes = []
+    for level, wbits in CONFIGS:
+        for _ in range(niter):
+            b = io.BytesIO()
+            with deflate.DeflateIO(b, deflate.RAW, wbits, False, level) as g:
+                # Write in chunks, as a log shipper would.
+                for i in range(0, len(corpus), 512):
+                    g.write(corpus[i : i + 512])
+        sizes.append(len(b.getvalue()))
+    return sizes
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 25): (1,),
+    (100, 100): (2,),
+    (1000, 1000): (10,),
+    (5000, 1000): (50,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    corpus = make_corpus(300)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(corpus, niter)
+
+    def result():
+        # Report the compressed size of each configuration as a percentage.
+        return len(corpus) * len(CONFIGS) * niter, [s * 100 // len(corpus) for s in state]
+
+    return run, result
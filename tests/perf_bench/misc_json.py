@@ -0,0 +1,52 @@
+# This tests parsing a large JSON document, from a string and from a stream
+
+import io
+import json
+
+
+def make_doc(nrows):
+    rows = []
+    for i in range(nrows):
+        rows.append(
+            '{"id": %d, "name": "sensor-%d", "ok": %s, "temp": %d.%d, "tags": ["a\\tb", "c\\u00e9", null], "note": "%s"}'
+            % (i, i % 97, "true" if i & 1 else "false", i % 40, i % 10, "x" * (i % 50))
+        )
+    return "[" + ",\n".join(rows) + "]"
+
+
+def test(doc, niter):
+    stream = io.BytesIO(doc)
+    for i in range(niter):
+        if i & 1:
+            stream.seek(0)
+            x = json.load(stream)
+        else:
+            x = json.loads(doc)
+    return len(x), x[-1]["id"], x[-1]["temp"], len(x[-1]["tags"][1])
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 25): (10, 2),
+    (100, 100): (50, 4),
+    (1000, 1000): (500, 40),
+    (5000, 1000): (500, 200),
+    (5000, 10000): (10000, 20),
+}
+
+
+def bm_setup(params):
+    nrows, niter = params
+    doc = make_doc(nrows).encode()
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(doc, niter)
+
+    def result():
+        return nrows * niter, state
+
+    return run, result
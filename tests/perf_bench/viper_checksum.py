@@ -0,0 +1,45 @@
+# Fletcher-32 style checksum over a buffer, to test viper loops over ptr16
+# that keep several int locals live at once
+
+
+@micropython.viper
+def checksum(buf, n: int) -> int:
+    p = ptr16(buf)
+    s1 = 0xFFFF
+    s2 = 0xFFFF
+    i = 0
+    while i < n:
+        blk = n - i
+        if blk > 359:
+            blk = 359
+        end = i + blk
+        while i < end:
+            s1 += p[i]
+            s2 += s1
+            i += 1
+        s1 = (s1 & 0xFFFF) + (s1 >> 16)
+        s2 = (s2 & 0xFFFF) + (s2 >> 16)
+    s1 = (s1 & 0xFFFF) + (s1 >> 16)
+    s2 = (s2 & 0xFFFF) + (s2 >> 16)
+    return (s2 << 16) | s1
+
+
+def test(buf, n, loops):
+    c = 0
+    for _ in range(loops):
+        c = checksum(buf, n)
+    return c
+
+
+bm_params = {
+    (50, 10): (20, 500),
+    (100, 10): (40, 500),
+    (1000, 10): (400, 1000),
+    (5000, 10): (2000, 2000),
+}
+
+
+def bm_setup(params):
+    loops, n = params
+    buf = bytearray((i * 7 + 3) & 0xFF for i in range(2 * n))
+    return lambda: test(buf, n, loops), lambda: (loops * n // 1000, None)
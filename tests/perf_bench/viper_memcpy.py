@@ -0,0 +1,46 @@
+# Byte-wise copy and reversal between buffers, to test viper loops that keep
+# pointers and indices in registers
+
+
+@micropython.viper
+def copy(dest, src, n: int):
+    d = ptr8(dest)
+    s = ptr8(src)
+    i = 0
+    while i < n:
+        d[i] = s[i]
+        i += 1
+
+
+@micropython.viper
+def reverse_copy(dest, src, n: int):
+    d = ptr8(dest)
+    s = ptr8(src)
+    i = 0
+    j = n - 1
+    while i < n:
+        d[i] = s[j]
+        i += 1
+        j -= 1
+
+
+def test(a, b, n, loops):
+    for _ in range(loops):
+        copy(b, a, n)
+        reverse_copy(a, b, n)
+    return a[0] + (a[n - 1] << 8)
+
+
+bm_params = {
+    (50, 10): (20, 500),
+    (100, 10): (40, 500),
+    (1000, 10): (400, 1000),
+    (5000, 10): (2000, 2000),
+}
+
+
+def bm_setup(params):
+    loops, n = params
+    a = bytearray(i & 0xFF for i in range(n))
+    b = bytearray(n)
+    return lambda: test(a, b, n, loops), lambda: (loops * n // 1000, None)
@@ -0,0 +1,33 @@
+# Test importing an .mpy file from the host filesystem.
+
+import sys, os
+
+# This is the test.py file that is compiled to the .mpy data below.
+"""
+def f(n):
+    s = 0
+    for i in range(n):
+        s = s + i * 2 - 1
+    return s
+name = "an identifier-like string loaded in place"
+result = f(10)
+"""
+file_data = b'M\x06\x00\x1f\x06\x01\x0etest.py\x00\x0f\x02f\x00\x08name\x00\x0cresult\x00\x02n\x00\x05)an identifier-like string loaded in place\x00\x81<\x08\x08\x01d@$2\x00\x16\x02#\x00\x16\x03\x11\x02\x8a4\x01\x16\x04Qc\x01\x82\x189\x0c\x02\x05 "&1\x80\xc1\xb0\x80BLW\xc2\xb1\xb2\x82\xf4\xf2\x81\xf3\xc1\x81\xe5XZ\xd7C/YY\xb1c'
+
+tmp = os.getenv("TMPDIR") or "/tmp"
+path = tmp + "/__import_mpy_file.mpy"
+with open(path, "wb") as f:
+    f.write(file_data)
+sys.path.insert(0, tmp)
+
+for _ in range(3):
+    sys.modules.pop("__import_mpy_file", None)
+    import __import_mpy_file as m
+
+    # call the function enough for the VM to specialise its binary ops
+    print(m.result, m.f(1000), m.f(1000), m.f(5))
+    print(m.name)
+
+# the qstr table of the module must still be usable after the file is gone
+os.remove(path)
+print(m.f(3), m.name.upper())
@@ -0,0 +1,73 @@
+# cmdline: -X gcthreads=4
+# test that the heap stays intact when the mark phase is shared between threads
+#
+# The coverage build enables MICROPY_GC_PARALLEL_MARK, so every gc.collect()
+# here is marked by 4 workers that steal from each other, while the Python
+# threads keep allocating and collecting concurrently.
+
+import gc
+import _thread
+
+
+def make_tree(depth):
+    if depth == 0:
+        return str(depth)
+    return [make_tree(depth - 1) for _ in range(4)] + [(depth, {depth: bytes(depth)})]
+
+
+def check_tree(node, depth):
+    if depth == 0:
+        return node == "0"
+    if len(node) != 5 or node[4][0] != depth or node[4][1][depth] != bytes(depth):
+        return False
+    return all(check_tree(node[i], depth - 1) for i in range(4))
+
+
+def thread_entry(n):
+    # a tree gives many roots to distribute, a wide list overflows the deques
+    # and a linked chain can only be traced sequentially
+    tree = make_tree(5)
+    wide = [[i] for i in range(3000)]
+    chain = None
+    for i in range(2000):
+        chain = (i, chain)
+
+    ok = True
+    for _ in range(n):
+        # create garbage so each collection has something to free
+        for i in range(50):
+            [str(i)] * 10
+        gc.collect()
+        ok = ok and check_tree(tree, 5)
+        ok = ok and all(wide[i] == [i] for i in range(len(wide)))
+        c, i = chain, 1999
+        while c is not None:
+            ok = ok and c[0] == i
+            c, i = c[1], i - 1
+
+    with lock:
+        global n_correct, n_finished
+        n_correct += ok
+        n_finished += 1
+
+
+lock = _thread.allocate_lock()
+n_thread = 0
+n_thread_max = 2
+n_correct = 0
+n_finished = 0
+
+for _ in range(n_thread_max):
+    try:
+        _thread.start_new_thread(thread_entry, (10,))
+        n_thread += 1
+    except OSError:
+        break
+
+thread_entry(10)
+n_thread += 1
+
+while n_finished < n_thread:
+    pass
+
+print(n_correct == n_finished)
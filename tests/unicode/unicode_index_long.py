@@ -0,0 +1,20 @@
+# test indexing, slicing and searching of long str objects, with and without
+# non-ASCII characters, which can be handled without scanning the whole string
+
+for s in ("abcdefghij" * 30, "abcdéfghij" * 30, "€" * 150 + "abc" * 50, "x" * 200 + "ü"):
+    n = len(s)
+    print(n, s[0], s[1], s[n // 2], s[-1], s[-2], s[-n], s[n - 1])
+    print(s[100:105], s[-105:-100], s[190:], s[:3], s[-3:], s[5:2], s[n - 1 : n + 10])
+    print(s[-n - 5 : 4], s[n + 5 :], len(s[33:244]))
+    for i in (n, -n - 1, 1000):
+        try:
+            s[i]
+        except IndexError:
+            print("IndexError", i)
+    print(s.find("f"), s.find("f", 100), s.rfind("f"), s.rfind("f", 0, 150), s.find("a", -20))
+    print(s.count("c", 50, 150), s.startswith("c", 152), s.startswith("x", -1))
+
+# strings made from slices and by concatenation
+s = "αβγ" * 100
+t = s[50:] + s[:50]
+print(t[0], t[99], t[-1], t.find("γ", 200), len(t))
@@ -88,7 +88,9 @@ class FreezeError(Exception):
 
 class Config:
     MPY_VERSION = 6
-    MPY_SUB_VERSION = 3
+    MPY_SUB_VERSION = 5
+    MPY_FEATURE_SUPERINSTRUCTIONS = 0x80
+    MPY_FEATURE_SMALL_INT_BITS_MASK = 0x3F
     MICROPY_LONGINT_IMPL_NONE = 0
     MICROPY_LONGINT_IMPL_LONGLONG = 1
     MICROPY_LONGINT_IMPL_MPZ = 2
@@ -113,6 +115,7 @@ MP_NATIVE_ARCH_ARMV7EMSP = 7
 MP_NATIVE_ARCH_ARMV7EMDP = 8
 MP_NATIVE_ARCH_XTENSA = 9
 MP_NATIVE_ARCH_XTENSAWIN = 10
+MP_NATIVE_ARCH_ARM64 = 11
 
 MP_PERSISTENT_OBJ_FUN_TABLE = 0
 MP_PERSISTENT_OBJ_NONE = 1
@@ -191,9 +194,9 @@ class Opcode:
     MP_BC_BASE_QSTR_O                 = (0x10) # LLLLLLSSSDDII---
     MP_BC_BASE_VINT_E                 = (0x20) # MMLLLLSSDDBBBBBB
     MP_BC_BASE_VINT_O                 = (0x30) # UUMMCCCC--------
-    MP_BC_BASE_JUMP_E                 = (0x40) # J-JJJJJEEEEF----
+    MP_BC_BASE_JUMP_E                 = (0x40) # JJJJJJJEEEEF----
     MP_BC_BASE_BYTE_O                 = (0x50) # LLLLSSDTTTTTEEFF
-    MP_BC_BASE_BYTE_E                 = (0x60) # --BREEEYYI------
+    MP_BC_BASE_BYTE_E                 = (0x60) # OOBREEEYYI------
     MP_BC_LOAD_CONST_SMALL_INT_MULTI  = (0x70) # LLLLLLLLLLLLLLLL
     #                                 = (0x80) # LLLLLLLLLLLLLLLL
     #                                 = (0x90) # LLLLLLLLLLLLLLLL
@@ -293,6 +296,10 @@ class Opcode:
     MP_BC_IMPORT_NAME                 = (MP_BC_BASE_QSTR_O + 0x0b) # qstr
     MP_BC_IMPORT_FROM                 = (MP_BC_BASE_QSTR_O + 0x0c) # qstr
     MP_BC_IMPORT_STAR                 = (MP_BC_BASE_BYTE_E + 0x09)
+
+    MP_BC_POP_JUMP_IF_COMPARE         = (MP_BC_BASE_JUMP_E + 0x01) # signed relative bytecode offset; then a byte
+    MP_BC_INPLACE_ADD_FAST            = (MP_BC_BASE_BYTE_E + 0x00) # extra byte
+    MP_BC_INPLACE_SUBTRACT_FAST       = (MP_BC_BASE_BYTE_E + 0x01) # extra byte
     # fmt: on
 
     # Create sets of related opcodes.
@@ -301,6 +308,7 @@ class Opcode:
         MP_BC_JUMP,
         MP_BC_POP_JUMP_IF_TRUE,
         MP_BC_POP_JUMP_IF_FALSE,
+        MP_BC_POP_JUMP_IF_COMPARE,
     )
 
     # Create a dict mapping opcode value to opcode name.
@@ -1081,18 +1089,22 @@ class RawCodeNative(RawCode):
             MP_NATIVE_ARCH_XTENSAWIN,
         ):
             self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",@progbits # ")))'
+        elif config.native_arch == MP_NATIVE_ARCH_ARM64:
+            self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",@progbits // ")))'
         else:
             self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",%progbits @ ")))'
 
         # Allow single-byte alignment by default for x86/x64.
         # ARM needs word alignment, ARM Thumb needs halfword, due to instruction size.
         # Xtensa needs word alignment due to the 32-bit constant table embedded in the code.
+        # ARM64 needs word alignment due to instruction size.
         if config.native_arch in (
             MP_NATIVE_ARCH_ARMV6,
             MP_NATIVE_ARCH_XTENSA,
             MP_NATIVE_ARCH_XTENSAWIN,
+            MP_NATIVE_ARCH_ARM64,
         ):
-            # ARMV6 or Xtensa -- four byte align.
+            # ARMV6, ARM64 or Xtensa -- four byte align.
             self.fun_data_attributes += " __attribute__ ((aligned (4)))"
         elif MP_NATIVE_ARCH_ARMV6M <= config.native_arch <= MP_NATIVE_ARCH_ARMV7EMDP:
             # ARMVxxM -- two byte align.
@@ -1355,14 +1367,16 @@ def read_mpy(filename):
         feature_byte = header[2]
         mpy_native_arch = feature_byte >> 2
         if mpy_native_arch != MP_NATIVE_ARCH_NONE:
-            mpy_sub_version = feature_byte & 3
+            mpy_sub_version = feature_byte & 3 | header[3] >> 4 & 4
             if mpy_sub_version != config.MPY_SUB_VERSION:
                 raise MPYReadError(filename, "incompatible .mpy sub-version")
             if config.native_arch == MP_NATIVE_ARCH_NONE:
                 config.native_arch = mpy_native_arch
             elif config.native_arch != mpy_native_arch:
                 raise MPYReadError(filename, "native architecture mismatch")
-        config.mp_small_int_bits = header[3]
+        config.mp_small_int_bits = header[3] & config.MPY_FEATURE_SMALL_INT_BITS_MASK
+        if header[3] & config.MPY_FEATURE_SUPERINSTRUCTIONS:
+            config.superinstructions = True
 
         # Read number of qstrs, and number of objects.
         n_qstr = reader.read_uint()
@@ -1441,6 +1455,12 @@ def freeze_mpy(firmware_qstr_idents, compiled_modules):
         print("#endif")
         print()
 
+    if config.superinstructions:
+        print("#if !MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS")
+        print('#error "frozen bytecode requires MICROPY_OPT_BYTECODE_SUPERINSTRUCTIONS"')
+        print("#endif")
+        print()
+
     print("#if MICROPY_PY_BUILTINS_FLOAT")
     print("typedef struct _mp_obj_float_t {")
     print("    mp_obj_base_t base;")
@@ -1702,8 +1722,12 @@ def merge_mpy(compiled_modules, output_file):
         header = bytearray(4)
         header[0] = ord("M")
         header[1] = config.MPY_VERSION
-        header[2] = config.native_arch << 2 | config.MPY_SUB_VERSION if config.native_arch else 0
+        header[2] = config.native_arch << 2 | config.MPY_SUB_VERSION & 3 if config.native_arch else 0
         header[3] = config.mp_small_int_bits
+        if config.native_arch:
+            header[3] |= (config.MPY_SUB_VERSION & 4) << 4
+        if config.superinstructions:
+            header[3] |= config.MPY_FEATURE_SUPERINSTRUCTIONS
         merged_mpy.extend(header)
 
         n_qstr = 0
@@ -1803,6 +1827,7 @@ def main():
     }[args.mlongint_impl]
     config.MPZ_DIG_SIZE = args.mmpz_dig_size
     config.native_arch = MP_NATIVE_ARCH_NONE
+    config.superinstructions = False
 
     # set config values for qstrs, and get the existing base set of qstrs
     # already in the firmware
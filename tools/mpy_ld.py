@@ -36,7 +36,7 @@ import makeqstrdata as qstrutil
 
 # MicroPython constants
 MPY_VERSION = 6
-MPY_SUB_VERSION = 3
+MPY_SUB_VERSION = 5
 MP_CODE_BYTECODE = 2
 MP_CODE_NATIVE_VIPER = 4
 MP_NATIVE_ARCH_X86 = 1
@@ -906,7 +906,12 @@ def build_mpy(env, entry_offset, fmpy, native_qstr_vals):
     # MPY: header
     out.write_bytes(
         bytearray(
-            [ord("M"), MPY_VERSION, env.arch.mpy_feature | MPY_SUB_VERSION, MP_SMALL_INT_BITS]
+            [
+                ord("M"),
+                MPY_VERSION,
+                env.arch.mpy_feature | MPY_SUB_VERSION & 3,
+                MP_SMALL_INT_BITS | (MPY_SUB_VERSION & 4) << 4,
+            ]
         )
     )
 